@@ -0,0 +1,162 @@
+/*
+ * sysex_fuzz.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dx7.h"
+#include "events.h"
+#include "scanner.h"
+
+#define SYSEX_FUZZ_INPUT_LIMIT (1U << 24)
+
+static FILE* null_file_p = NULL;
+
+static void sysex_fuzz_voice_handler(const SysexEvent_t* event_p, void* user_p)
+{
+    VoiceParameters_t* voice_p = user_p;
+    if(event_p->voice.format == BULK_DATA_PACKED_32_VOICE)
+    {
+        *voice_p = dx7_decode_packed_voice(event_p->voice.bytes_p);
+    }
+}
+
+/*
+ * the decode path of the command line, without files: scanner, classifier,
+ * checks, decoder, printer and events, with and without recovery.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data_p, size_t length)
+{
+    if(null_file_p == NULL)
+    {
+        null_file_p = fopen("/dev/null", "w");
+    }
+    VoiceParameters_t voice;
+    SysexDispatcher_t dispatcher = SYSEX_DISPATCHER_INITIALISER;
+    events_subscribe(&dispatcher, sysex_fuzz_voice_handler, &voice, SYSEX_EVENT_MASK(SYSEX_EVENT_VOICE));
+    for(int recover = 0; recover < 2; ++recover)
+    {
+        SysexScanner_t scanner;
+        scanner_open_buffer(&scanner, data_p, length, recover);
+        ScannedMessage_t message;
+        while(scanner_next(&scanner, &message))
+        {
+            dx7_classify_sysex(message.payload_p, message.length);
+            dx7_check_sysex(message.payload_p, message.length, NULL);
+            SysExData_t* sysex_p = dx7_get_sysex(message.payload_p, message.length);
+            dx7_print_sysex(null_file_p, message.payload_p, message.length, sysex_p);
+            events_dispatch(&dispatcher, message.payload_p, message.length);
+            dx7_free_sysex(sysex_p);
+        }
+        scanner_close(&scanner);
+    }
+    return 0;
+}
+
+#ifndef OLIDX_LIBFUZZER
+/*
+ * reads a whole input, NULL if empty. under AFL, stdin is rewound between
+ * two runs: it is read without stdio buffering.
+ */
+static uint8_t* sysex_fuzz_read(int file_descriptor, size_t* length_p)
+{
+    uint8_t* data_p = malloc(SYSEX_FUZZ_INPUT_LIMIT);
+    size_t length = 0;
+    ssize_t count;
+    while(length < SYSEX_FUZZ_INPUT_LIMIT
+       && (count = read(file_descriptor, data_p + length, SYSEX_FUZZ_INPUT_LIMIT - length)) > 0)
+    {
+        length += count;
+    }
+    if(length == 0)
+    {
+        free(data_p);
+        return NULL;
+    }
+    *length_p = length;
+    return data_p;
+}
+
+/*
+ * runs every file round_count times, prints the throughput.
+ */
+static int sysex_fuzz_files(char* const* paths_pp, int path_count, int round_count)
+{
+    size_t byte_count = 0;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(int path = 0; path < path_count; ++path)
+    {
+        int file_descriptor = open(paths_pp[path], O_RDONLY);
+        if(file_descriptor < 0)
+        {
+            fprintf(stderr, "can't open file: %s\n", paths_pp[path]);
+            return EXIT_FAILURE;
+        }
+        size_t length;
+        uint8_t* data_p = sysex_fuzz_read(file_descriptor, &length);
+        close(file_descriptor);
+        for(int round = 0; round < round_count && data_p != NULL; ++round)
+        {
+            LLVMFuzzerTestOneInput(data_p, length);
+            byte_count += length;
+        }
+        free(data_p);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("%.1f MB/s\n", (seconds > 0) ? byte_count / seconds / 1e6 : 0.0);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * afl-fuzz -i fuzz/corpus -o <findings> -- fuzz/sysex_fuzz-afl @@
+ * without file, the input is read from stdin, in persistent mode under AFL.
+ * sysex_fuzz -n <rounds> <files> measures the throughput in MB/s.
+ */
+int main(int argc, char* argv[])
+{
+    int round_count = 1;
+    int first = 1;
+    if(argc > 2 && strcmp(argv[1], "-n") == 0)
+    {
+        round_count = atoi(argv[2]);
+        first = 3;
+    }
+    int result = EXIT_SUCCESS;
+    if(first < argc)
+    {
+        result = sysex_fuzz_files(argv + first, argc - first, round_count);
+    }
+    else
+    {
+#ifdef __AFL_LOOP
+        while(__AFL_LOOP(1000))
+#endif
+        {
+            size_t length;
+            uint8_t* data_p = sysex_fuzz_read(STDIN_FILENO, &length);
+            if(data_p != NULL)
+            {
+                LLVMFuzzerTestOneInput(data_p, length);
+                free(data_p);
+            }
+        }
+    }
+    if(null_file_p != NULL)
+    {
+        fclose(null_file_p);
+    }
+    return result;
+}
+#endif
@@ -0,0 +1,57 @@
+/*
+ * audit.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_AUDIT_H_
+#define HEADERS_AUDIT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+//nombre de sites d'appel suivis, les suivants sont comptés ensemble.
+#define AUDIT_SITE_CAPACITY    4096U
+#define AUDIT_REPORT_SITE_COUNT  20U
+//code de sortie d'un programme qui finit avec de la mémoire allouée.
+#define AUDIT_LEAK_EXIT_STATUS   23
+
+/* structures */
+typedef struct AuditSite_t
+{
+    const void* caller_p;      //adresse de retour de l'appel d'allocation.
+    uint64_t live_bytes;
+    uint64_t live_count;
+    uint64_t allocation_count;
+} AuditSite_t;
+
+typedef struct AuditStatistics_t
+{
+    uint64_t live_bytes;
+    uint64_t live_count;
+    uint64_t peak_bytes;
+    uint64_t allocation_count;
+} AuditStatistics_t;
+
+/* functions */
+/**
+ * returns 1 in the audit build (make audit), where malloc, calloc,
+ * realloc, strdup and free are interposed at link time, 0 otherwise.
+ */
+int audit_is_enabled(void);
+
+/**
+ * returns the counts of the allocations made by olidx so far, all 0
+ * outside of the audit build.
+ */
+AuditStatistics_t audit_get_statistics(void);
+
+/**
+ * prints the totals, then the call sites still holding memory and those
+ * allocating the most, resolved for addr2line.
+ * the audit build prints it on exit.
+ */
+void audit_report(FILE* file_p);
+
+#endif /* HEADERS_AUDIT_H_ */
@@ -0,0 +1,64 @@
+/*
+ * backup.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_BACKUP_H_
+#define HEADERS_BACKUP_H_
+
+#include <pthread.h>
+
+#include "capture.h"
+#include "path.h"
+#include "pipeline.h"
+#include "transport.h"
+
+#define BACKUP_COMMAND "backup"
+
+typedef struct BackupOptions_t
+{
+    TransportKind_t kind;
+    TransportPacing_t pacing;
+    const char* ports[TRANSPORT_PORT_COUNT];   //<sortie>[:<entrée>]
+    size_t port_count;
+    uint8_t device;            //0 à 15.
+    const char* folder_p;
+} BackupOptions_t;
+
+/**
+ * one device: its thread sends the requests and pushes the replies to
+ * the queue, the main thread decodes them.
+ */
+typedef struct BackupUnit_t
+{
+    const BackupOptions_t* options_p;
+    char* output_p;
+    const char* input_p;
+    PipelineQueue_t* queue_p;
+    CaptureStatistics_t statistics;
+    uint32_t file_number;      //lu et écrit par le thread principal seulement.
+    int result;
+    int started;
+    pthread_t thread;
+} BackupUnit_t;
+
+/**
+ * a reply, or the end of a unit when payload_p is NULL.
+ */
+typedef struct BackupReply_t
+{
+    BackupUnit_t* unit_p;
+    uint8_t* payload_p;
+    size_t length;
+} BackupReply_t;
+
+/**
+ * olidx backup: requests every memory of every device at once and unpacks
+ * the replies into the folder and its name index.
+ * argv[0] is the command name.
+ */
+int run_backup(int argc, char* argv[]);
+
+#endif /* HEADERS_BACKUP_H_ */
@@ -0,0 +1,66 @@
+/*
+ * capture.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_CAPTURE_H_
+#define HEADERS_CAPTURE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "transport.h"
+
+//silence qui termine la réponse à une demande.
+#define CAPTURE_FIRST_REPLY_MS 2000
+#define CAPTURE_NEXT_REPLY_MS   300
+#define CAPTURE_REQUEST_COUNT    13U
+
+/* structures */
+typedef struct CaptureStatistics_t
+{
+    uint32_t request_count;
+    uint32_t answered_count;   //demandes suivies d'au moins une réponse.
+    uint32_t reply_count;
+    uint64_t byte_count;
+} CaptureStatistics_t;
+
+/**
+ * receives each reply: the payload is only valid during the call.
+ */
+typedef void (*CaptureHandler_t)(const uint8_t* payload_p, size_t length, void* user_p);
+
+/* tables */
+/**
+ * every memory of a DX7II-FD: voices, supplements, performances, set up,
+ * micro tunings and fractional scalings.
+ */
+extern const DumpRequest_t CAPTURE_REQUEST_TABLE[CAPTURE_REQUEST_COUNT];
+
+/* initialisers */
+extern const CaptureStatistics_t CAPTURE_STATISTICS_INITIALISER;
+
+/* functions */
+/**
+ * formats a dump request payload, between F0 and F7.
+ * @param device 0 to 15.
+ */
+uint8_t* capture_format_request(const DumpRequest_t* request_p, uint8_t device, size_t* length_p);
+
+/**
+ * sends each request in turn and hands every reply to handler, until the
+ * device stays silent.
+ * returns 0, or -1 if the transport failed.
+ */
+int capture_device(Transport_t* transport_p,
+                   uint8_t device,
+                   const DumpRequest_t* requests_p,
+                   size_t request_count,
+                   CaptureHandler_t handler,
+                   void* user_p,
+                   CaptureStatistics_t* statistics_p);
+
+#endif /* HEADERS_CAPTURE_H_ */
@@ -0,0 +1,112 @@
+/*
+ * codec.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_CODEC_H_
+#define HEADERS_CODEC_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "midi.h"
+
+#define CODEC_CAPACITY            16
+#define CODEC_MANUFACTURER_COUNT 128
+//les identifiants étendus 00 xx yy valent CODEC_EXTENDED_ID | xx << 8 | yy.
+#define CODEC_EXTENDED_ID    0x10000U
+#define CODEC_UNKNOWN_MODEL  UINT32_MAX
+#define CODEC_UNKNOWN_NAME   "unknown"
+
+/* structures */
+typedef struct SysexCodec_t SysexCodec_t;
+
+/**
+ * who sent a message and what it is, read from its header bytes.
+ */
+typedef struct SysexIdentity_t
+{
+    const SysexCodec_t* codec_p;   //NULL: message inconnu, passé tel quel.
+    uint32_t manufacturer;
+    uint32_t model;                //CODEC_UNKNOWN_MODEL si absent.
+    uint8_t device;
+    const char* model_name_p;      //NULL si inconnu.
+    const char* kind_name_p;       //NULL si inconnu.
+    SysexCheck_t check;            //somme de contrôle, si le format en a une.
+} SysexIdentity_t;
+
+/**
+ * a device family. identify fills the identity and returns 1 when the
+ * message belongs to the family, 0 to let the next codec try.
+ */
+struct SysexCodec_t
+{
+    const char* name_p;            //aussi suffixe des fichiers écrits.
+    uint32_t manufacturer;
+    int (*identify)(const uint8_t* payload_p, size_t length, SysexIdentity_t* identity_p);
+};
+
+/**
+ * codecs chained by manufacturer, tried in the order of registration.
+ */
+typedef struct CodecRegistry_t
+{
+    const SysexCodec_t* codecs[CODEC_CAPACITY];
+    size_t codec_count;
+    int8_t first[CODEC_MANUFACTURER_COUNT];    //-1: aucun codec.
+    int8_t next[CODEC_CAPACITY];
+} CodecRegistry_t;
+
+typedef struct CodecName_t
+{
+    uint32_t id;
+    const char* name_p;
+} CodecName_t;
+
+/* tables */
+extern const char* const MIDI_MANUFACTURER_NAME_TABLE[CODEC_MANUFACTURER_COUNT];
+
+/* constants */
+extern const SysexCodec_t DX7_CODEC;
+extern const SysexCodec_t ROLAND_CODEC;
+extern const SysexCodec_t KORG_CODEC;
+
+/* initialisers */
+extern const SysexIdentity_t SYSEX_IDENTITY_INITIALISER;
+
+/* functions */
+/**
+ * registers the built-in codecs, DX7 first.
+ */
+void codec_registry_init(CodecRegistry_t* registry_p);
+
+/**
+ * adds a codec after those of the same manufacturer.
+ * returns 0, or -1 if the registry is full.
+ */
+int codec_register(CodecRegistry_t* registry_p, const SysexCodec_t* codec_p);
+
+/**
+ * reads the manufacturer ID, extended IDs included.
+ * @param id_length_p receives the number of ID bytes, 0 if the message is too short.
+ */
+uint32_t codec_get_manufacturer(const uint8_t* payload_p, size_t length, size_t* id_length_p);
+
+/**
+ * returns the name of a manufacturer, NULL if unknown.
+ */
+const char* codec_get_manufacturer_name(uint32_t manufacturer);
+
+/**
+ * identifies a message without copying it: only the codecs of its
+ * manufacturer are tried. codec_p stays NULL if none claims it.
+ */
+SysexIdentity_t codec_identify(const CodecRegistry_t* registry_p, const uint8_t* payload_p, size_t length);
+
+void codec_print_identity(FILE* file_p, const SysexIdentity_t* identity_p);
+
+#endif /* HEADERS_CODEC_H_ */
@@ -0,0 +1,59 @@
+/*
+ * convert.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_CONVERT_H_
+#define HEADERS_CONVERT_H_
+
+#include <stdint.h>
+
+#include "converter.h"
+#include "path.h"
+
+#define CONVERT_COMMAND "convert"
+#define CONVERT_FILE_CAPACITY 256U
+
+typedef struct ConvertOptions_t
+{
+    ConvertFormat_t format;
+    uint8_t device;            //0 à 15.
+    int thread_count;
+    const char* folder_p;      //NULL: dossier courant.
+    int smf_gap_ms;            //< 0: fichiers .syx, sinon fichier MIDI standard de type 0.
+    ValidationMode_t validation;
+} ConvertOptions_t;
+
+/**
+ * an input file, and where its output goes.
+ */
+typedef struct ConvertFile_t
+{
+    char* input_p;
+    size_t relative_offset;    //début du chemin recopié sous le dossier de sortie.
+    char* output_p;
+    ConvertStatistics_t statistics;
+    int result;
+} ConvertFile_t;
+
+/**
+ * files shared by the threads, each taking the next one.
+ */
+typedef struct ConvertJob_t
+{
+    const ConvertOptions_t* options_p;
+    ConvertFile_t* files_p;
+    size_t file_count;
+    size_t file_capacity;
+    size_t next_file;
+} ConvertJob_t;
+
+/**
+ * olidx convert: converts the dumps of files and folders to one format.
+ * argv[0] is the command name.
+ */
+int run_converter(int argc, char* argv[]);
+
+#endif /* HEADERS_CONVERT_H_ */
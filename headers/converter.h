@@ -0,0 +1,127 @@
+/*
+ * converter.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_CONVERTER_H_
+#define HEADERS_CONVERTER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "smf.h"
+
+/* enumerations */
+typedef enum ConvertFormat_t
+{
+    CONVERT_FORMAT_VCED = 0,   //une voix
+    CONVERT_FORMAT_VMEM,       //32 voix compactées
+    CONVERT_FORMAT_ACED,       //un supplément
+    CONVERT_FORMAT_AMEM,       //32 suppléments compactés
+    CONVERT_FORMAT_PCED,       //une performance
+    CONVERT_FORMAT_PMEM,       //32 performances
+    CONVERT_FORMAT_COUNT
+} ConvertFormat_t;
+
+/**
+ * formats of the same kind convert into each other.
+ */
+typedef enum ConvertKind_t
+{
+    CONVERT_KIND_VOICE = 0,
+    CONVERT_KIND_SUPPLEMENT,
+    CONVERT_KIND_PERFORMANCE,
+    CONVERT_KIND_COUNT
+} ConvertKind_t;
+
+/* structures */
+/**
+ * a format: a message of record_count records.
+ */
+typedef struct ConvertFormatEntry_t
+{
+    const char* name_p;
+    ConvertKind_t kind;
+    BulkData_t bulk;
+    UniversalBulkData_t universal;     //UNIVERSAL_BULK_DATA_ERROR hors dump universel.
+    size_t record_size;
+    size_t record_count;
+    int packed;                //enregistrements au format compacté.
+} ConvertFormatEntry_t;
+
+typedef struct ConvertStatistics_t
+{
+    uint32_t message_count;
+    uint32_t skipped_count;    //illisibles ou d'une autre nature.
+    uint32_t record_count;
+    uint32_t padded_count;     //enregistrements initiaux complétant la dernière banque.
+    uint32_t written_count;
+    uint32_t invalid_count;    //voix écrites hors limites, réparées selon le mode.
+} ConvertStatistics_t;
+
+/**
+ * converts messages as they come into messages of one format. the output
+ * message is encoded in place in a buffer allocated once.
+ */
+typedef struct Converter_t
+{
+    const ConvertFormatEntry_t* output_p;
+    uint8_t device;
+    ValidationMode_t validation;
+    FILE* file_p;
+    SmfWriter_t* smf_p;        //NULL: messages écrits bruts dans file_p.
+    uint8_t* buffer_p;
+    size_t buffer_size;
+    uint8_t* records_p;        //dans buffer_p, après les en-têtes.
+    size_t record_count;
+    ConvertStatistics_t statistics;
+} Converter_t;
+
+/* tables */
+extern const ConvertFormatEntry_t CONVERT_FORMAT_TABLE[CONVERT_FORMAT_COUNT];
+
+/* initialisers */
+extern const ConvertStatistics_t CONVERT_STATISTICS_INITIALISER;
+
+/* functions */
+/**
+ * returns the format named name_p, CONVERT_FORMAT_COUNT if unknown.
+ */
+ConvertFormat_t converter_get_format(const char* name_p);
+
+/**
+ * returns the format of a bulk dump between F0 and F7,
+ * CONVERT_FORMAT_COUNT if it is damaged or of another format.
+ */
+ConvertFormat_t converter_get_message_format(const uint8_t* payload_p, size_t length);
+
+/**
+ * @param device 0 to 15, written in the output messages.
+ * @param validation checks the voices written, VALIDATION_OFF for none.
+ */
+void converter_init(Converter_t* converter_p, ConvertFormat_t output, uint8_t device, ValidationMode_t validation);
+void converter_free(Converter_t* converter_p);
+
+/**
+ * starts writing to a file, statistics cleared.
+ * @param smf_p embeds the messages in a Standard MIDI File opened on file_p, or NULL.
+ */
+void converter_start(Converter_t* converter_p, FILE* file_p, SmfWriter_t* smf_p);
+
+/**
+ * converts the records of a message between F0 and F7.
+ * returns 0, or -1 if the message was skipped.
+ */
+int converter_convert(Converter_t* converter_p, const uint8_t* payload_p, size_t length);
+
+/**
+ * writes the last bank, completed with initial records.
+ * returns 0, or -1 if the file couldn't be written.
+ */
+int converter_finish(Converter_t* converter_p);
+
+#endif /* HEADERS_CONVERTER_H_ */
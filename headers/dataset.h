@@ -0,0 +1,87 @@
+/*
+ * dataset.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_DATASET_H_
+#define HEADERS_DATASET_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "manifest.h"
+
+//une colonne par octet VCED, dans l'ordre des champs de VoiceParameters_t.
+#define DATASET_COLUMN_COUNT    BYTE_COUNT_VOICE_EDIT_BUFFER
+#define DATASET_EXTENSION       ".npy"
+#define DATASET_SCHEMA_EXTENSION ".schema.json"
+//en-tête .npy réservé, réécrit à la fermeture avec le nombre de lignes.
+#define DATASET_HEADER_SIZE     128U
+#define DATASET_BUFFER_SIZE     (1U << 20)
+//lignes converties puis écrites d'un bloc.
+#define DATASET_ROW_BLOCK       256U
+
+/* enumerations */
+typedef enum DatasetType_t
+{
+    DATASET_UINT8 = 0,         //valeurs brutes
+    DATASET_FLOAT32,           //ramenées sur [0, 1] par les limites du schéma
+    DATASET_TYPE_COUNT
+} DatasetType_t;
+
+/* structures */
+/**
+ * streams voices as rows of .npy files, split in shards of shard_rows rows.
+ */
+typedef struct DatasetWriter_t
+{
+    DatasetType_t type;
+    char* root_p;              //chemin sans extension ni numéro de tranche.
+    uint64_t shard_rows;       //0: un seul fichier.
+    FILE* file_p;              //tranche en cours, NULL avant la première ligne.
+    uint32_t shard_count;
+    uint64_t shard_row_count;
+    uint64_t row_count;
+    void* rows_p;              //bloc de DATASET_ROW_BLOCK lignes converties.
+    int error;
+    Manifest_t* manifest_p;    //fichiers fermés à y inscrire, NULL sinon.
+} DatasetWriter_t;
+
+/* tables */
+extern const char* const DATASET_TYPE_NAME_TABLE[DATASET_TYPE_COUNT];
+extern const char* const DATASET_DESCRIPTOR_TABLE[DATASET_TYPE_COUNT];
+
+/* functions */
+/**
+ * returns the type matching its name in DATASET_TYPE_NAME_TABLE,
+ * DATASET_TYPE_COUNT if unknown.
+ */
+DatasetType_t dataset_get_type(const char* name_p);
+
+/**
+ * shards are written as <root>_<shard>.npy, or <root>.npy without sharding.
+ */
+void dataset_open(DatasetWriter_t* writer_p, const char* root_p, DatasetType_t type, uint64_t shard_rows);
+
+/**
+ * appends one row per voice.
+ * returns 0, or -1 if a shard can't be written.
+ */
+int dataset_add(DatasetWriter_t* writer_p, const VoiceParameters_t* voices_p, size_t voice_count);
+
+/**
+ * completes the shard headers and writes the schema to <root>.schema.json.
+ * returns 0, or -1 if any write failed.
+ */
+int dataset_close(DatasetWriter_t* writer_p);
+
+/**
+ * writes the columns, their ranges and the shards as JSON.
+ */
+void dataset_print_schema(FILE* file_p, const DatasetWriter_t* writer_p);
+
+#endif /* HEADERS_DATASET_H_ */
@@ -19,13 +19,16 @@
 #define VOICE_COUNT                        32
 #define PERFORMANCE_COUNT                  32
 #define MICRO_TUNING_CARTRIDGE_COUNT       64
-#define FRACTIONAL_SCALING_CARTRIDGE_COUNT 64
+#define FRACTIONAL_SCALING_CARTRIDGE_COUNT 32
 #define UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE 4U
 #define UNIVERSAL_BULK_DATA_FORMAT_SIZE         6U
-
-
-#define CONVERT_STRUCT_PARAMETER(SOURCE_STRUCT, DESTINATION_STRUCT, PARAMETER)\
-    ((DESTINATION_STRUCT).PARAMETER = (SOURCE_STRUCT).PARAMETER)
+#define SYSEX_HEADER_SIZE     2U
+#define PARAMETER_HEADER_SIZE 2U
+#define BULK_HEADER_SIZE      1U
+#define BULK_DATA_LOOKUP_SIZE 256U
+//les étiquettes universelles, lues comme entiers, tiennent sans collision dans 16 cases.
+#define UNIVERSAL_BULK_DATA_HASH_BITS 4U
+#define UNIVERSAL_BULK_DATA_HASH_SIZE (1U << UNIVERSAL_BULK_DATA_HASH_BITS)
 
 /* enumerations */
 typedef enum Operator_t
@@ -43,7 +46,8 @@ typedef enum SysexType_t
 {
     SYSEX_TYPE_BULK      = 0,
     SYSEX_TYPE_PARAMETER = 1,
-    SYSEX_TYPE_COUNT     = 2
+    SYSEX_TYPE_DUMP_REQUEST = 2,
+    SYSEX_TYPE_COUNT     = 3
 } SysexType_t;
 
 typedef enum BulkData_t
@@ -122,144 +126,238 @@ typedef enum ParameterChange_t
 } ParameterChange_t;
 
 
+typedef enum SysexCheck_t
+{
+    SYSEX_CHECK_VALID = 0,
+    SYSEX_CHECK_NOT_BULK,  //rien à vérifier: paramètre ou autre fabricant
+    SYSEX_CHECK_TRUNCATED, //plus court que le compte d'octets
+    SYSEX_CHECK_TOO_LONG,  //octets en trop après le dernier bloc
+    SYSEX_CHECK_CHECKSUM,
+    SYSEX_CHECK_COUNT
+} SysexCheck_t;
+
+typedef enum ValidationMode_t
+{
+    VALIDATION_OFF = 0,
+    VALIDATION_CHECK,  //compte les paramètres hors limites
+    VALIDATION_CLAMP,  //les ramène dans leurs limites
+    VALIDATION_RESET,  //les remplace par ceux de la voix initiale
+    VALIDATION_MODE_COUNT
+} ValidationMode_t;
+
+/**
+ * a fractional scaling level every FRACTIONAL_SCALING_NOTE_STEP keys from
+ * FRACTIONAL_SCALING_FIRST_NOTE, levels in between are interpolated.
+ */
 typedef enum FractionalScalingRange_t
 {
-//TODO: notes.
-    FRACTIONAL_SCALING_COUNT = 40
+    FRACTIONAL_SCALING_FIRST_NOTE = 5,
+    FRACTIONAL_SCALING_NOTE_STEP  = 3,
+    FRACTIONAL_SCALING_COUNT      = 40
 } FractionalScalingRange_t;
 
+/* schema */
+/*
+ * Un paramètre de voix par ligne, dans l'ordre du format non compacté (VCED):
+ * X(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)
+ * PACKED_OFFSET, SHIFT et WIDTH situent le paramètre dans le format compacté (VMEM).
+ * Les offsets des opérateurs sont relatifs au début de l'opérateur.
+ */
+#define DX7_OPERATOR_SCHEMA(X)\
+    X(eg_rate_1,               0, 0, 7, 0, 99)\
+    X(eg_rate_2,               1, 0, 7, 0, 99)\
+    X(eg_rate_3,               2, 0, 7, 0, 99)\
+    X(eg_rate_4,               3, 0, 7, 0, 99)\
+    X(eg_level_1,              4, 0, 7, 0, 99)\
+    X(eg_level_2,              5, 0, 7, 0, 99)\
+    X(eg_level_3,              6, 0, 7, 0, 99)\
+    X(eg_level_4,              7, 0, 7, 0, 99)\
+    X(break_point,             8, 0, 7, 0, 99)\
+    X(left_depth,              9, 0, 7, 0, 99)\
+    X(right_depth,            10, 0, 7, 0, 99)\
+    X(left_curve,             11, 0, 2, 0,  3)\
+    X(right_curve,            11, 2, 2, 0,  3)\
+    X(rate_scaling,           12, 0, 3, 0,  7)\
+    X(modulation_sensitivity, 13, 0, 2, 0,  3)\
+    X(touch_sensitivity,      13, 2, 3, 0,  7)\
+    X(total_level,            14, 0, 7, 0, 99)\
+    X(frequency_mode,         15, 0, 1, 0,  1)\
+    X(frequency_coarse,       15, 1, 5, 0, 31)\
+    X(frequency_fine,         16, 0, 7, 0, 99)\
+    X(detune,                 12, 3, 4, 0, 14)
+
+#define DX7_VOICE_SCHEMA(X)\
+    X(peg_rate_1,                       102, 0, 7, 0, 99)\
+    X(peg_rate_2,                       103, 0, 7, 0, 99)\
+    X(peg_rate_3,                       104, 0, 7, 0, 99)\
+    X(peg_rate_4,                       105, 0, 7, 0, 99)\
+    X(peg_level_1,                      106, 0, 7, 0, 99)\
+    X(peg_level_2,                      107, 0, 7, 0, 99)\
+    X(peg_level_3,                      108, 0, 7, 0, 99)\
+    X(peg_level_4,                      109, 0, 7, 0, 99)\
+    X(algorithm,                        110, 0, 5, 0, 31)\
+    X(feedback_level,                   111, 0, 3, 0,  7)\
+    X(oscillator_phase_init,            111, 3, 1, 0,  1)\
+    X(lfo_speed,                        112, 0, 7, 0, 99)\
+    X(lfo_delay_time,                   113, 0, 7, 0, 99)\
+    X(pitch_modulation_depth,           114, 0, 7, 0, 99)\
+    X(amplitude_modulation_depth,       115, 0, 7, 0, 99)\
+    X(lfo_key_sync,                     116, 0, 1, 0,  1)\
+    X(lfo_wave,                         116, 1, 3, 0,  5)\
+    X(lfo_pitch_modulation_sensitivity, 116, 4, 3, 0,  7)\
+    X(transpose,                        117, 0, 7, 0, 48)
+
+/*
+ * Un paramètre de supplément (ACED du DX7II) par ligne, même convention:
+ * PACKED_OFFSET, SHIFT et WIDTH le situent dans le format compacté (AMEM).
+ */
+#define DX7_SUPPLEMENT_SCHEMA(X)\
+    X(operator_6_scaling_mode,            0, 0, 1, 0,   1)\
+    X(operator_5_scaling_mode,            0, 1, 1, 0,   1)\
+    X(operator_4_scaling_mode,            0, 2, 1, 0,   1)\
+    X(operator_3_scaling_mode,            0, 3, 1, 0,   1)\
+    X(operator_2_scaling_mode,            0, 4, 1, 0,   1)\
+    X(operator_1_scaling_mode,            0, 5, 1, 0,   1)\
+    X(operator_6_am_sensitivity,          1, 0, 3, 0,   7)\
+    X(operator_5_am_sensitivity,          1, 3, 3, 0,   7)\
+    X(operator_4_am_sensitivity,          2, 0, 3, 0,   7)\
+    X(operator_3_am_sensitivity,          2, 3, 3, 0,   7)\
+    X(operator_2_am_sensitivity,          3, 0, 3, 0,   7)\
+    X(operator_1_am_sensitivity,          3, 3, 3, 0,   7)\
+    X(pitch_eg_range,                     4, 0, 2, 0,   3)\
+    X(lfo_key_trigger,                    4, 2, 1, 0,   1)\
+    X(pitch_eg_velocity_switch,           4, 3, 1, 0,   1)\
+    X(polyphony_mode,                     4, 4, 2, 0,   3)\
+    X(pitch_bend_range,                   5, 0, 4, 0,  12)\
+    X(pitch_bend_step,                    6, 0, 4, 0,  12)\
+    X(pitch_bend_mode,                    7, 0, 2, 0,   2)\
+    X(random_pitch_fluctuation,           7, 2, 3, 0,   7)\
+    X(portamento_mode,                    8, 0, 1, 0,   1)\
+    X(portamento_step,                    8, 1, 4, 0,  12)\
+    X(portamento_time,                    9, 0, 7, 0,  99)\
+    X(modulation_wheel_pitch_range,      10, 0, 7, 0,  99)\
+    X(modulation_wheel_amplitude_range,  11, 0, 7, 0,  99)\
+    X(modulation_wheel_eg_bias_range,    12, 0, 7, 0,  99)\
+    X(foot_controller_1_pitch_range,     13, 0, 7, 0,  99)\
+    X(foot_controller_1_amplitude_range, 14, 0, 7, 0,  99)\
+    X(foot_controller_1_eg_bias_range,   15, 0, 7, 0,  99)\
+    X(foot_controller_1_volume_range,    16, 0, 7, 0,  99)\
+    X(breath_controller_pitch_range,     17, 0, 7, 0,  99)\
+    X(breath_controller_amplitude_range, 18, 0, 7, 0,  99)\
+    X(breath_controller_eg_bias_range,   19, 0, 7, 0,  99)\
+    X(breath_controller_pitch_bias,      20, 0, 7, 0, 100)\
+    X(aftertouch_pitch_range,            21, 0, 7, 0,  99)\
+    X(aftertouch_amplitude_range,        22, 0, 7, 0,  99)\
+    X(aftertouch_eg_bias_range,          23, 0, 7, 0,  99)\
+    X(aftertouch_pitch_bias,             24, 0, 7, 0, 100)\
+    X(pitch_eg_rate_scaling,             25, 0, 3, 0,   7)\
+    X(foot_controller_2_pitch_range,     26, 0, 7, 0,  99)\
+    X(foot_controller_2_amplitude_range, 27, 0, 7, 0,  99)\
+    X(foot_controller_2_eg_bias_range,   28, 0, 7, 0,  99)\
+    X(foot_controller_2_volume_range,    29, 0, 7, 0,  99)\
+    X(midi_controller_pitch_range,       30, 0, 7, 0,  99)\
+    X(midi_controller_amplitude_range,   31, 0, 7, 0,  99)\
+    X(midi_controller_eg_bias_range,     32, 0, 7, 0,  99)\
+    X(midi_controller_volume_range,      33, 0, 7, 0,  99)\
+    X(unison_detune,                     34, 0, 3, 0,   7)\
+    X(foot_controller_1_as_cs1,          34, 3, 1, 0,   1)
+
+#define SCHEMA_FIELD_MASK(WIDTH) ((1U << (WIDTH)) - 1U)
+
+#define SCHEMA_DECLARE_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    uint8_t FIELD;
+
+#define SCHEMA_ENUMERATE_OPERATOR_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    OPERATOR_FIELD_##FIELD,
+
+#define SCHEMA_ENUMERATE_VOICE_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    VOICE_FIELD_##FIELD,
+
+#define SCHEMA_ENUMERATE_SUPPLEMENT_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    SUPPLEMENT_FIELD_##FIELD,
+
+typedef enum OperatorField_t
+{
+    DX7_OPERATOR_SCHEMA(SCHEMA_ENUMERATE_OPERATOR_FIELD)
+    OPERATOR_FIELD_COUNT
+} OperatorField_t;
+
+typedef enum VoiceField_t
+{
+    DX7_VOICE_SCHEMA(SCHEMA_ENUMERATE_VOICE_FIELD)
+    VOICE_FIELD_COUNT
+} VoiceField_t;
+
+typedef enum SupplementField_t
+{
+    DX7_SUPPLEMENT_SCHEMA(SCHEMA_ENUMERATE_SUPPLEMENT_FIELD)
+    SUPPLEMENT_FIELD_COUNT
+} SupplementField_t;
+
+#define PACKED_OPERATOR_SIZE      17
+#define PACKED_VOICE_SIZE        128
+#define PACKED_VOICE_NAME_OFFSET 118
+#define PACKED_SUPPLEMENT_SIZE    35
+//données d'une performance, sans l'en-tête "LM  8973PE".
+#define PERFORMANCE_SIZE          51
+
 /* structures */
 typedef struct OperatorParameters_t
 {
-    uint8_t eg_rate_1;              //0 - 99
-    uint8_t eg_rate_2;
-    uint8_t eg_rate_3;
-    uint8_t eg_rate_4;
-    uint8_t eg_level_1;
-    uint8_t eg_level_2;
-    uint8_t eg_level_3;
-    uint8_t eg_level_4;
-    uint8_t break_point;
-    uint8_t left_depth;
-    uint8_t right_depth;
-    uint8_t left_curve;             //0 - 3
-    uint8_t right_curve;
-    uint8_t rate_scaling;           //0 - 7
-    uint8_t modulation_sensitivity; //0 - 3
-    uint8_t touch_sensitivity;      //0 - 3
-    uint8_t total_level;            //0 - 99
-    uint8_t frequency_mode;         //0 - 1
-    uint8_t frequency_coarse;       //0 - 31
-    uint8_t frequency_fine;         //0 - 99
-    uint8_t detune;                 //0 - 14
+    DX7_OPERATOR_SCHEMA(SCHEMA_DECLARE_FIELD)
 } OperatorParameters_t;
 
 typedef struct VoiceParameters_t
 {
     OperatorParameters_t Operator[OPERATOR_COUNT];
-    uint8_t peg_rate_1;                       //0 - 99
-    uint8_t peg_rate_2;
-    uint8_t peg_rate_3;
-    uint8_t peg_rate_4;
-    uint8_t peg_level_1;                      //0 - 99
-    uint8_t peg_level_2;
-    uint8_t peg_level_3;
-    uint8_t peg_level_4;
-    uint8_t algorithm;                        //0 - 31
-    uint8_t feedback_level;                   //0 - 7
-    uint8_t oscillator_phase_init;            //0 - 1
-    uint8_t lfo_speed;                        //0 - 99
-    uint8_t lfo_delay_time;                   //0 - 99
-    uint8_t pitch_modulation_depth;           //0 - 99
-    uint8_t amplitude_modulation_depth;       //0 - 99
-    uint8_t lfo_key_sync;                     //0 - 1
-    uint8_t lfo_wave;                         //0 - 5
-    uint8_t lfo_pitch_modulation_sensitivity; //0 - 7
-    uint8_t transpose;                        //0 - 48
+    DX7_VOICE_SCHEMA(SCHEMA_DECLARE_FIELD)
     char    voice_name[VOICE_NAME_SIZE];      //ASCII
 } VoiceParameters_t;
 
-typedef struct PackedOperatorParameters_t
-{
-    uint8_t eg_rate_1;              //0 - 99
-    uint8_t eg_rate_2;
-    uint8_t eg_rate_3;
-    uint8_t eg_rate_4;
-    uint8_t eg_level_1;
-    uint8_t eg_level_2;
-    uint8_t eg_level_3;
-    uint8_t eg_level_4;
-    uint8_t break_point;
-    uint8_t left_depth;
-    uint8_t right_depth;
-    uint8_t left_curve             : 2; //0 - 3
-    uint8_t right_curve            : 2;
-    uint8_t                        : 4;
-
-    uint8_t rate_scaling           : 3; //0 - 7
-    uint8_t detune                 : 4; //0 - 14
-    uint8_t                        : 1;
-
-    uint8_t modulation_sensitivity : 2; //0 - 3
-    uint8_t touch_sensitivity      : 3; //0 - 3
-    uint8_t                        : 3;
-    uint8_t total_level;                //0 - 99
-    uint8_t frequency_mode         : 1; //0 - 1
-    uint8_t frequency_coarse       : 5; //0 - 31
-    uint8_t                        : 1;
-
-    uint8_t frequency_fine;             //0 - 99
-} PackedOperatorParameters_t;
-
+/**
+ * Format VMEM: les paramètres sont placés par le schéma, pas par le compilateur.
+ */
 typedef struct PackedVoiceParameters_t
 {
-    PackedOperatorParameters_t Operator[OPERATOR_COUNT];
-    uint8_t peg_rate_1;                           //0 - 99
-    uint8_t peg_rate_2;
-    uint8_t peg_rate_3;
-    uint8_t peg_rate_4;
-    uint8_t peg_level_1;                          //0 - 99
-    uint8_t peg_level_2;
-    uint8_t peg_level_3;
-    uint8_t peg_level_4;
-
-    uint8_t algorithm                        : 5; //0 - 31
-    uint8_t                                  : 3;
-
-    uint8_t feedback_level                   : 3; //0 - 7
-    uint8_t oscillator_phase_init            : 1; //0 - 1
-    uint8_t                                  : 4;
-
-    uint8_t lfo_speed;                            //0 - 99
-
-    uint8_t lfo_delay_time;                       //0 - 99
-
-    uint8_t pitch_modulation_depth;               //0 - 99
-
-    uint8_t amplitude_modulation_depth;           //0 - 99
-
-    uint8_t lfo_key_sync                     : 1; //0 - 1
-    uint8_t lfo_wave                         : 3; //0 - 5
-    uint8_t lfo_pitch_modulation_sensitivity : 3; //0 - 7
-    uint8_t                                  : 1;
-
-    uint8_t transpose;                            //0 - 48
-    char    voice_name[VOICE_NAME_SIZE];          //ASCII
+    uint8_t data[PACKED_VOICE_SIZE];
 } PackedVoiceParameters_t;
 
-//TODO: DEFINE.
+/**
+ * description d'un paramètre du schéma.
+ * offset: position dans le format non compacté, relative à l'opérateur pour
+ *         les paramètres d'opérateur. C'est aussi le numéro de paramètre VCED.
+ */
+typedef struct SchemaField_t
+{
+    const char* name;
+    uint8_t offset;
+    uint8_t packed_offset;
+    uint8_t shift;
+    uint8_t width;
+    uint8_t minimum;
+    uint8_t maximum;
+} SchemaField_t;
+
 typedef struct SupplementVoiceParameters_t
 {
+    DX7_SUPPLEMENT_SCHEMA(SCHEMA_DECLARE_FIELD)
 } SupplementVoiceParameters_t;
 
-//TODO: DEFINE.
+/**
+ * Format AMEM, placé par le schéma comme VMEM.
+ */
 typedef struct PackedSupplementVoiceParameters_t
 {
+    uint8_t data[PACKED_SUPPLEMENT_SIZE];
 } PackedSupplementVoiceParameters_t;
 
-//TODO: DEFINE.
+/**
+ * une performance a le même format seule et en banque.
+ * TODO: détailler les paramètres.
+ */
 typedef struct PerformanceParameters_t
 {
+    uint8_t data[PERFORMANCE_SIZE];
 } PerformanceParameters_t;
 
 //TODO: DEFINE.
@@ -278,19 +376,25 @@ typedef struct FractionalScalingOperatorParameters_t
     FractionalScalingParameter_t level[FRACTIONAL_SCALING_COUNT];
 } FractionalScalingOperatorParameters_t;
 
+/**
+ * en-têtes décodés. Le format octet est géré par dx7_decode_* et dx7_encode_*:
+ * [id] [0sssnnnn]
+ */
 typedef struct SysexHeader_t
 {
     uint8_t id;
-    uint8_t device    : 4;
-    uint8_t substatus : 4;
+    uint8_t device;    //0 - 15
+    uint8_t substatus; //0 - 7
 } SysexHeader_t;
 
+/**
+ * [0ggggghh] [0ppppppp]
+ */
 typedef struct ParameterChangeHeader_t
 {
-    uint8_t group_h   : 2;
-    uint8_t group_g   : 5;
-    uint8_t           : 1;
-    uint8_t parameter;
+    uint8_t group_h;   //0 - 3
+    uint8_t group_g;   //0 - 31
+    uint8_t parameter; //0 - 127
 } ParameterChangeHeader_t;
 
 typedef struct BulkDataHeader_t
@@ -308,6 +412,29 @@ typedef struct UniversalBulkDataHeader_t
     UniversalBulkDataFormatName_t         format;
 } UniversalBulkDataHeader_t;
 
+/**
+ * what a message is, read from its headers alone.
+ */
+typedef struct SysexClass_t
+{
+    SysexType_t type;              //SYSEX_TYPE_COUNT: autre fabricant ou sous-statut inconnu.
+    uint8_t device;
+    BulkData_t format;             //dumps et demandes, BULK_DATA_MALFORMED sinon.
+    UniversalBulkData_t universal; //si format vaut BULK_DATA_UNIVERSAL_BULK_DUMP.
+    size_t expected_length;        //entre F0 et F7 exclus, 0 si inconnue.
+} SysexClass_t;
+
+/**
+ * violations found by dx7_validate_voices, indexed by VCED parameter number.
+ */
+typedef struct ValidationReport_t
+{
+    uint32_t voice_count;
+    uint32_t invalid_voice_count;
+    uint32_t violation_count;
+    uint32_t field_violation_count[BYTE_COUNT_VOICE_EDIT_BUFFER];
+} ValidationReport_t;
+
 /* unions */
 
 /* tables */
@@ -356,6 +483,7 @@ typedef struct BulkDataPayload_t
 typedef struct ParameterPayload_t
 {
     ParameterChange_t parameter;
+    uint16_t number; //(h << 7) | paramètre, dans le groupe g.
     union
     {
         uint8_t data;
@@ -364,6 +492,15 @@ typedef struct ParameterPayload_t
     };
 } ParameterPayload_t;
 
+/**
+ * F0 43 2n ff F7, or F0 43 2n 7E "LM  xxxxxx" F7 for universal dumps.
+ */
+typedef struct DumpRequest_t
+{
+    BulkData_t format;             //BULK_DATA_MALFORMED si la demande est illisible.
+    UniversalBulkData_t universal; //si format vaut BULK_DATA_UNIVERSAL_BULK_DUMP.
+} DumpRequest_t;
+
 typedef struct SysExData_t
 {
     SysexType_t type;
@@ -371,6 +508,7 @@ typedef struct SysExData_t
     {
         BulkDataPayload_t  bulk_data;
         ParameterPayload_t parameter_change;
+        DumpRequest_t      dump_request;
     };
 } SysExData_t;
 
@@ -381,6 +519,8 @@ extern const char* const BULK_DATA_FORMAT_NAME_TABLE[BULK_DATA_FORMAT_COUNT];
 extern const char* const UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME;
 extern const char* const UNIVERSAL_BULK_DATA_FORMAT_TABLE[UNIVERSAL_BULK_DATA_COUNT];
 extern const char* const UNIVERSAL_BULK_DATA_NAME_TABLE[UNIVERSAL_BULK_DATA_COUNT];
+extern const char* const VALIDATION_MODE_NAME_TABLE[VALIDATION_MODE_COUNT];
+extern const char* const SYSEX_CHECK_NAME_TABLE[SYSEX_CHECK_COUNT];
 
 /* constants */
 extern const ParameterChangeHeader_t PARAMETER_CHANGE_GROUP_TABLE[PARAMETER_CHANGE_COUNT];
@@ -388,6 +528,16 @@ extern const uint8_t BULK_DATA_FORMAT_TABLE[BULK_DATA_FORMAT_COUNT];
 extern const size_t BULK_DATA_BYTE_COUNT_TABLE[BULK_DATA_FORMAT_COUNT];
 extern const size_t UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[UNIVERSAL_BULK_DATA_COUNT];
 extern const size_t UNIVERSAL_BULK_DATA_REPEAT_TABLE[UNIVERSAL_BULK_DATA_COUNT];
+//octet de format vers BulkData_t, BULK_DATA_MALFORMED si inconnu.
+extern const uint8_t BULK_DATA_LOOKUP_TABLE[BULK_DATA_LOOKUP_SIZE];
+//case de hachage d'une étiquette universelle vers UniversalBulkData_t.
+extern const int8_t UNIVERSAL_BULK_DATA_HASH_TABLE[UNIVERSAL_BULK_DATA_HASH_SIZE];
+extern const SchemaField_t OPERATOR_SCHEMA_TABLE[OPERATOR_FIELD_COUNT];
+extern const SchemaField_t VOICE_SCHEMA_TABLE[VOICE_FIELD_COUNT];
+extern const SchemaField_t SUPPLEMENT_SCHEMA_TABLE[SUPPLEMENT_FIELD_COUNT];
+//limites de chaque octet VCED, nom compris.
+extern const uint8_t VOICE_MINIMUM_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER];
+extern const uint8_t VOICE_MAXIMUM_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER];
 
 /* initialisers */
 extern const SysexHeader_t SYSEX_HEADER_INITIALISER;
@@ -395,7 +545,11 @@ extern const SysexHeader_t SYSEX_HEADER_INITIALISER_YAMAHA;
 extern const ParameterChangeHeader_t PARAMETER_HEADER_INITIALISER;
 extern const BulkDataHeader_t BULK_HEADER_INITIALISER;
 extern const UniversalBulkDataHeader_t UNIVERSAL_BULK_HEADER_INITIALISER;
+extern const VoiceParameters_t VOICE_PARAMETERS_INITIALISER;
+extern const SupplementVoiceParameters_t SUPPLEMENT_PARAMETERS_INITIALISER;
+extern const ValidationReport_t VALIDATION_REPORT_INITIALISER;
 extern const SysExData_t SYSEX_DATA_INITIALISER;
+extern const SysexClass_t SYSEX_CLASS_INITIALISER;
 
 /* functions */
 /**
@@ -405,11 +559,67 @@ uint8_t* dx7_format_sysex(const SysExData_t* sysex_data_p, size_t* length_p, uin
 
 /**
  * returns a pointer to an interpreted dx7 SysEx structure.
+ * never reads past length: short or inconsistent messages decode as
+ * BULK_DATA_MALFORMED.
  * @oaram payload_p the bytes of data from the MIDI sysex file.
  */
 SysExData_t* dx7_get_sysex(const uint8_t* payload_p, size_t length);
-ParameterPayload_t dx7_get_sysex_parameter(const uint8_t* payload_p);
-BulkDataPayload_t dx7_get_sysex_bulk_data(const uint8_t* bulk_payload_p);
+
+/**
+ * classifies a message in constant time from its header bytes: format byte
+ * through BULK_DATA_LOOKUP_TABLE, universal tag as packed integers through
+ * UNIVERSAL_BULK_DATA_HASH_TABLE. nothing is decoded or allocated.
+ */
+SysexClass_t dx7_classify_sysex(const uint8_t* payload_p, size_t length);
+
+/**
+ * releases a structure returned by dx7_get_sysex and its payload.
+ */
+void dx7_free_sysex(SysExData_t* data_p);
+
+/**
+ * prints the header, type and contents of a decoded SysEx message.
+ */
+void dx7_print_sysex(FILE* file_p,
+                     const uint8_t* payload_p,
+                     size_t length,
+                     const SysExData_t* data_p);
+ParameterPayload_t dx7_get_sysex_parameter(const uint8_t* payload_p, size_t length);
+
+/**
+ * decodes a dump request after its SysEx header.
+ */
+DumpRequest_t dx7_get_dump_request(const uint8_t* request_p, size_t length);
+
+/**
+ * checks the declared byte counts and checksums of a Yamaha bulk dump
+ * against the actual payload, without decoding it.
+ * @param valid_length_p receives the length of the payload up to the first error.
+ */
+SysexCheck_t dx7_check_sysex(const uint8_t* payload_p,
+                             size_t length,
+                             size_t* valid_length_p);
+
+/**
+ * rebuilds a Packed32 voice payload from a damaged one.
+ * complete voices that pass validation are kept, the others are replaced
+ * by the initial voice.
+ * returns the new payload, NULL if the payload is not a Packed32 voice dump.
+ * @param voice_count_p receives the number of voices salvaged.
+ */
+uint8_t* dx7_salvage_packed32_voice(const uint8_t* payload_p,
+                                    size_t length,
+                                    size_t* salvaged_length_p,
+                                    int* voice_count_p);
+BulkDataPayload_t dx7_get_sysex_bulk_data(const uint8_t* bulk_payload_p, size_t length);
+
+/**
+ * classifies the blocks of a universal bulk dump and gathers their data,
+ * without headers, one repetition after the other.
+ * @param head_p byte count of the first block.
+ * returns UNIVERSAL_BULK_DATA_ERROR if a block is missing or unknown.
+ */
+UniversalBulkDataPayload_t dx7_get_universal_bulk_data(const uint8_t* head_p, const uint8_t* end_p);
 /**
  * returns pointer to a formatted  dx7 sysex byte bulk payload.
  * @param bulk_data_p pointer to a bulk data structure.
@@ -440,12 +650,115 @@ uint8_t* dx7_wrap_bulk_payload(const void* data_p,
 uint8_t* dx7_format_parameter_payload(const ParameterPayload_t* parameter_p,
                                       size_t* length_p);
 ParameterChangeHeader_t dx7_get_parameter_header(const ParameterPayload_t* parameter_p);
+
+/**
+ * header codecs, read and written straight from the byte buffer.
+ * the encoders return the number of bytes written.
+ */
+SysexHeader_t dx7_decode_sysex_header(const uint8_t* bytes_p);
+size_t dx7_encode_sysex_header(const SysexHeader_t* header_p, uint8_t* bytes_p);
+ParameterChangeHeader_t dx7_decode_parameter_header(const uint8_t* bytes_p);
+size_t dx7_encode_parameter_header(const ParameterChangeHeader_t* header_p, uint8_t* bytes_p);
+
 SysexType_t dx7_get_header(const SysexHeader_t* header_p);
 BulkData_t dx7_get_bulk_data_header(const BulkDataHeader_t* header_p);
 
+/**
+ * returns the universal format named in a block header,
+ * UNIVERSAL_BULK_DATA_ERROR if unknown.
+ */
+UniversalBulkData_t dx7_get_universal_bulk_data_header(const UniversalBulkDataHeader_t* header_p);
+
 PackedVoiceParameters_t dx7_pack_voice_parameters(VoiceParameters_t parameters);
 VoiceParameters_t dx7_unpack_voice_parameters(PackedVoiceParameters_t parameters);
 
+/**
+ * unpacks a VMEM voice record straight from the byte buffer.
+ * @param bytes_p PACKED_VOICE_SIZE bytes.
+ */
+VoiceParameters_t dx7_decode_packed_voice(const uint8_t* bytes_p);
+
+PackedSupplementVoiceParameters_t dx7_pack_supplement_parameters(SupplementVoiceParameters_t parameters);
+
+/**
+ * unpacks an AMEM supplement record straight from the byte buffer.
+ * @param bytes_p PACKED_SUPPLEMENT_SIZE bytes.
+ */
+SupplementVoiceParameters_t dx7_decode_packed_supplement(const uint8_t* bytes_p);
+
+/**
+ * returns the schema entry of a VCED parameter number, NULL for the voice name.
+ * @param operator_p receives the operator, OPERATOR_COUNT for common parameters.
+ */
+const SchemaField_t* dx7_get_voice_schema_field(uint16_t number, Operator_t* operator_p);
+
+/**
+ * returns the number of parameters outside of their schema range.
+ */
+int dx7_validate_voice_parameters(const VoiceParameters_t* parameters_p);
+
+/**
+ * checks every parameter of every voice in one pass against the schema ranges.
+ * VALIDATION_CLAMP and VALIDATION_RESET repair the voices in place.
+ * returns the number of invalid voices.
+ * @param report_p accumulates the violations, may be NULL.
+ */
+int dx7_validate_voices(VoiceParameters_t* voices_p,
+                        size_t voice_count,
+                        ValidationMode_t mode,
+                        ValidationReport_t* report_p);
+
+/**
+ * same checks on VMEM records, each field read through its schema bit offsets.
+ * VALIDATION_CLAMP and VALIDATION_RESET rewrite the bits of the fields in place.
+ * returns the number of invalid voices.
+ * @param report_p accumulates the violations by VCED parameter number, may be NULL.
+ */
+int dx7_validate_packed_voices(PackedVoiceParameters_t* voices_p,
+                               size_t voice_count,
+                               ValidationMode_t mode,
+                               ValidationReport_t* report_p);
+
+/**
+ * prints the parameters that had violations, one per line.
+ */
+void dx7_print_validation_report(FILE* file_p, const ValidationReport_t* report_p);
+
+/**
+ * adds the counts of a report to another one.
+ */
+void dx7_merge_validation_report(ValidationReport_t* report_p, const ValidationReport_t* other_p);
+
+/**
+ * returns the mode matching its name in VALIDATION_MODE_NAME_TABLE,
+ * VALIDATION_MODE_COUNT if unknown.
+ */
+ValidationMode_t dx7_get_validation_mode(const char* name_p);
+
+/**
+ * applies a voice parameter change.
+ * returns 0 if applied, -1 if the parameter or its value is out of range.
+ */
+int dx7_apply_voice_parameter(VoiceParameters_t* parameters_p,
+                              const ParameterPayload_t* parameter_p);
+
+/**
+ * writes the voice as a JSON object, parameters named after the schema.
+ * returns the number of characters written.
+ */
+int dx7_print_voice_json(FILE* file_p, const VoiceParameters_t* parameters_p);
+
+/**
+ * writes the name of a voice into a buffer of VOICE_NAME_SIZE + 1 bytes,
+ * trailing spaces removed and characters not allowed in file names
+ * replaced by '_'.
+ * returns the length of the name.
+ */
+size_t dx7_get_patch_name(const VoiceParameters_t* parameters_p, char* name_p);
+
+/**
+ * returns dx7_get_patch_name in a new string.
+ */
 char* dx7_copy_patch_name(VoiceParameters_t parameters);
 
 #endif /* HEADERS_DX7_H_ */
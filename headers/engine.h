@@ -8,23 +8,162 @@
 #ifndef HEADERS_ENGINE_H_
 #define HEADERS_ENGINE_H_
 
+#include <stdio.h>
+
+//trigrammes partagés au minimum pour une recherche approchée.
+#define NAME_SIMILARITY_THRESHOLD 0.3f
+
+#include "codec.h"
+#include "dataset.h"
 #include "dx7.h"
+#include "events.h"
+#include "manifest.h"
+#include "names.h"
+#include "path.h"
+#include "pipeline.h"
+#include "tuning.h"
 
 typedef struct ProgramOptions_t
 {
     int unpack;
-    const char* unpack_folder_p;
+    const char* unpack_folder_p;       //dans unpack_folder, finit par '/'.
+    PathBuilder_t unpack_folder;
+    ValidationMode_t validation;
+    int recover;
+    int thread_count;          //0: traitement séquentiel.
+    TuningFileFormat_t tuning_format;      //TUNING_FILE_COUNT: pas d'export.
+    const char* query_p;       //recherche dans l'index de noms, sinon NULL.
+    int similar;               //recherche approchée.
+    DatasetType_t dataset_type;        //DATASET_TYPE_COUNT: pas d'export.
+    uint64_t shard_rows;       //voix par fichier exporté, 0: un seul fichier.
+    const char* voice_template_p;      //gabarit des fichiers de voix, NULL: PATH_VOICE_TEMPLATE.
 } ProgramOptions_t;
 
+/**
+ * state of one run, passed to every stage: no global state.
+ */
+typedef struct olidx_engine_t
+{
+    int unpack;
+    uint32_t file_number;
+    const char* file_root_p;
+    const char* root_p;        //racine des sorties: chemin relatif au dossier parcouru, NULL: nom de file_root_p.
+    const char* unpack_folder_p;
+    ValidationMode_t validation;
+    ValidationReport_t validation_report;
+    SysexDispatcher_t dispatcher;
+    Packed32Voice_t bank;                   //banque en cours de déballage, en VMEM.
+    int recover;
+    FILE* log_p;               //sortie texte du message en cours.
+    PipelineJob_t* job_p;      //fichiers différés, NULL hors pipeline.
+    TuningFileFormat_t tuning_format;
+    NameIndex_t* name_index_p; //noms des voix écrites, NULL sans déballage.
+    DatasetWriter_t* dataset_p;        //NULL sans export.
+    const PathTemplate_t* voice_template_p;
+    const CodecRegistry_t* codecs_p;   //NULL: tout message est traité comme DX7.
+    uint32_t input_number;     //fichier d'entrée en cours, à partir de 1.
+    uint32_t slot;             //dernière sortie du message en cours.
+    Manifest_t* manifest_p;    //sorties écrites, NULL sans déballage.
+} olidx_engine_t;
+
+extern const olidx_engine_t OLIDX_ENGINE_INITIALISER;
+
 int run_engine(int argc, char* argv[]);
+
+/**
+ * subscribes the handlers of the unpack and export options.
+ */
+void subscribe_engine(olidx_engine_t* engine_p);
+
+/**
+ * decodes the file through the scanner: in recovery mode, or when it is a
+ * Standard MIDI File.
+ */
+int scan_file(olidx_engine_t* engine_p);
+
+/**
+ * decodes the file file_root_p, through the scanner if need be.
+ */
+int decode_file(olidx_engine_t* engine_p);
+
+/**
+ * reads, decodes and writes in parallel: one reader thread, thread_count
+ * decoder threads and the calling thread as writer, through bounded
+ * queues. files and log come out in the order of the input.
+ */
+int run_pipeline(olidx_engine_t* engine_p, int thread_count);
+
+/**
+ * decodes the .syx and .mid files of the folder file_root_p and of its sub
+ * folders, found by a parallel walk, with thread_count decoder threads
+ * taking whole files. the log and files come out in the order of the
+ * sorted paths.
+ */
+int run_folder(olidx_engine_t* engine_p, int thread_count);
+
+/**
+ * loads the name index of the unpack folder, or starts a new one.
+ */
+void open_name_index(olidx_engine_t* engine_p, NameIndex_t* index_p);
+
+/**
+ * builds and writes the name index of the unpack folder.
+ */
+void close_name_index(olidx_engine_t* engine_p);
+
+/**
+ * prints the names of an index file matching query, and their voices.
+ */
+int query_name_index(const char* index_name_p, const char* query_p, int similar);
 const char* option_handler(int argc, char* argv[], ProgramOptions_t* options_p);
 
-void process_sysex_data(const void* data_p,
-                        size_t length,
-                        const ProgramOptions_t* options_p);
-int process_sysex_bulk_data(const BulkDataPayload_t* bulk_data_p);
-int process_sysex_universal_bulk_data(const UniversalBulkDataPayload_t* bulk_data_p);
-void unpack_packed32_voice(const Packed32Voice_t voice_parameters);
-char* file_name(const char* root_p);
+void process_message(olidx_engine_t* engine_p, const ScannedMessage_t* message_p);
+void process_sysex_data(olidx_engine_t* engine_p,
+                        const void* data_p,
+                        size_t length);
+int process_sysex_bulk_data(olidx_engine_t* engine_p, const BulkDataPayload_t* bulk_data_p);
+int process_sysex_universal_bulk_data(olidx_engine_t* engine_p,
+                                      const UniversalBulkDataPayload_t* bulk_data_p);
+void write_sysex_file(olidx_engine_t* engine_p,
+                      const char* file_name_p,
+                      const uint8_t* payload_p,
+                      size_t length);
+void write_voice_file(olidx_engine_t* engine_p,
+                      const char* file_name_p,
+                      const uint8_t* payload_p,
+                      size_t length,
+                      const char* voice_name_p);
+void write_raw_file(olidx_engine_t* engine_p,
+                    const char* file_name_p,
+                    const uint8_t* data_p,
+                    size_t length);
+void unpack_voice_handler(const SysexEvent_t* event_p, void* user_p);
+void unpack_bank_handler(const SysexEvent_t* event_p, void* user_p);
+void export_tuning_handler(const SysexEvent_t* event_p, void* user_p);
+void export_voice_handler(const SysexEvent_t* event_p, void* user_p);
+
+/**
+ * exports the voices as <folder><file root>.npy, or next to the input
+ * without unpack folder.
+ */
+void open_dataset(olidx_engine_t* engine_p, DatasetWriter_t* writer_p, DatasetType_t type, uint64_t shard_rows);
+void close_dataset(olidx_engine_t* engine_p);
+
+/**
+ * ends <folder>manifest.txt, which lists every file of the run last.
+ * returns 0, or -1 if it can't be written or an output was written twice
+ * with other bytes.
+ */
+int close_manifest(olidx_engine_t* engine_p);
+
+/**
+ * converts a .tun or .scl file to a micro tuning edit buffer dump.
+ */
+int import_tuning(olidx_engine_t* engine_p, TuningFileFormat_t format);
+
+/**
+ * starts a path in the unpack folder, in the current folder without one.
+ */
+void start_path(const olidx_engine_t* engine_p, PathBuilder_t* path_p);
 
 #endif /* HEADERS_ENGINE_H_ */
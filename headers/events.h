@@ -0,0 +1,108 @@
+/*
+ * events.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_EVENTS_H_
+#define HEADERS_EVENTS_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+
+#define SYSEX_SUBSCRIBER_COUNT 8
+#define SYSEX_EVENT_MASK(TYPE) (1U << (TYPE))
+#define SYSEX_EVENT_ALL        ((1U << SYSEX_EVENT_COUNT) - 1U)
+
+/* enumerations */
+typedef enum SysexEventType_t
+{
+    SYSEX_EVENT_MESSAGE = 0,      //tout message, avant son contenu
+    SYSEX_EVENT_BANK_START,
+    SYSEX_EVENT_VOICE,
+    SYSEX_EVENT_BANK_END,
+    SYSEX_EVENT_UNIVERSAL_BLOCK,
+    SYSEX_EVENT_PARAMETER_CHANGE,
+    SYSEX_EVENT_CHECK_ERROR,      //compte d'octets faux: pas de contenu; checksum faux: voix ensuite
+    SYSEX_EVENT_COUNT
+} SysexEventType_t;
+
+/* structures */
+/**
+ * every pointer is borrowed from the input buffer and only valid during
+ * the handler call.
+ */
+typedef struct SysexEvent_t
+{
+    SysexEventType_t type;
+    uint32_t message_index;
+    const uint8_t* payload_p;  //le message entier, entre F0 et F7 exclus.
+    size_t length;
+    SysexHeader_t header;
+    union
+    {
+        struct
+        {
+            BulkData_t format;
+            int voice_count;
+        } bank;
+        struct
+        {
+            BulkData_t format;     //PACKED_32_VOICE: VMEM, VOICE_EDIT_BUFFER: VCED.
+            int index;
+            const uint8_t* bytes_p;
+        } voice;
+        struct
+        {
+            UniversalBulkData_t format;
+            int index;
+            const UniversalBulkDataHeader_t* header_p;
+            const uint8_t* data_p;
+            size_t length;
+        } universal;
+        ParameterPayload_t parameter;
+        SysexCheck_t check;
+    };
+} SysexEvent_t;
+
+typedef void (*SysexEventHandler_t)(const SysexEvent_t* event_p, void* user_p);
+
+typedef struct SysexSubscriber_t
+{
+    SysexEventHandler_t handler;
+    void* user_p;
+    uint32_t mask;
+} SysexSubscriber_t;
+
+typedef struct SysexDispatcher_t
+{
+    SysexSubscriber_t subscribers[SYSEX_SUBSCRIBER_COUNT];
+    size_t subscriber_count;
+    uint32_t message_index;
+} SysexDispatcher_t;
+
+/* initialisers */
+extern const SysexDispatcher_t SYSEX_DISPATCHER_INITIALISER;
+
+/* functions */
+/**
+ * adds a handler for the events selected by mask.
+ * handlers are called in subscription order.
+ * returns 0, or -1 if there are already SYSEX_SUBSCRIBER_COUNT subscribers.
+ */
+int events_subscribe(SysexDispatcher_t* dispatcher_p,
+                     SysexEventHandler_t handler,
+                     void* user_p,
+                     uint32_t mask);
+
+/**
+ * raises the events of one message, decoded in place without allocation.
+ */
+void events_dispatch(SysexDispatcher_t* dispatcher_p,
+                     const uint8_t* payload_p,
+                     size_t length);
+
+#endif /* HEADERS_EVENTS_H_ */
@@ -0,0 +1,72 @@
+/*
+ * generate.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_GENERATE_H_
+#define HEADERS_GENERATE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "generator.h"
+
+#define GENERATE_COMMAND        "generate"
+#define GENERATE_FILE_ROOT      "generated"
+#define GENERATE_EXTENSION      ".syx"
+//tampon d'écriture de chaque thread.
+#define GENERATE_BUFFER_SIZE    (1U << 20)
+#define GENERATE_SEED_CAPACITY  1024U
+
+typedef struct GenerateOptions_t
+{
+    uint64_t voice_count;      //arrondi à la banque supérieure.
+    int thread_count;
+    uint64_t seed;
+    const char* seed_file_p;   //banques parentes, NULL: voix aléatoires.
+    uint8_t mutation_rate;     //probabilité de mutation de chaque paramètre, sur 256.
+    const char* folder_p;
+} GenerateOptions_t;
+
+/**
+ * work of one thread: a contiguous range of banks written to its own file.
+ * each bank has its own random stream, so the banks don't depend on the
+ * thread count.
+ */
+typedef struct GenerateThread_t
+{
+    const GenerateOptions_t* options_p;
+    const VoiceParameters_t* seeds_p;
+    size_t seed_count;
+    uint64_t first_bank;
+    uint64_t bank_count;
+    char* file_name_p;
+    int result;
+} GenerateThread_t;
+
+/**
+ * olidx generate: writes random, or bred and mutated, Packed32 banks.
+ * argv[0] is the command name.
+ */
+int run_generator(int argc, char* argv[]);
+
+/**
+ * reads the voices of every VMEM and VCED dump of a file, clamped to the
+ * schema ranges.
+ * returns the number of voices read, -1 if the file can't be read.
+ */
+int generate_read_seeds(const char* file_name_p, VoiceParameters_t* seeds_p, size_t capacity);
+
+/**
+ * fills a bank, numbering its voices from bank * VOICE_COUNT.
+ */
+void generate_bank(const GenerateOptions_t* options_p,
+                   const VoiceParameters_t* seeds_p,
+                   size_t seed_count,
+                   uint64_t bank,
+                   VoiceParameters_t* voices_p);
+
+#endif /* HEADERS_GENERATE_H_ */
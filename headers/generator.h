@@ -0,0 +1,61 @@
+/*
+ * generator.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_GENERATOR_H_
+#define HEADERS_GENERATOR_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+
+//octets VCED tirés au hasard: tout sauf le nom.
+#define GENERATOR_PARAMETER_COUNT (BYTE_COUNT_VOICE_EDIT_BUFFER - VOICE_NAME_SIZE)
+#define GENERATOR_NAME_PREFIX     "GEN"
+
+/* structures */
+/**
+ * xoshiro256** state, one per thread.
+ */
+typedef struct GeneratorRandom_t
+{
+    uint64_t state[4];
+} GeneratorRandom_t;
+
+/* functions */
+/**
+ * seeds a generator; streams of a same seed are independent.
+ */
+void generator_seed(GeneratorRandom_t* random_p, uint64_t seed, uint64_t stream);
+uint64_t generator_next(GeneratorRandom_t* random_p);
+
+/**
+ * draws every parameter uniformly within its schema range.
+ */
+void generator_random_voice(GeneratorRandom_t* random_p, VoiceParameters_t* voice_p);
+
+/**
+ * takes each operator, and each voice parameter, from one parent or the other.
+ */
+void generator_crossover(GeneratorRandom_t* random_p,
+                         const VoiceParameters_t* mother_p,
+                         const VoiceParameters_t* father_p,
+                         VoiceParameters_t* child_p);
+
+/**
+ * moves each parameter, with probability rate / 256, by up to an eighth of
+ * its range, clamped to the range.
+ * parameters must be valid.
+ */
+void generator_mutate(GeneratorRandom_t* random_p, VoiceParameters_t* voice_p, uint8_t rate);
+
+/**
+ * names a voice GEN and its number in base 36.
+ */
+void generator_name_voice(VoiceParameters_t* voice_p, uint64_t number);
+
+#endif /* HEADERS_GENERATOR_H_ */
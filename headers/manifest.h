@@ -0,0 +1,100 @@
+/*
+ * manifest.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_MANIFEST_H_
+#define HEADERS_MANIFEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "names.h"
+
+#define MANIFEST_FILE_NAME    "manifest.txt"
+#define MANIFEST_BUFFER_SIZE  65536U
+#define MANIFEST_ENTRY_COUNT  1024U
+//entrée 0: fichiers de l'exécution entière, index de noms et export.
+#define MANIFEST_RUN_INPUT    0U
+
+/* structures */
+/**
+ * place of an output in the run: input file, message of the file, output
+ * of the message, all from 1, input 0 for the files of the whole run.
+ * outputs are committed in this order.
+ */
+typedef struct ManifestSequence_t
+{
+    uint32_t input;
+    uint32_t message;
+    uint32_t slot;
+} ManifestSequence_t;
+
+/**
+ * hash and size of the bytes of a listed output.
+ */
+typedef struct ManifestEntry_t
+{
+    uint64_t hash;
+    uint64_t size;
+} ManifestEntry_t;
+
+/**
+ * one line per output written: sequence, FNV-1a 64 hash and size of its
+ * bytes, path relative to the folder.
+ */
+typedef struct Manifest_t
+{
+    FILE* file_p;
+    char* folder_p;            //finit par '/'.
+    size_t folder_length;
+    uint32_t entry_count;
+    uint32_t run_slot;         //dernière sortie de l'exécution entière.
+    NameTable_t paths;         //chemins listés, par id.
+    ManifestEntry_t* entries_p;    //par id de chemin.
+    uint32_t entry_capacity;
+    uint32_t conflict_count;   //sorties écrites sur une autre aux octets différents.
+    uint32_t conflict_id;      //chemin de la première.
+} Manifest_t;
+
+/* functions */
+int manifest_compare_sequences(const ManifestSequence_t* left_p, const ManifestSequence_t* right_p);
+
+/**
+ * starts folder_p/manifest.txt, folder_p ending with '/'.
+ * returns 0, or -1 if it can't be written.
+ */
+int manifest_open(Manifest_t* manifest_p, const char* folder_p);
+
+/**
+ * records an output written from memory, between F0 and F7 if sysex.
+ * a path already listed is not listed again; with other bytes, it is
+ * counted in conflict_count.
+ */
+void manifest_add(Manifest_t* manifest_p,
+                  const ManifestSequence_t* sequence_p,
+                  const char* path_p,
+                  const uint8_t* data_p,
+                  size_t length,
+                  int sysex);
+
+/**
+ * records a file of the whole run once closed, reading it back.
+ * returns 0, or -1 if it can't be read.
+ */
+int manifest_add_file(Manifest_t* manifest_p, const char* path_p);
+
+/**
+ * returns 0, or -1 if the manifest couldn't be written.
+ */
+int manifest_close(Manifest_t* manifest_p);
+
+/**
+ * closes and removes the manifest of a run which failed.
+ */
+void manifest_discard(Manifest_t* manifest_p);
+
+#endif /* HEADERS_MANIFEST_H_ */
@@ -14,6 +14,8 @@
 
 #define MIDI_DATA_MASK 0x7F
 #define MIDI_DATA_BITS    7
+#define MIDI_STATUS_BIT 0x80
+#define MIDI_REAL_TIME  0xF8
 
 typedef enum MIDIStatus_t
 {
@@ -45,6 +47,9 @@ typedef enum MIDISystem_t
 
 typedef enum MIDISysExID_t
 {
+    MIDI_ID_EXTENDED       = 0x00, //suivi de deux octets.
+    MIDI_ID_ROLAND         = 0x41,
+    MIDI_ID_KORG           = 0x42,
     MIDI_ID_YAMAHA         = 0x43,
     MIDI_ID_NON_COMMERCIAL = 0x7D,
     MIDI_ID_NON_REAL_TIME  = 0x7E,
@@ -216,9 +221,11 @@ extern const char* const MIDI_SYSEX_EXTENSION;
 
 /**
  * returns contents between the MIDI SysEx start and EOX bytes (excluded).
+ * a message cut short by another status byte or by the end of file is
+ * returned truncated; the status byte is left in the stream.
+ * empty messages are skipped: NULL is only returned at the end of the file.
  * @param file_p: the input stream.
- * @param size_p: if SysEx: the length of the payload,
- *                if file not over: 0,
+ * @param size_p: if SysEx: the length of the payload, never 0,
  *                if end of file: EOF.
  */
 uint8_t* midi_get_next_sysex_payload(FILE* file_p, int* size_p);
@@ -0,0 +1,142 @@
+/*
+ * names.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_NAMES_H_
+#define HEADERS_NAMES_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define NAME_INDEX_MAGIC       "OLIDXNAM"
+#define NAME_INDEX_MAGIC_SIZE  8U
+#define NAME_INDEX_VERSION     1U
+#define NAME_INDEX_FILE_ROOT   "names"
+#define NAME_INDEX_EXTENSION   ".idx"
+#define NAME_TRIGRAM_SIZE      3U
+#define NAME_TEXT_SIZE         64U     //au-delà, les trigrammes sont ignorés.
+#define NAME_NOT_FOUND         UINT32_MAX
+
+/* structures */
+/**
+ * interned strings: each distinct string is stored once and known by its id.
+ */
+typedef struct NameTable_t
+{
+    char* text_p;              //chaînes bout à bout, terminées par 0.
+    uint32_t text_length;
+    uint32_t text_capacity;
+    uint32_t* offsets_p;       //début de chaque chaîne, par id.
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t* slots_p;         //hachage ouvert: id + 1, 0 si libre.
+    uint32_t slot_count;
+} NameTable_t;
+
+/**
+ * one indexed voice: its name and where it comes from.
+ */
+typedef struct NameEntry_t
+{
+    uint32_t name_id;
+    uint32_t source_id;
+} NameEntry_t;
+
+/**
+ * voice names with a trigram inverted index, rebuilt by names_build.
+ * trigrams are taken on upper case names padded with two spaces in front
+ * and one behind.
+ */
+typedef struct NameIndex_t
+{
+    NameTable_t names;
+    NameTable_t sources;
+    NameEntry_t* entries_p;
+    uint32_t entry_count;
+    uint32_t entry_capacity;
+    //index, valide pour les indexed_count premiers noms.
+    uint32_t indexed_count;
+    uint32_t trigram_count;
+    uint32_t* trigrams_p;          //clés triées.
+    uint32_t* trigram_starts_p;    //trigram_count + 1 débuts dans postings_p.
+    uint32_t* postings_p;          //ids de noms, croissants par trigramme.
+    uint8_t* name_trigram_counts_p;
+    uint32_t* name_starts_p;       //indexed_count + 1 débuts dans name_entries_p.
+    uint32_t* name_entries_p;      //entrées groupées par nom.
+    //hachage ouvert des entrées: (nom << 32 | source) + 1, 0 si libre.
+    uint64_t* pairs_p;
+    uint32_t pair_slot_count;
+} NameIndex_t;
+
+typedef struct NameMatch_t
+{
+    uint32_t name_id;
+    float score;               //similarité des trigrammes, de 0 à 1.
+} NameMatch_t;
+
+/* initialisers */
+extern const NameIndex_t NAME_INDEX_INITIALISER;
+
+/* functions */
+/**
+ * returns the id of a string, added if new.
+ */
+uint32_t names_intern(NameTable_t* table_p, const char* text_p);
+
+/**
+ * returns the id of a string, NAME_NOT_FOUND if absent.
+ */
+uint32_t names_lookup(const NameTable_t* table_p, const char* text_p);
+
+const char* names_get(const NameTable_t* table_p, uint32_t id);
+
+/**
+ * adds a voice name and its source, once per pair.
+ */
+void names_add(NameIndex_t* index_p, const char* name_p, const char* source_p);
+
+/**
+ * brings the trigram index up to date with the added names.
+ */
+void names_build(NameIndex_t* index_p);
+
+/**
+ * finds the names containing query, ignoring case.
+ * returns the number of matches; the first capacity ids are written.
+ */
+size_t names_find(const NameIndex_t* index_p, const char* query_p, uint32_t* ids_p, size_t capacity);
+
+/**
+ * finds the names sharing at least threshold of their trigrams with query.
+ * returns the number of matches; the best capacity ones are written, best first.
+ */
+size_t names_find_similar(const NameIndex_t* index_p,
+                          const char* query_p,
+                          float threshold,
+                          NameMatch_t* matches_p,
+                          size_t capacity);
+
+/**
+ * prints a name and the sources of its voices, one per line.
+ */
+void names_print(FILE* file_p, const NameIndex_t* index_p, uint32_t name_id);
+
+/**
+ * writes a built index, in the byte order of the machine.
+ * returns 0, -1 if the index is not built or on a write error.
+ */
+int names_write(FILE* file_p, const NameIndex_t* index_p);
+
+/**
+ * reads an index written by names_write, which can be added to.
+ * returns 0, -1 if the file is not an index.
+ */
+int names_read(FILE* file_p, NameIndex_t* index_p);
+
+void names_free(NameIndex_t* index_p);
+
+#endif /* HEADERS_NAMES_H_ */
@@ -0,0 +1,78 @@
+/*
+ * olidx.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_OLIDX_H_
+#define HEADERS_OLIDX_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "events.h"
+
+/**
+ * API de libolidx. Chaque contexte est indépendant: aucun état global,
+ * un contexte par thread.
+ */
+
+/* structures */
+typedef struct OlidxContext_t OlidxContext_t;
+
+typedef struct OlidxMessage_t
+{
+    const uint8_t* payload_p;  //entre F0 et F7 exclus, valide pendant l'appel.
+    size_t length;
+    int terminated;            //le message finit par F7.
+    SysexCheck_t check;
+    const SysExData_t* data_p; //valide pendant l'appel.
+} OlidxMessage_t;
+
+typedef void (*OlidxCallback_t)(const OlidxMessage_t* message_p, void* user_p);
+
+/* functions */
+/**
+ * returns a new decoding context, NULL if out of memory.
+ * @param callback called for every decoded message, may be NULL when only
+ *                 events are used: messages are then never allocated.
+ */
+OlidxContext_t* olidx_open(OlidxCallback_t callback, void* user_p);
+
+/**
+ * adds a handler for the events selected by mask, raised for every message
+ * with pointers borrowed from the context buffer.
+ * returns 0, or -1 if the context has no free subscriber slot.
+ */
+int olidx_subscribe(OlidxContext_t* context_p,
+                    SysexEventHandler_t handler,
+                    void* user_p,
+                    uint32_t mask);
+
+/**
+ * feeds bytes of a MIDI stream, in chunks of any size.
+ * messages may span several calls.
+ * returns the number of messages delivered to the callback.
+ */
+size_t olidx_feed(OlidxContext_t* context_p, const uint8_t* bytes_p, size_t length);
+
+/**
+ * delivers the message still pending at the end of the stream, if any.
+ * returns the number of messages delivered to the callback.
+ */
+size_t olidx_finish(OlidxContext_t* context_p);
+
+void olidx_close(OlidxContext_t* context_p);
+
+/**
+ * encodes a message, F0 and F7 included, into a buffer of the caller.
+ * returns the length of the message; nothing is written if it exceeds capacity.
+ */
+size_t olidx_encode(const SysExData_t* data_p,
+                    uint8_t device_id,
+                    uint8_t* buffer_p,
+                    size_t capacity);
+
+#endif /* HEADERS_OLIDX_H_ */
@@ -0,0 +1,148 @@
+/*
+ * path.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_PATH_H_
+#define HEADERS_PATH_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+
+#define PATH_CAPACITY      PATH_MAX
+#define PATH_COUNTER_DIGITS 3
+#define PATH_HASH_DIGITS   16
+#define PATH_HASH_SEED     14695981039346656037ULL
+//{shard}: deux niveaux de 256 dossiers, pris en tête du hachage.
+#define PATH_SHARD_LEVELS  2
+#define PATH_TEMPLATE_SEGMENT_COUNT 32U
+#define PATH_VOICE_TEMPLATE "{root}_{file}_{voice}_{name}"
+
+/* enumerations */
+typedef enum PathField_t
+{
+    PATH_FIELD_ROOT = 0,       //nom du fichier d'entrée, sans extension
+    PATH_FIELD_FILE,           //numéro du message
+    PATH_FIELD_VOICE,          //numéro de la voix dans la banque
+    PATH_FIELD_NAME,           //nom de la voix
+    PATH_FIELD_HASH,           //hachage du contenu, en hexadécimal
+    PATH_FIELD_SHARD,          //dossiers tirés du hachage: ab/cd
+    PATH_FIELD_COUNT           //texte littéral
+} PathField_t;
+
+/* structures */
+/**
+ * file path built in place, without allocation.
+ * an append that doesn't fit sets overflow and leaves the text as it was.
+ */
+typedef struct PathBuilder_t
+{
+    size_t length;
+    int overflow;
+    char text[PATH_CAPACITY];
+} PathBuilder_t;
+
+typedef struct PathSegment_t
+{
+    PathField_t field;
+    uint16_t offset;           //texte littéral dans PathTemplate_t.text.
+    uint16_t length;
+} PathSegment_t;
+
+/**
+ * naming template parsed once, expanded for each file without parsing.
+ */
+typedef struct PathTemplate_t
+{
+    char text[PATH_CAPACITY];
+    PathSegment_t segments[PATH_TEMPLATE_SEGMENT_COUNT];
+    size_t segment_count;
+} PathTemplate_t;
+
+/**
+ * values of the template fields for one file.
+ */
+typedef struct PathValues_t
+{
+    const char* root_p;        //chemin relatif, ses dossiers gardés.
+    uint64_t file;
+    uint64_t voice;
+    const char* name_p;
+    size_t name_length;
+    uint64_t hash;
+} PathValues_t;
+
+/* tables */
+extern const char* const PATH_FIELD_NAME_TABLE[PATH_FIELD_COUNT];
+
+/* functions */
+void path_init(PathBuilder_t* path_p, const char* text_p);
+int path_append(PathBuilder_t* path_p, const char* text_p);
+int path_append_length(PathBuilder_t* path_p, const char* text_p, size_t length);
+
+/**
+ * appends the file name of path_p, without directory nor extension.
+ */
+int path_append_root(PathBuilder_t* path_p, const char* file_path_p);
+
+/**
+ * returns the length of a path without the extension of its file name.
+ */
+size_t path_get_root_length(const char* path_p);
+
+/**
+ * appends a relative path without its extension, its folders kept.
+ */
+int path_append_relative_root(PathBuilder_t* path_p, const char* relative_path_p);
+
+/**
+ * appends "_" and the counter, on PATH_COUNTER_DIGITS digits at least.
+ */
+int path_append_counter(PathBuilder_t* path_p, uint64_t counter);
+
+/**
+ * appends a name, its bytes not allowed in a file name replaced by '_'.
+ */
+int path_append_name(PathBuilder_t* path_p, const char* name_p, size_t length);
+
+/**
+ * cuts the path back to length, to reuse a common prefix.
+ */
+void path_truncate(PathBuilder_t* path_p, size_t length);
+
+/**
+ * returns the path, NULL if it didn't fit.
+ */
+const char* path_get(const PathBuilder_t* path_p);
+
+/**
+ * parses a template made of text and {field} names of PATH_FIELD_NAME_TABLE.
+ * returns 0, or -1 if a field is unknown or the template too long.
+ */
+int path_compile_template(PathTemplate_t* template_p, const char* text_p);
+
+/**
+ * appends the expansion of a template.
+ */
+int path_append_template(PathBuilder_t* path_p, const PathTemplate_t* template_p, const PathValues_t* values_p);
+
+/**
+ * FNV-1a 64 bits, for {hash} and {shard}.
+ */
+uint64_t path_hash(const void* data_p, size_t length);
+
+/**
+ * goes on hashing after hash, PATH_HASH_SEED at first.
+ */
+uint64_t path_hash_continue(uint64_t hash, const void* data_p, size_t length);
+
+/**
+ * opens a file, creating its missing folders first.
+ */
+FILE* path_open(const char* path_p, const char* mode_p);
+
+#endif /* HEADERS_PATH_H_ */
@@ -0,0 +1,136 @@
+/*
+ * pipeline.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_PIPELINE_H_
+#define HEADERS_PIPELINE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "manifest.h"
+#include "scanner.h"
+
+#define PIPELINE_QUEUE_CAPACITY 16U
+//messages entre lecture et écriture: borne la mémoire et la fenêtre de réordonnancement.
+#define PIPELINE_WINDOW         64U
+
+/* structures */
+/**
+ * bounded ring of pointers shared by any number of producers and consumers.
+ * push blocks while the ring is full, pop while it is empty.
+ */
+typedef struct PipelineQueue_t
+{
+    void* items[PIPELINE_QUEUE_CAPACITY];
+    size_t head;               //prochain élément lu.
+    size_t count;
+    int closed;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} PipelineQueue_t;
+
+typedef struct PipelineFile_t
+{
+    ManifestSequence_t sequence;       //étiquetée au décodage.
+    char* name_p;
+    uint8_t* payload_p;
+    size_t length;
+    int sysex;                 //encadré par F0 et F7 à l'écriture.
+    int written;
+    char voice_name[VOICE_NAME_SIZE + 1];  //voix à indexer, vide sinon.
+} PipelineFile_t;
+
+/**
+ * one message on its way through the pipeline, with the log and the files
+ * its decoding produced, written later in message order.
+ */
+typedef struct PipelineJob_t
+{
+    uint32_t number;           //ordre d'arrivée, à partir de 1.
+    ScannedMessage_t message;  //payload_p appartient au travail.
+    char* log_p;
+    size_t log_length;
+    PipelineFile_t* files_p;
+    size_t file_count;
+    size_t file_capacity;
+    VoiceParameters_t* voices_p;   //voix à exporter, dans l'ordre du message.
+    size_t voice_count;
+    size_t voice_capacity;
+} PipelineJob_t;
+
+/**
+ * jobs finished out of order, kept until every job before them is done.
+ * the producers hold at most PIPELINE_WINDOW jobs, so a slot per job in
+ * flight is enough.
+ */
+typedef struct PipelineReorder_t
+{
+    PipelineJob_t* jobs[PIPELINE_WINDOW];
+    uint32_t next_number;      //prochain travail à livrer.
+} PipelineReorder_t;
+
+/* initialisers */
+extern const PipelineReorder_t PIPELINE_REORDER_INITIALISER;
+
+/* functions */
+void pipeline_queue_init(PipelineQueue_t* queue_p);
+void pipeline_queue_destroy(PipelineQueue_t* queue_p);
+void pipeline_queue_push(PipelineQueue_t* queue_p, void* item_p);
+
+/**
+ * returns the oldest item, NULL once the queue is closed and drained.
+ */
+void* pipeline_queue_pop(PipelineQueue_t* queue_p);
+
+/**
+ * wakes every consumer: no item will be pushed anymore.
+ */
+void pipeline_queue_close(PipelineQueue_t* queue_p);
+
+/**
+ * returns a job owning payload_p, which must come from malloc.
+ */
+PipelineJob_t* pipeline_new_job(uint32_t number, const ScannedMessage_t* message_p, uint8_t* payload_p);
+
+/**
+ * keeps a copy of a file to write with the job.
+ */
+void pipeline_add_file(PipelineJob_t* job_p,
+                       const ManifestSequence_t* sequence_p,
+                       const char* name_p,
+                       const uint8_t* payload_p,
+                       size_t length,
+                       int sysex,
+                       const char* voice_name_p);
+
+/**
+ * keeps a copy of a voice to export with the job.
+ */
+void pipeline_add_voice(PipelineJob_t* job_p, const VoiceParameters_t* voice_p);
+
+/**
+ * prints the log of the job, then writes its files in sequence order,
+ * recording them in manifest_p unless NULL.
+ */
+void pipeline_write_job(FILE* log_p, PipelineJob_t* job_p, Manifest_t* manifest_p);
+void pipeline_free_job(PipelineJob_t* job_p);
+
+/**
+ * keeps a finished job until its turn.
+ * returns 0, or -1 if its number is outside the window.
+ */
+int pipeline_reorder_put(PipelineReorder_t* reorder_p, PipelineJob_t* job_p);
+
+/**
+ * returns the next job in number order if it is finished, NULL otherwise.
+ */
+PipelineJob_t* pipeline_reorder_take(PipelineReorder_t* reorder_p);
+
+#endif /* HEADERS_PIPELINE_H_ */
@@ -0,0 +1,64 @@
+/*
+ * scaling.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SCALING_H_
+#define HEADERS_SCALING_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "midi.h"
+
+//une voie par opérateur, arrondi à la largeur d'un registre AVX.
+#define SCALING_LANE_COUNT 8
+
+/* structures */
+/**
+ * one value per operator, in the order of the dump; lanes past
+ * OPERATOR_COUNT are zero.
+ */
+typedef float ScalingVector_t __attribute__((vector_size(SCALING_LANE_COUNT * sizeof(float))));
+
+/**
+ * decoded fractional scaling of the six operators, levels in output level
+ * steps, signed.
+ */
+typedef struct ScalingTable_t
+{
+    ScalingVector_t offset;
+    ScalingVector_t level[FRACTIONAL_SCALING_COUNT];
+} ScalingTable_t;
+
+/**
+ * level offset of every operator for every key: note[key][operator].
+ */
+typedef struct ScalingCurve_t
+{
+    ScalingVector_t note[MIDI_NOTE_COUNT];
+} ScalingCurve_t;
+
+/* functions */
+/**
+ * decodes the 14 bit signed values of a FKSY block.
+ */
+void scaling_decode(const FractionalScalingParameters_t parameters, ScalingTable_t* table_p);
+
+/**
+ * decodes the tables of a fractional scaling universal payload, 1 or 32 of them.
+ * returns the number of tables written, 0 if the payload is not a fractional scaling.
+ */
+int scaling_decode_universal(const UniversalBulkDataPayload_t* universal_p, ScalingTable_t* tables_p);
+
+/**
+ * evaluates count tables for all keys and operators at once.
+ * tables and curves must be aligned on sizeof(ScalingVector_t): on the
+ * stack, static, or from aligned_alloc.
+ */
+void scaling_evaluate(const ScalingTable_t* tables_p, size_t count, ScalingCurve_t* curves_p);
+
+#endif /* HEADERS_SCALING_H_ */
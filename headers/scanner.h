@@ -0,0 +1,83 @@
+/*
+ * scanner.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SCANNER_H_
+#define HEADERS_SCANNER_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "smf.h"
+
+/* structures */
+typedef struct ScannedMessage_t
+{
+    const uint8_t* payload_p;  //entre F0 et F7 exclus, emprunté au scanner.
+    size_t length;
+    size_t offset;             //position du F0 dans l'entrée.
+    int terminated;            //le message finit par F7.
+    SysexCheck_t check;
+    int salvaged_voice_count;  //> 0 si payload_p est un Packed32 reconstruit.
+} ScannedMessage_t;
+
+typedef struct ScanStatistics_t
+{
+    uint32_t message_count;
+    uint32_t check_count[SYSEX_CHECK_COUNT];
+    uint32_t unterminated_count;
+    uint32_t salvaged_count;
+    uint32_t salvaged_voice_count;
+    size_t   skipped_byte_count;
+} ScanStatistics_t;
+
+typedef struct SysexScanner_t
+{
+    const uint8_t* data_p;
+    size_t length;
+    size_t position;
+    int recover;
+    int mapped;
+    int smf;                   //l'entrée est un fichier MIDI standard.
+    SmfReader_t smf_reader;
+    uint8_t* owned_p;          //message recopié ou reconstruit, libéré au suivant.
+    ScanStatistics_t statistics;
+} SysexScanner_t;
+
+/* initialisers */
+extern const SysexScanner_t SYSEX_SCANNER_INITIALISER;
+
+/* functions */
+/**
+ * maps a file for scanning.
+ * a Standard MIDI File is read through its SysEx events.
+ * returns 0 on success, -1 if the file can't be read.
+ */
+int scanner_open_file(SysexScanner_t* scanner_p, const char* path_p, int recover);
+
+/**
+ * scans a buffer owned by the caller.
+ */
+void scanner_open_buffer(SysexScanner_t* scanner_p,
+                         const uint8_t* data_p,
+                         size_t length,
+                         int recover);
+
+void scanner_close(SysexScanner_t* scanner_p);
+
+/**
+ * finds the next SysEx message.
+ * in recovery mode, real time bytes are dropped from the message, bulk
+ * dumps are checked against their byte count and checksum, and damaged
+ * Packed32 voice dumps are rebuilt from their salvageable voices.
+ * returns 1 if a message was found, 0 at the end of the input.
+ */
+int scanner_next(SysexScanner_t* scanner_p, ScannedMessage_t* message_p);
+
+void scanner_print_statistics(FILE* file_p, const ScanStatistics_t* statistics_p);
+
+#endif /* HEADERS_SCANNER_H_ */
@@ -0,0 +1,31 @@
+/*
+ * send.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SEND_H_
+#define HEADERS_SEND_H_
+
+#include "transport.h"
+
+#define SEND_COMMAND "send"
+
+typedef struct SendOptions_t
+{
+    TransportKind_t kind;
+    TransportPacing_t pacing;
+    const char* ports[TRANSPORT_PORT_COUNT];
+    size_t port_count;
+    int device;                //0: messages envoyés tels quels, sinon 1 à 16.
+} SendOptions_t;
+
+/**
+ * olidx send: sends the SysEx messages of every file to every port, all
+ * ports at once.
+ * argv[0] is the command name.
+ */
+int run_sender(int argc, char* argv[]);
+
+#endif /* HEADERS_SEND_H_ */
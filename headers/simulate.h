@@ -0,0 +1,49 @@
+/*
+ * simulate.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SIMULATE_H_
+#define HEADERS_SIMULATE_H_
+
+#include <pthread.h>
+
+#include "simulator.h"
+#include "transport.h"
+
+#define SIMULATE_COMMAND "simulate"
+
+typedef struct SimulateOptions_t
+{
+    TransportKind_t kind;
+    TransportPacing_t pacing;  //débit des réponses.
+    const char* ports[TRANSPORT_PORT_COUNT];   //<sortie>[:<entrée>]
+    size_t port_count;
+    uint8_t device;            //0 à 15.
+    uint32_t latency_ms;       //délai avant chaque réponse.
+    const char* file_p;        //dumps chargés au démarrage, sinon NULL.
+} SimulateOptions_t;
+
+/**
+ * one simulated device, answering on its own port in its own thread.
+ */
+typedef struct SimulateUnit_t
+{
+    const SimulateOptions_t* options_p;
+    char* output_p;
+    const char* input_p;
+    DeviceSimulator_t simulator;
+    int result;
+    int started;
+    pthread_t thread;
+} SimulateUnit_t;
+
+/**
+ * olidx simulate: runs a DX7II-FD on every port until its input closes.
+ * argv[0] is the command name.
+ */
+int run_simulator(int argc, char* argv[]);
+
+#endif /* HEADERS_SIMULATE_H_ */
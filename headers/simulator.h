@@ -0,0 +1,126 @@
+/*
+ * simulator.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SIMULATOR_H_
+#define HEADERS_SIMULATOR_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+
+//données d'un bloc universel, sans son en-tête "LM  xxxxxx".
+#define SIMULATOR_UNIVERSAL_DATA_SIZE(BYTE_COUNT)\
+    ((BYTE_COUNT) - UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE - UNIVERSAL_BULK_DATA_FORMAT_SIZE)
+//premier paramètre de l'installation système, après ceux de la performance.
+#define SIMULATOR_SYSTEM_SET_UP_FIRST_PARAMETER 53U
+
+/* structures */
+/**
+ * memory of a DX7II-FD. the set up, without a structure yet, is kept as
+ * the bytes of its dump.
+ */
+typedef struct SimulatorMemory_t
+{
+    VoiceParameters_t voice_edit_buffer;
+    Packed32Voice_t packed32_voice;
+    SupplementVoiceParameters_t supplement_edit_buffer;
+    Packed32SupplementVoice_t packed32_supplement;
+    PerformanceParameters_t performance_edit_buffer;
+    Packed32Performance_t packed32_performance;
+    uint8_t system_setup[SIMULATOR_UNIVERSAL_DATA_SIZE(BYTE_COUNT_SYSTEM_SET_UP)];
+    MicroTuningParameters_t micro_tuning_edit_buffer;
+    MicroTuningParameters_t micro_tuning_memory[2];
+    MicroTuningCartridge_t micro_tuning_cartridge;
+    FractionalScalingParameters_t fractional_scaling_edit_buffer;
+    FractionalScalingCartridge_t fractional_scaling_cartridge;
+} SimulatorMemory_t;
+
+/**
+ * place of a dump in SimulatorMemory_t.
+ */
+typedef struct SimulatorRegion_t
+{
+    size_t offset;
+    size_t size;
+} SimulatorRegion_t;
+
+typedef struct SimulatorStatistics_t
+{
+    uint32_t message_count;
+    uint32_t request_count;
+    uint32_t dump_count;       //dumps chargés en mémoire.
+    uint32_t parameter_count;  //changements de paramètre appliqués.
+    uint32_t rejected_count;   //illisibles ou hors limites.
+    uint32_t ignored_count;    //autre fabricant ou autre numéro d'appareil.
+    uint64_t reply_byte_count;
+} SimulatorStatistics_t;
+
+typedef struct DeviceSimulator_t
+{
+    uint8_t device;            //0 à 15.
+    SimulatorMemory_t memory;
+    SimulatorStatistics_t statistics;
+} DeviceSimulator_t;
+
+/* tables */
+//BULK_DATA_UNIVERSAL_BULK_DUMP et BULK_DATA_MALFORMED n'ont pas de région.
+extern const SimulatorRegion_t SIMULATOR_BULK_REGION_TABLE[BULK_DATA_FORMAT_COUNT];
+extern const SimulatorRegion_t SIMULATOR_UNIVERSAL_REGION_TABLE[UNIVERSAL_BULK_DATA_COUNT];
+
+/* initialisers */
+extern const SimulatorStatistics_t SIMULATOR_STATISTICS_INITIALISER;
+
+/* functions */
+/**
+ * starts a device with initial voices, equal temperament and flat
+ * fractional scalings.
+ * @param device 0 to 15.
+ */
+void simulator_init(DeviceSimulator_t* simulator_p, uint8_t device);
+
+/**
+ * handles a message between F0 and F7, as the device would: dumps are
+ * loaded into memory, parameter changes applied and dump requests answered.
+ * messages for another device number are ignored.
+ * returns the reply to free, NULL without reply.
+ */
+uint8_t* simulator_receive(DeviceSimulator_t* simulator_p,
+                           const uint8_t* payload_p,
+                           size_t length,
+                           size_t* reply_length_p);
+
+/**
+ * returns the dump of a memory, formatted for the device, to free.
+ * NULL if the request is malformed.
+ */
+uint8_t* simulator_format_dump(const DeviceSimulator_t* simulator_p,
+                               const DumpRequest_t* request_p,
+                               size_t* length_p);
+
+/**
+ * copies a decoded dump into its memory, whatever its device number.
+ * returns 0, or -1 if the dump is malformed.
+ */
+int simulator_load(DeviceSimulator_t* simulator_p, const BulkDataPayload_t* bulk_data_p);
+
+/**
+ * applies a parameter change:
+ * - voice and supplement parameters are checked against their schema,
+ * - performance and set up parameters are stored at their number in
+ *   their edit buffer,
+ * - micro tuning data is [note][msb][lsb] in the edit buffer,
+ * - fractional scaling data is [operator][index][msb][lsb], index 0 being
+ *   the offset and 1 to 40 the levels.
+ * returns 0 if applied, -1 otherwise.
+ */
+int simulator_apply_parameter(DeviceSimulator_t* simulator_p, const ParameterPayload_t* parameter_p);
+
+void simulator_print_statistics(FILE* file_p, const SimulatorStatistics_t* statistics_p);
+
+#endif /* HEADERS_SIMULATOR_H_ */
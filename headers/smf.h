@@ -0,0 +1,136 @@
+/*
+ * smf.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_SMF_H_
+#define HEADERS_SMF_H_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#define SMF_EXTENSION         ".mid"
+#define SMF_HEADER_ID         "MThd"
+#define SMF_TRACK_ID          "MTrk"
+#define SMF_CHUNK_ID_SIZE     4U
+#define SMF_CHUNK_HEADER_SIZE 8U       //identifiant et longueur sur 32 bits.
+#define SMF_HEADER_SIZE       6U       //format, nombre de pistes, division.
+#define SMF_VLQ_MAX_SIZE      4U
+//500 tops par noire à 120 bpm: un top par milliseconde.
+#define SMF_DIVISION          500U
+#define SMF_TEMPO             500000U  //microsecondes par noire.
+
+/* enumerations */
+typedef enum SmfStatus_t
+{
+    SMF_STATUS_SYSEX  = 0xF0,  //F0 <longueur> <données>: premier paquet
+    SMF_STATUS_ESCAPE = 0xF7,  //F7 <longueur> <données>: paquet suivant ou octets bruts
+    SMF_STATUS_META   = 0xFF   //FF <type> <longueur> <données>
+} SmfStatus_t;
+
+typedef enum SmfMeta_t
+{
+    SMF_META_END_OF_TRACK = 0x2F,
+    SMF_META_TEMPO        = 0x51
+} SmfMeta_t;
+
+/* structures */
+typedef struct SmfSysex_t
+{
+    const uint8_t* payload_p;  //entre F0 et F7 exclus, valide jusqu'au suivant.
+    size_t length;
+    size_t offset;             //position de l'évènement F0 dans le fichier.
+    int terminated;            //le dernier paquet finit par F7.
+    uint32_t track;            //à partir de 1.
+    uint64_t tick;             //temps absolu dans la piste.
+} SmfSysex_t;
+
+typedef struct SmfReader_t
+{
+    const uint8_t* data_p;     //emprunté à l'appelant, rien n'est recopié.
+    size_t length;
+    size_t position;           //chunk suivant.
+    uint16_t format;
+    uint16_t track_count;
+    uint16_t division;
+    const uint8_t* track_p;    //piste en cours, NULL avant la première.
+    size_t track_length;
+    size_t track_position;
+    uint32_t track;
+    uint64_t tick;
+    uint8_t running_status;
+    int in_packet;             //un F0 sans F7 attend ses paquets suivants.
+    uint8_t* packet_p;         //seuls les messages en plusieurs paquets sont recopiés.
+    size_t packet_length;
+    size_t packet_capacity;
+    size_t packet_offset;
+    uint64_t packet_tick;
+} SmfReader_t;
+
+typedef struct SmfWriter_t
+{
+    FILE* file_p;
+    long track_length_position;        //complété à la fermeture.
+    uint32_t track_length;
+    uint32_t gap_ticks;        //entre deux messages.
+    uint32_t message_count;
+} SmfWriter_t;
+
+/* initialisers */
+extern const SmfReader_t SMF_READER_INITIALISER;
+
+/* functions */
+/**
+ * decodes a variable length quantity.
+ * returns the number of bytes read, 0 if it is truncated or too long.
+ */
+size_t smf_read_vlq(const uint8_t* bytes_p, size_t length, uint32_t* value_p);
+
+/**
+ * encodes a variable length quantity, returns the number of bytes written.
+ */
+size_t smf_write_vlq(uint32_t value, uint8_t* bytes_p);
+
+int smf_is_smf(const uint8_t* data_p, size_t length);
+
+/**
+ * returns 1 if the file starts with an SMF header.
+ */
+int smf_is_file(const char* path_p);
+
+/**
+ * reads the header chunk of data_p, which must stay valid until smf_close.
+ * returns 0 on success, -1 if data_p is not an SMF.
+ */
+int smf_open(SmfReader_t* reader_p, const uint8_t* data_p, size_t length);
+
+/**
+ * finds the next SysEx message of the tracks, in file order, skipping
+ * channel and meta events. a message split in F0 and F7 packets is
+ * gathered; one whose packets never end is returned unterminated.
+ * returns 1 if a message was found, 0 at the end of the file.
+ */
+int smf_next_sysex(SmfReader_t* reader_p, SmfSysex_t* sysex_p);
+
+void smf_close(SmfReader_t* reader_p);
+
+/**
+ * starts a type 0 SMF of one track, with gap_ms between two messages.
+ * returns 0, or -1 if the file can't be written.
+ */
+int smf_writer_open(SmfWriter_t* writer_p, FILE* file_p, uint32_t gap_ms);
+
+/**
+ * adds a message, F0 and F7 included, as one SysEx event.
+ */
+int smf_write_sysex(SmfWriter_t* writer_p, const uint8_t* message_p, size_t length);
+
+/**
+ * ends the track and writes its length: file_p must be seekable.
+ */
+int smf_writer_close(SmfWriter_t* writer_p);
+
+#endif /* HEADERS_SMF_H_ */
@@ -0,0 +1,171 @@
+/*
+ * transport.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_TRANSPORT_H_
+#define HEADERS_TRANSPORT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+//31250 bauds, 10 bits par octet.
+#define TRANSPORT_MIDI_RATE        3.125f
+#define TRANSPORT_CHUNK_SIZE       16U
+#define TRANSPORT_GAP_MS           100U
+#define TRANSPORT_PORT_COUNT       64U
+#define TRANSPORT_PORT_SEPARATOR   ':'
+#define TRANSPORT_RECEIVE_CAPACITY (1U << 16)
+
+/* enumerations */
+typedef enum TransportKind_t
+{
+    TRANSPORT_FILE = 0,        //fichier ordinaire ou FIFO
+    TRANSPORT_RAW,             //périphérique MIDI brut: /dev/snd/midiC*D*, /dev/midi*
+    TRANSPORT_KIND_COUNT
+} TransportKind_t;
+
+/* structures */
+/**
+ * bytes_per_ms <= 0 sends without pacing.
+ */
+typedef struct TransportPacing_t
+{
+    float bytes_per_ms;
+    uint32_t chunk_size;       //octets écrits entre deux pauses.
+    uint32_t gap_ms;           //silence après chaque message.
+} TransportPacing_t;
+
+typedef struct Transport_t Transport_t;
+
+typedef struct TransportBackend_t
+{
+    /**
+     * opens the output, and the input when input_p isn't NULL.
+     * returns 0, or -1 with errno set.
+     */
+    int (*open)(Transport_t* transport_p, const char* output_p, const char* input_p);
+    ssize_t (*write)(Transport_t* transport_p, const uint8_t* data_p, size_t length);
+    /**
+     * returns the bytes read, 0 on timeout or end of input, -1 on error.
+     */
+    ssize_t (*read)(Transport_t* transport_p, uint8_t* data_p, size_t capacity, int timeout_ms);
+    void (*close)(Transport_t* transport_p);
+} TransportBackend_t;
+
+struct Transport_t
+{
+    const TransportBackend_t* backend_p;
+    int output_fd;
+    int input_fd;
+    TransportPacing_t pacing;
+    uint64_t next_time_ns;     //échéance de la prochaine écriture.
+    uint64_t sent_byte_count;
+    uint32_t sent_message_count;
+    uint8_t* receive_p;        //octets reçus pas encore rendus.
+    size_t receive_length;
+};
+
+typedef struct TransportMessage_t
+{
+    struct TransportMessage_t* next_p;
+    size_t length;
+    uint8_t data[];            //message complet, de F0 à F7.
+} TransportMessage_t;
+
+/**
+ * one sending thread per port, fed by an unbounded queue.
+ */
+typedef struct TransportPort_t
+{
+    Transport_t transport;
+    TransportMessage_t* head_p;
+    TransportMessage_t* tail_p;
+    int closed;
+    int result;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_t thread;
+} TransportPort_t;
+
+typedef struct TransportScheduler_t
+{
+    TransportPort_t* ports[TRANSPORT_PORT_COUNT];
+    size_t port_count;
+} TransportScheduler_t;
+
+/* tables */
+extern const char* const TRANSPORT_KIND_NAME_TABLE[TRANSPORT_KIND_COUNT];
+extern const TransportBackend_t TRANSPORT_BACKEND_TABLE[TRANSPORT_KIND_COUNT];
+
+/* initialisers */
+extern const TransportPacing_t TRANSPORT_PACING_INITIALISER;
+extern const TransportScheduler_t TRANSPORT_SCHEDULER_INITIALISER;
+
+/* functions */
+/**
+ * returns the kind matching its name in TRANSPORT_KIND_NAME_TABLE,
+ * TRANSPORT_KIND_COUNT if unknown.
+ */
+TransportKind_t transport_get_kind(const char* name_p);
+
+/**
+ * splits <output>[:<input>] in place.
+ * returns the input, the output itself without separator.
+ */
+const char* transport_split_port(char* port_p);
+
+int transport_open(Transport_t* transport_p,
+                   TransportKind_t kind,
+                   const char* output_p,
+                   const char* input_p,
+                   const TransportPacing_t* pacing_p);
+void transport_close(Transport_t* transport_p);
+
+/**
+ * sends F0, payload and F7, paced by chunks, then waits the gap.
+ * returns 0, or -1 if the output failed.
+ */
+int transport_send_sysex(Transport_t* transport_p, const uint8_t* payload_p, size_t length);
+
+/**
+ * sends bytes already framed, paced by chunks, then waits the gap.
+ */
+int transport_send(Transport_t* transport_p, const uint8_t* data_p, size_t length);
+
+/**
+ * waits for the next SysEx message, real time bytes dropped.
+ * the timeout runs from the last byte received, so a long dump arriving
+ * at MIDI speed isn't cut. a negative timeout waits forever.
+ * returns 1 and a payload between F0 and F7 to free, 0 on timeout or end
+ * of input, -1 on error.
+ */
+int transport_receive_sysex(Transport_t* transport_p, uint8_t** payload_pp, size_t* length_p, int timeout_ms);
+
+/**
+ * opens a port and starts its sending thread.
+ * returns the port number, or -1.
+ */
+int transport_scheduler_add_port(TransportScheduler_t* scheduler_p,
+                                 TransportKind_t kind,
+                                 const char* output_p,
+                                 const TransportPacing_t* pacing_p);
+
+/**
+ * queues a copy of a SysEx payload for a port.
+ */
+void transport_scheduler_queue(TransportScheduler_t* scheduler_p, size_t port, const uint8_t* payload_p, size_t length);
+
+/**
+ * sends what is queued, then stops and closes every port.
+ * returns the number of ports that failed.
+ * @param log_p receives the count of messages and bytes sent by each port, may be NULL.
+ */
+int transport_scheduler_finish(TransportScheduler_t* scheduler_p, FILE* log_p);
+
+#endif /* HEADERS_TRANSPORT_H_ */
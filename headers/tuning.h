@@ -0,0 +1,106 @@
+/*
+ * tuning.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_TUNING_H_
+#define HEADERS_TUNING_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "dx7.h"
+#include "midi.h"
+
+//hauteurs en 1/12288 d'octave: le demi-ton et le pas fin du DX7II y sont entiers.
+#define TUNING_STEPS_PER_SEMITONE 1024U
+#define TUNING_STEPS_PER_OCTAVE   (12U * TUNING_STEPS_PER_SEMITONE)
+#define TUNING_FINE_STEP          12U      //pas fin du DX7II: 1/1024 d'octave
+#define TUNING_FINE_MAXIMUM       85U
+#define TUNING_PITCH_MAXIMUM      ((MIDI_NOTE_COUNT - 1) * TUNING_STEPS_PER_SEMITONE + TUNING_FINE_MAXIMUM * TUNING_FINE_STEP)
+#define TUNING_NOTE_0_FREQUENCY   8.1757989156437073 //note 0 au tempérament égal, La 440 Hz
+#define TUNING_CENTS_PER_SEMITONE 100.0
+
+/* enumerations */
+typedef enum TuningFileFormat_t
+{
+    TUNING_FILE_TUN = 0,       //AnaMark, fréquence exacte de chaque note
+    TUNING_FILE_SCL,           //Scala, intervalles depuis la note 0
+    TUNING_FILE_COUNT
+} TuningFileFormat_t;
+
+/* structures */
+/**
+ * one micro tuning: the pitch of every note and its frequency.
+ */
+typedef struct TuningTable_t
+{
+    uint32_t pitch[MIDI_NOTE_COUNT];   //en pas de 1/12288 d'octave depuis la note 0
+    float frequency[MIDI_NOTE_COUNT];  //Hz
+} TuningTable_t;
+
+/* tables */
+extern const char* const TUNING_FILE_EXTENSION_TABLE[TUNING_FILE_COUNT];
+
+/* functions */
+/**
+ * fills a table with equal temperament.
+ */
+void tuning_set_equal_temperament(TuningTable_t* table_p);
+
+/**
+ * returns the frequency of a pitch, from the exp2 tables.
+ */
+double tuning_get_frequency(uint32_t pitch);
+
+/**
+ * fills the frequencies from the pitches.
+ */
+void tuning_update_frequencies(TuningTable_t* table_p);
+
+/**
+ * decodes the 128 [coarse][fine] pairs of a MCRY block.
+ * returns the number of notes out of range, clamped.
+ */
+int tuning_decode(const MicroTuningParameters_t parameters, TuningTable_t* table_p);
+
+/**
+ * encodes a table to the nearest pitches the DX7II can play.
+ */
+void tuning_encode(const TuningTable_t* table_p, MicroTuningParameters_t parameters);
+
+/**
+ * decodes the tunings of a micro tuning universal payload, 1 or 64 of them.
+ * returns the number of tables written, 0 if the payload is not a micro tuning.
+ */
+int tuning_decode_universal(const UniversalBulkDataPayload_t* universal_p, TuningTable_t* tables_p);
+
+/**
+ * returns a universal dump of count tunings, F0 and F7 excluded: an edit
+ * buffer for one table, a cartridge otherwise, padded with equal temperament.
+ */
+uint8_t* tuning_format_sysex(const TuningTable_t* tables_p,
+                             int count,
+                             uint8_t device_id,
+                             size_t* length_p);
+
+/**
+ * returns the format named by the extension of a path, TUNING_FILE_COUNT if none.
+ */
+TuningFileFormat_t tuning_get_file_format(const char* path_p);
+
+void tuning_write_file(FILE* file_p,
+                       const TuningTable_t* table_p,
+                       TuningFileFormat_t format,
+                       const char* name_p);
+
+/**
+ * reads a tuning file; a Scala scale repeats from note 0 at equal temperament.
+ * returns 0, or -1 if the file holds no tuning.
+ */
+int tuning_read_file(FILE* file_p, TuningTable_t* table_p, TuningFileFormat_t format);
+
+#endif /* HEADERS_TUNING_H_ */
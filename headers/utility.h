@@ -7,6 +7,8 @@
 #define GET_AMOUNT(BITS) (2 << BITS)
 #define OK(MESSAGE) printf("ok number " #MESSAGE "!\n")
 #define SIZE_OF_FIELD(STRUCT_TYPE, FIELD) sizeof(((STRUCT_TYPE*) 0)->FIELD)
+//chiffres d'un uint64_t et le zéro final.
+#define FORMAT_UNSIGNED_SIZE 21
 
 /**
  * Most Significant Byte first!
@@ -19,11 +21,16 @@ typedef struct TwoByte_t
 
 int get_checksum(const void* buffer, size_t buffer_size);
 uint8_t generate_checksum(const void* buffer, size_t buffze_size);
+int is_checksum_valid(const void* buffer, size_t buffer_size, uint8_t checksum);
 uint16_t get_payload_size(TwoByte_t byte_count);
 TwoByte_t format_payload_size(size_t size);
 
-char* append_counter(char** text_pp, uint8_t counter);
-char* append_str(char** text_pp, const char* appendage_p);
+/**
+ * writes value in decimal, left padded with zeros to digit_count digits.
+ * returns the number of characters, without the final zero.
+ * @param text_p FORMAT_UNSIGNED_SIZE bytes at least.
+ */
+size_t format_unsigned(char* text_p, uint64_t value, size_t digit_count);
 const char* path_to_file_name(const char* path_p);
 const char* get_extension(const char* path_p);
 char* strip_extension(const char* path_p);
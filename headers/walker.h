@@ -0,0 +1,106 @@
+/*
+ * walker.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#ifndef HEADERS_WALKER_H_
+#define HEADERS_WALKER_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#define WALKER_BUFFER_SIZE     32768U  //entrées lues par getdents64.
+#define WALKER_DEQUE_CAPACITY  64U
+#define WALKER_FILE_CAPACITY   1024U
+//dossiers en attente gardés ouverts pour openat, les autres sont rouverts par leur chemin.
+#define WALKER_OPEN_LIMIT      256U
+
+/* structures */
+/**
+ * device and inode of a folder.
+ */
+typedef struct WalkIdentity_t
+{
+    dev_t device;
+    ino_t inode;
+} WalkIdentity_t;
+
+/**
+ * a folder waiting to be read.
+ */
+typedef struct WalkFolder_t
+{
+    char* path_p;
+    int descriptor;            //ouvert depuis son parent, -1: par son chemin.
+    WalkIdentity_t* parents_p; //du dossier racine au parent: un lien vers l'un d'eux boucle.
+    size_t depth;
+} WalkFolder_t;
+
+/**
+ * folders of one thread: the owner pushes and pops at the tail, depth
+ * first, the other threads steal the oldest, widest folders at the head.
+ */
+typedef struct WalkDeque_t
+{
+    WalkFolder_t* folders_p;
+    size_t head;
+    size_t count;
+    size_t capacity;
+    pthread_mutex_t mutex;
+} WalkDeque_t;
+
+typedef struct WalkWorker_t
+{
+    struct Walker_t* walker_p;
+    size_t index;
+    pthread_t thread;
+    WalkDeque_t deque;
+    char** paths_pp;           //fichiers trouvés par ce fil.
+    size_t path_count;
+    size_t path_capacity;
+    uint32_t folder_count;
+    uint32_t steal_count;
+    uint32_t error_count;
+} WalkWorker_t;
+
+/**
+ * walks a tree with several threads. the files found come out sorted by
+ * path, whatever the threads did.
+ */
+typedef struct Walker_t
+{
+    const char* const* extensions_pp;  //terminé par NULL, NULL: tous les fichiers.
+    WalkWorker_t* workers_p;
+    size_t worker_count;
+    size_t pending_count;      //dossiers en attente ou en lecture.
+    size_t open_count;
+    //les fils sans dossier attendent un ajout ou la fin.
+    pthread_mutex_t idle_mutex;
+    pthread_cond_t idle_condition;
+    uint64_t push_count;
+    char** paths_pp;
+    size_t path_count;
+    uint32_t folder_count;
+    uint32_t steal_count;
+    uint32_t error_count;      //dossiers illisibles.
+} Walker_t;
+
+/* functions */
+/**
+ * finds the files of root_p and of its sub folders, hidden ones excepted,
+ * whose extension is one of extensions_pp, case ignored. symbolic links
+ * are followed, except those to a folder being walked.
+ * returns 0, or -1 if root_p can't be read.
+ */
+int walker_walk(Walker_t* walker_p,
+                const char* root_p,
+                size_t thread_count,
+                const char* const* extensions_pp);
+
+void walker_free(Walker_t* walker_p);
+
+#endif /* HEADERS_WALKER_H_ */
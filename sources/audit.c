@@ -0,0 +1,370 @@
+/*
+ * audit.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "audit.h"
+
+#ifndef OLIDX_AUDIT
+
+int audit_is_enabled(void)
+{
+    return 0;
+}
+
+AuditStatistics_t audit_get_statistics(void)
+{
+    AuditStatistics_t statistics = {0, 0, 0, 0};
+    return statistics;
+}
+
+void audit_report(FILE* file_p)
+{
+    fprintf(file_p, "allocation audit: not built in, see make audit\n");
+}
+
+#else
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+#define AUDIT_INITIAL_CAPACITY 1024U
+
+/*
+ * the linker sends the allocations of olidx here (-Wl,--wrap=malloc...),
+ * the C library keeps its own. one state for the whole process: the
+ * allocator itself is global.
+ */
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer_p, size_t size);
+char* __real_strdup(const char* text_p);
+void  __real_free(void* pointer_p);
+
+typedef struct AuditBlock_t
+{
+    void* pointer_p;           //NULL: case libre.
+    size_t size;
+    AuditSite_t* site_p;
+} AuditBlock_t;
+
+typedef struct AuditState_t
+{
+    pthread_mutex_t mutex;
+    AuditBlock_t* blocks_p;    //adressage ouvert, sondage linéaire.
+    size_t block_capacity;
+    size_t block_count;
+    AuditSite_t sites[AUDIT_SITE_CAPACITY + 1];        //le dernier reçoit les sites en trop.
+    size_t site_count;
+    AuditStatistics_t statistics;
+} AuditState_t;
+
+static AuditState_t audit_state = {PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0, {{0}}, 0, {0, 0, 0, 0}};
+
+static size_t audit_hash(const void* pointer_p)
+{
+    uint64_t value = (uintptr_t) pointer_p;
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    return value;
+}
+
+static AuditSite_t* audit_get_site(const void* caller_p)
+{
+    size_t mask = AUDIT_SITE_CAPACITY - 1;
+    for(size_t probe = 0, slot = audit_hash(caller_p) & mask; probe < AUDIT_SITE_CAPACITY; ++probe, slot = (slot + 1) & mask)
+    {
+        AuditSite_t* site_p = audit_state.sites + slot;
+        if(site_p->caller_p == caller_p)
+        {
+            return site_p;
+        }
+        if(site_p->caller_p == NULL)
+        {
+            site_p->caller_p = caller_p;
+            ++audit_state.site_count;
+            return site_p;
+        }
+    }
+    return audit_state.sites + AUDIT_SITE_CAPACITY;
+}
+
+static void audit_insert_block(const AuditBlock_t* block_p)
+{
+    size_t mask = audit_state.block_capacity - 1;
+    size_t slot = audit_hash(block_p->pointer_p) & mask;
+    while(audit_state.blocks_p[slot].pointer_p != NULL)
+    {
+        slot = (slot + 1) & mask;
+    }
+    audit_state.blocks_p[slot] = *block_p;
+}
+
+static void audit_grow(void)
+{
+    AuditBlock_t* old_blocks_p = audit_state.blocks_p;
+    size_t old_capacity = audit_state.block_capacity;
+    audit_state.block_capacity = old_capacity ? 2 * old_capacity : AUDIT_INITIAL_CAPACITY;
+    audit_state.blocks_p = __real_calloc(audit_state.block_capacity, sizeof(AuditBlock_t));
+    for(size_t slot = 0; slot < old_capacity; ++slot)
+    {
+        if(old_blocks_p[slot].pointer_p != NULL)
+        {
+            audit_insert_block(old_blocks_p + slot);
+        }
+    }
+    __real_free(old_blocks_p);
+}
+
+static void audit_track(void* pointer_p, size_t size, const void* caller_p)
+{
+    if(2 * (audit_state.block_count + 1) > audit_state.block_capacity)
+    {
+        audit_grow();
+    }
+    AuditBlock_t block = {pointer_p, size, audit_get_site(caller_p)};
+    audit_insert_block(&block);
+    ++audit_state.block_count;
+    block.site_p->live_bytes += size;
+    ++block.site_p->live_count;
+    ++block.site_p->allocation_count;
+    AuditStatistics_t* statistics_p = &audit_state.statistics;
+    statistics_p->live_bytes += size;
+    ++statistics_p->live_count;
+    ++statistics_p->allocation_count;
+    if(statistics_p->live_bytes > statistics_p->peak_bytes)
+    {
+        statistics_p->peak_bytes = statistics_p->live_bytes;
+    }
+}
+
+/*
+ * blocks allocated inside the C library, strdup or open_memstream, are
+ * freed here without having been tracked: they are ignored.
+ */
+static void audit_untrack(void* pointer_p)
+{
+    if(audit_state.block_capacity == 0)
+    {
+        return;
+    }
+    size_t mask = audit_state.block_capacity - 1;
+    size_t slot = audit_hash(pointer_p) & mask;
+    while(audit_state.blocks_p[slot].pointer_p != pointer_p)
+    {
+        if(audit_state.blocks_p[slot].pointer_p == NULL)
+        {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    AuditBlock_t* block_p = audit_state.blocks_p + slot;
+    block_p->site_p->live_bytes -= block_p->size;
+    --block_p->site_p->live_count;
+    audit_state.statistics.live_bytes -= block_p->size;
+    --audit_state.statistics.live_count;
+    --audit_state.block_count;
+    //les blocs suivants de la chaîne reculent dans la case libérée.
+    size_t hole = slot;
+    for(slot = (slot + 1) & mask; audit_state.blocks_p[slot].pointer_p != NULL; slot = (slot + 1) & mask)
+    {
+        size_t home = audit_hash(audit_state.blocks_p[slot].pointer_p) & mask;
+        if(((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            audit_state.blocks_p[hole] = audit_state.blocks_p[slot];
+            hole = slot;
+        }
+    }
+    audit_state.blocks_p[hole].pointer_p = NULL;
+}
+
+void* __wrap_malloc(size_t size)
+{
+    void* pointer_p = __real_malloc(size);
+    if(pointer_p != NULL)
+    {
+        pthread_mutex_lock(&audit_state.mutex);
+        audit_track(pointer_p, size, __builtin_return_address(0));
+        pthread_mutex_unlock(&audit_state.mutex);
+    }
+    return pointer_p;
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+    void* pointer_p = __real_calloc(count, size);
+    if(pointer_p != NULL)
+    {
+        pthread_mutex_lock(&audit_state.mutex);
+        audit_track(pointer_p, count * size, __builtin_return_address(0));
+        pthread_mutex_unlock(&audit_state.mutex);
+    }
+    return pointer_p;
+}
+
+void* __wrap_realloc(void* pointer_p, size_t size)
+{
+    pthread_mutex_lock(&audit_state.mutex);
+    void* new_pointer_p = __real_realloc(pointer_p, size);
+    //en cas d'échec, l'ancien bloc reste valide et suivi.
+    if(new_pointer_p != NULL || size == 0)
+    {
+        if(pointer_p != NULL)
+        {
+            audit_untrack(pointer_p);
+        }
+        if(new_pointer_p != NULL)
+        {
+            audit_track(new_pointer_p, size, __builtin_return_address(0));
+        }
+    }
+    pthread_mutex_unlock(&audit_state.mutex);
+    return new_pointer_p;
+}
+
+char* __wrap_strdup(const char* text_p)
+{
+    char* copy_p = __real_strdup(text_p);
+    if(copy_p != NULL)
+    {
+        pthread_mutex_lock(&audit_state.mutex);
+        audit_track(copy_p, strlen(copy_p) + 1, __builtin_return_address(0));
+        pthread_mutex_unlock(&audit_state.mutex);
+    }
+    return copy_p;
+}
+
+void __wrap_free(void* pointer_p)
+{
+    if(pointer_p == NULL)
+    {
+        return;
+    }
+    //retiré avant d'être libéré: l'adresse ne peut pas déjà resservir.
+    pthread_mutex_lock(&audit_state.mutex);
+    audit_untrack(pointer_p);
+    pthread_mutex_unlock(&audit_state.mutex);
+    __real_free(pointer_p);
+}
+
+int audit_is_enabled(void)
+{
+    return 1;
+}
+
+AuditStatistics_t audit_get_statistics(void)
+{
+    pthread_mutex_lock(&audit_state.mutex);
+    AuditStatistics_t statistics = audit_state.statistics;
+    pthread_mutex_unlock(&audit_state.mutex);
+    return statistics;
+}
+
+static void audit_print_site(FILE* file_p, const AuditSite_t* site_p)
+{
+    Dl_info info;
+    fprintf(file_p, "  %10llu B %8llu live %10llu allocations  ",
+            (unsigned long long) site_p->live_bytes,
+            (unsigned long long) site_p->live_count,
+            (unsigned long long) site_p->allocation_count);
+    if(site_p == audit_state.sites + AUDIT_SITE_CAPACITY)
+    {
+        fprintf(file_p, "other sites\n");
+        return;
+    }
+    //adresse relative au module, pour addr2line -e <module>.
+    if(dladdr(site_p->caller_p, &info) && info.dli_fname != NULL)
+    {
+        //les fonctions statiques n'ont pas de symbole dynamique.
+        if(info.dli_sname != NULL)
+        {
+            fprintf(file_p, "%s+0x%lx ",
+                    info.dli_sname,
+                    (unsigned long) ((const char*) site_p->caller_p - (const char*) info.dli_saddr));
+        }
+        fprintf(file_p, "(%s+0x%lx)\n",
+                info.dli_fname,
+                (unsigned long) ((const char*) site_p->caller_p - (const char*) info.dli_fbase));
+    }
+    else
+    {
+        fprintf(file_p, "%p\n", site_p->caller_p);
+    }
+}
+
+/*
+ * prints the count sites with the largest value, where value reads a field.
+ */
+static void audit_print_top(FILE* file_p, uint64_t (*value)(const AuditSite_t*), size_t count)
+{
+    uint8_t printed[AUDIT_SITE_CAPACITY + 1] = {0};
+    for(size_t line = 0; line < count; ++line)
+    {
+        const AuditSite_t* best_p = NULL;
+        for(size_t site = 0; site <= AUDIT_SITE_CAPACITY; ++site)
+        {
+            const AuditSite_t* site_p = audit_state.sites + site;
+            if(!printed[site] && value(site_p) > 0 && (best_p == NULL || value(site_p) > value(best_p)))
+            {
+                best_p = site_p;
+            }
+        }
+        if(best_p == NULL)
+        {
+            break;
+        }
+        printed[best_p - audit_state.sites] = 1;
+        audit_print_site(file_p, best_p);
+    }
+}
+
+static uint64_t audit_site_live_bytes(const AuditSite_t* site_p)
+{
+    return site_p->live_bytes;
+}
+
+static uint64_t audit_site_allocation_count(const AuditSite_t* site_p)
+{
+    return site_p->allocation_count;
+}
+
+void audit_report(FILE* file_p)
+{
+    pthread_mutex_lock(&audit_state.mutex);
+    const AuditStatistics_t* statistics_p = &audit_state.statistics;
+    fprintf(file_p, "allocation audit: %llu B live in %llu blocks, %llu B peak, %llu allocations from %zu sites\n",
+            (unsigned long long) statistics_p->live_bytes,
+            (unsigned long long) statistics_p->live_count,
+            (unsigned long long) statistics_p->peak_bytes,
+            (unsigned long long) statistics_p->allocation_count,
+            audit_state.site_count);
+    if(statistics_p->live_count > 0)
+    {
+        fprintf(file_p, "live:\n");
+        audit_print_top(file_p, audit_site_live_bytes, AUDIT_REPORT_SITE_COUNT);
+    }
+    fprintf(file_p, "most allocations:\n");
+    audit_print_top(file_p, audit_site_allocation_count, AUDIT_REPORT_SITE_COUNT);
+    pthread_mutex_unlock(&audit_state.mutex);
+}
+
+__attribute__((destructor))
+static void audit_exit(void)
+{
+    audit_report(stderr);
+    if(audit_get_statistics().live_count > 0)
+    {
+        fflush(NULL);
+        _exit(AUDIT_LEAK_EXIT_STATUS);
+    }
+}
+
+#endif /* OLIDX_AUDIT */
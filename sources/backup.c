@@ -0,0 +1,233 @@
+/*
+ * backup.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "backup.h"
+#include "engine.h"
+#include "help.h"
+
+static int backup_options(int argc, char* argv[], BackupOptions_t* options_p)
+{
+    int opt;
+    optind = 1;
+    while(-1 != (opt = getopt(argc, argv, ":c:d:g:hi:p:r:u:")))
+    {
+        switch(opt)
+        {
+            case 'c':
+                options_p->pacing.chunk_size = atoi(optarg);
+            break;
+            case 'd':
+                options_p->kind = transport_get_kind(optarg);
+                if(options_p->kind == TRANSPORT_KIND_COUNT)
+                {
+                    printf("unknown transport: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'g':
+                options_p->pacing.gap_ms = atoi(optarg);
+            break;
+            case 'h':
+                printf("%s", get_help());
+            break;
+            case 'i':
+            {
+                int device = atoi(optarg);
+                if(device < 1 || device > 16)
+                {
+                    printf("invalid device number: %s\n", optarg);
+                    return -1;
+                }
+                options_p->device = device - 1;
+            }
+            break;
+            case 'p':
+                if(options_p->port_count == TRANSPORT_PORT_COUNT)
+                {
+                    printf("can't have more than %u ports\n", TRANSPORT_PORT_COUNT);
+                    return -1;
+                }
+                options_p->ports[options_p->port_count++] = optarg;
+            break;
+            case 'r':
+                options_p->pacing.bytes_per_ms = atof(optarg);
+            break;
+            case 'u':
+                options_p->folder_p = optarg;
+            break;
+            case ':':
+                printf("error %c\n", optopt);
+                return -1;
+            default:
+                printf("unknown option %c\n", optopt);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static void backup_reply_handler(const uint8_t* payload_p, size_t length, void* user_p)
+{
+    BackupUnit_t* unit_p = user_p;
+    BackupReply_t* reply_p = malloc(sizeof(BackupReply_t));
+    reply_p->unit_p = unit_p;
+    reply_p->payload_p = malloc(length);
+    memcpy(reply_p->payload_p, payload_p, length);
+    reply_p->length = length;
+    pipeline_queue_push(unit_p->queue_p, reply_p);
+}
+
+static void* backup_unit_thread(void* argument_p)
+{
+    BackupUnit_t* unit_p = argument_p;
+    const BackupOptions_t* options_p = unit_p->options_p;
+    Transport_t transport;
+    unit_p->statistics = CAPTURE_STATISTICS_INITIALISER;
+    unit_p->result = -1;
+    if(transport_open(&transport, options_p->kind, unit_p->output_p, unit_p->input_p, &options_p->pacing) == 0)
+    {
+        unit_p->result = capture_device(&transport,
+                                        options_p->device,
+                                        CAPTURE_REQUEST_TABLE,
+                                        CAPTURE_REQUEST_COUNT,
+                                        backup_reply_handler,
+                                        unit_p,
+                                        &unit_p->statistics);
+        transport_close(&transport);
+    }
+    //fin de l'unité.
+    BackupReply_t* end_p = malloc(sizeof(BackupReply_t));
+    end_p->unit_p = unit_p;
+    end_p->payload_p = NULL;
+    end_p->length = 0;
+    pipeline_queue_push(unit_p->queue_p, end_p);
+    return NULL;
+}
+
+/*
+ * decodes the replies as they come, named after the output port of
+ * their unit.
+ */
+static void backup_decode(olidx_engine_t* engine_p, PipelineQueue_t* queue_p, size_t unit_count)
+{
+    size_t finished_count = 0;
+    while(finished_count < unit_count)
+    {
+        BackupReply_t* reply_p = pipeline_queue_pop(queue_p);
+        BackupUnit_t* unit_p = reply_p->unit_p;
+        if(reply_p->payload_p == NULL)
+        {
+            ++finished_count;
+        }
+        else
+        {
+            engine_p->file_root_p = unit_p->output_p;
+            engine_p->file_number = ++unit_p->file_number;
+            ScannedMessage_t message = {reply_p->payload_p, reply_p->length, 0, 1, SYSEX_CHECK_VALID, 0};
+            process_message(engine_p, &message);
+            free(reply_p->payload_p);
+        }
+        free(reply_p);
+    }
+}
+
+int run_backup(int argc, char* argv[])
+{
+    BackupOptions_t options = {TRANSPORT_FILE, TRANSPORT_PACING_INITIALISER, {NULL}, 0, 0, NULL};
+    if(backup_options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    if(options.port_count == 0 || options.folder_p == NULL)
+    {
+        printf("backup needs -p <port> and -u <folder>\n");
+        return EXIT_FAILURE;
+    }
+    PathBuilder_t folder;
+    path_init(&folder, options.folder_p);
+    path_append(&folder, "/");
+    if(path_get(&folder) == NULL)
+    {
+        printf("folder name too long: %s\n", options.folder_p);
+        return EXIT_FAILURE;
+    }
+    mkdir(options.folder_p, S_IRWXU | S_IRWXG | S_IRWXO);
+
+    PathTemplate_t voice_template;
+    path_compile_template(&voice_template, PATH_VOICE_TEMPLATE);
+    olidx_engine_t olidx_engine = OLIDX_ENGINE_INITIALISER;
+    olidx_engine.unpack = 1;
+    olidx_engine.unpack_folder_p = path_get(&folder);
+    olidx_engine.validation_report = VALIDATION_REPORT_INITIALISER;
+    olidx_engine.tuning_format = TUNING_FILE_COUNT;
+    olidx_engine.log_p = stdout;
+    olidx_engine.voice_template_p = &voice_template;
+    olidx_engine.input_number = 1;
+    subscribe_engine(&olidx_engine);
+    Manifest_t manifest;
+    if(manifest_open(&manifest, olidx_engine.unpack_folder_p))
+    {
+        printf("can't write manifest in: %s\n", olidx_engine.unpack_folder_p);
+        return EXIT_FAILURE;
+    }
+    olidx_engine.manifest_p = &manifest;
+    NameIndex_t name_index;
+    open_name_index(&olidx_engine, &name_index);
+
+    PipelineQueue_t queue;
+    pipeline_queue_init(&queue);
+    BackupUnit_t* units_p = calloc(options.port_count, sizeof(BackupUnit_t));
+    size_t started_count = 0;
+    for(size_t unit = 0; unit < options.port_count; ++unit)
+    {
+        BackupUnit_t* unit_p = units_p + unit;
+        unit_p->options_p = &options;
+        unit_p->queue_p = &queue;
+        unit_p->output_p = strdup(options.ports[unit]);
+        unit_p->input_p = transport_split_port(unit_p->output_p);
+        unit_p->started = (pthread_create(&unit_p->thread, NULL, backup_unit_thread, unit_p) == 0);
+        unit_p->result = -1;
+        started_count += unit_p->started;
+    }
+    backup_decode(&olidx_engine, &queue, started_count);
+
+    int result = EXIT_SUCCESS;
+    for(size_t unit = 0; unit < options.port_count; ++unit)
+    {
+        BackupUnit_t* unit_p = units_p + unit;
+        if(unit_p->started)
+        {
+            pthread_join(unit_p->thread, NULL);
+        }
+        printf("%s: %u/%u requests answered, %u messages, %lluB%s\n",
+               unit_p->output_p,
+               unit_p->statistics.answered_count,
+               unit_p->statistics.request_count,
+               unit_p->statistics.reply_count,
+               (unsigned long long) unit_p->statistics.byte_count,
+               unit_p->result ? ", failed" : "");
+        if(unit_p->result)
+        {
+            result = EXIT_FAILURE;
+        }
+        free(unit_p->output_p);
+    }
+    free(units_p);
+    pipeline_queue_destroy(&queue);
+    close_name_index(&olidx_engine);
+    if(close_manifest(&olidx_engine))
+    {
+        result = EXIT_FAILURE;
+    }
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+ * capture.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include "capture.h"
+
+const DumpRequest_t CAPTURE_REQUEST_TABLE[CAPTURE_REQUEST_COUNT] =
+{
+    {BULK_DATA_VOICE_EDIT_BUFFER,      UNIVERSAL_BULK_DATA_ERROR},
+    {BULK_DATA_SUPPLEMENT_EDIT_BUFFER, UNIVERSAL_BULK_DATA_ERROR},
+    {BULK_DATA_PACKED_32_VOICE,        UNIVERSAL_BULK_DATA_ERROR},
+    {BULK_DATA_PACKED_32_SUPPLEMENT,   UNIVERSAL_BULK_DATA_ERROR},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PERFORMANCE_EDIT_BUFFER},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PACKED_32_PERFORMANCE},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_SYSTEM_SET_UP},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_0},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_1},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_CARTRIDGE}
+};
+
+const CaptureStatistics_t CAPTURE_STATISTICS_INITIALISER = {0, 0, 0, 0};
+
+uint8_t* capture_format_request(const DumpRequest_t* request_p, uint8_t device, size_t* length_p)
+{
+    SysExData_t sysex_data;
+    sysex_data.type = SYSEX_TYPE_DUMP_REQUEST;
+    sysex_data.dump_request = *request_p;
+    return dx7_format_sysex(&sysex_data, length_p, device);
+}
+
+int capture_device(Transport_t* transport_p,
+                   uint8_t device,
+                   const DumpRequest_t* requests_p,
+                   size_t request_count,
+                   CaptureHandler_t handler,
+                   void* user_p,
+                   CaptureStatistics_t* statistics_p)
+{
+    for(size_t request = 0; request < request_count; ++request)
+    {
+        size_t length;
+        uint8_t* request_payload_p = capture_format_request(requests_p + request, device, &length);
+        int result = transport_send_sysex(transport_p, request_payload_p, length);
+        free(request_payload_p);
+        if(result)
+        {
+            return -1;
+        }
+        ++statistics_p->request_count;
+        //une cartouche peut répondre en plusieurs messages: on lit jusqu'au silence.
+        int timeout_ms = CAPTURE_FIRST_REPLY_MS;
+        uint8_t* reply_p;
+        while((result = transport_receive_sysex(transport_p, &reply_p, &length, timeout_ms)) > 0)
+        {
+            statistics_p->answered_count += (timeout_ms == CAPTURE_FIRST_REPLY_MS);
+            ++statistics_p->reply_count;
+            statistics_p->byte_count += length;
+            handler(reply_p, length, user_p);
+            free(reply_p);
+            timeout_ms = CAPTURE_NEXT_REPLY_MS;
+        }
+        if(result < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
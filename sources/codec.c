@@ -0,0 +1,312 @@
+/*
+ * codec.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "codec.h"
+
+#define ROLAND_MODEL_SIZE   4U     //octets de modèle au plus, préfixes 00 compris.
+#define ROLAND_HEADER_SIZE  4U     //41, appareil, modèle, commande.
+#define KORG_HEADER_SIZE    4U     //42, 3n, modèle, fonction.
+#define KORG_FORMAT_ID   0x30U
+#define KORG_FORMAT_MASK 0xF0U
+
+typedef enum RolandCommand_t
+{
+    ROLAND_COMMAND_RQ1 = 0x11,
+    ROLAND_COMMAND_DT1 = 0x12,
+    ROLAND_COMMAND_WSD = 0x40,
+    ROLAND_COMMAND_RQD = 0x41,
+    ROLAND_COMMAND_DAT = 0x42,
+    ROLAND_COMMAND_ACK = 0x43,
+    ROLAND_COMMAND_EOD = 0x45,
+    ROLAND_COMMAND_ERR = 0x4E,
+    ROLAND_COMMAND_RJC = 0x4F
+} RolandCommand_t;
+
+const char* const MIDI_MANUFACTURER_NAME_TABLE[CODEC_MANUFACTURER_COUNT] =
+{
+    [0x01]                   = "Sequential",
+    [0x04]                   = "Moog",
+    [0x06]                   = "Lexicon",
+    [0x07]                   = "Kurzweil",
+    [0x0F]                   = "Ensoniq",
+    [0x10]                   = "Oberheim",
+    [0x18]                   = "E-mu",
+    [0x40]                   = "Kawai",
+    [MIDI_ID_ROLAND]         = "Roland",
+    [MIDI_ID_KORG]           = "Korg",
+    [MIDI_ID_YAMAHA]         = "Yamaha",
+    [0x44]                   = "Casio",
+    [MIDI_ID_NON_COMMERCIAL] = "Non commercial",
+    [MIDI_ID_NON_REAL_TIME]  = "Universal non real time",
+    [MIDI_ID_REAL_TIME]      = "Universal real time"
+};
+
+static const CodecName_t ROLAND_MODEL_TABLE[] =
+{
+    {0x14, "D-50"},
+    {0x16, "MT-32"},
+    {0x42, "GS"},
+    {0x6A, "JV-1080"},
+    {0, NULL}
+};
+
+static const CodecName_t ROLAND_COMMAND_TABLE[] =
+{
+    {ROLAND_COMMAND_RQ1, "RQ1 data request"},
+    {ROLAND_COMMAND_DT1, "DT1 data set"},
+    {ROLAND_COMMAND_WSD, "WSD want to send data"},
+    {ROLAND_COMMAND_RQD, "RQD request data"},
+    {ROLAND_COMMAND_DAT, "DAT data set"},
+    {ROLAND_COMMAND_ACK, "ACK acknowledge"},
+    {ROLAND_COMMAND_EOD, "EOD end of data"},
+    {ROLAND_COMMAND_ERR, "ERR communication error"},
+    {ROLAND_COMMAND_RJC, "RJC rejection"},
+    {0, NULL}
+};
+
+static const CodecName_t KORG_MODEL_TABLE[] =
+{
+    {0x03, "DW-8000"},
+    {0x19, "M1"},
+    {0x26, "T series"},
+    {0x28, "Wavestation"},
+    {0x2B, "01/W"},
+    {0, NULL}
+};
+
+static const CodecName_t KORG_FUNCTION_TABLE[] =
+{
+    {0x0F, "All data dump request"},
+    {0x10, "Program dump request"},
+    {0x1C, "All programs dump request"},
+    {0x21, "Write completed"},
+    {0x22, "Write error"},
+    {0x23, "Data load completed"},
+    {0x24, "Data load error"},
+    {0x40, "Program dump"},
+    {0x41, "Parameter change"},
+    {0x4C, "All programs dump"},
+    {0x50, "All data dump"},
+    {0, NULL}
+};
+
+const SysexIdentity_t SYSEX_IDENTITY_INITIALISER =
+{
+    NULL,
+    0,
+    CODEC_UNKNOWN_MODEL,
+    0,
+    NULL,
+    NULL,
+    SYSEX_CHECK_NOT_BULK
+};
+
+static const char* codec_get_name(const CodecName_t* table_p, uint32_t id)
+{
+    for(; table_p->name_p != NULL; ++table_p)
+    {
+        if(table_p->id == id)
+        {
+            return table_p->name_p;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * claims what dx7_classify_sysex recognises, damaged dumps included:
+ * the engine checks and salvages them.
+ */
+static int codec_identify_dx7(const uint8_t* payload_p, size_t length, SysexIdentity_t* identity_p)
+{
+    SysexClass_t sysex_class = dx7_classify_sysex(payload_p, length);
+    if(sysex_class.type == SYSEX_TYPE_COUNT
+    || (sysex_class.type != SYSEX_TYPE_PARAMETER && sysex_class.format == BULK_DATA_MALFORMED))
+    {
+        return 0;
+    }
+    identity_p->device = sysex_class.device;
+    identity_p->model_name_p = "DX7";
+    switch(sysex_class.type)
+    {
+        case SYSEX_TYPE_BULK:
+            identity_p->model = BULK_DATA_FORMAT_TABLE[sysex_class.format];
+            identity_p->kind_name_p = (sysex_class.universal != UNIVERSAL_BULK_DATA_ERROR)
+                                    ? UNIVERSAL_BULK_DATA_NAME_TABLE[sysex_class.universal]
+                                    : BULK_DATA_FORMAT_NAME_TABLE[sysex_class.format];
+            identity_p->check = dx7_check_sysex(payload_p, length, NULL);
+        break;
+        default:
+            identity_p->kind_name_p = SYSEX_TYPE_NAME_TABLE[sysex_class.type];
+        break;
+    }
+    return 1;
+}
+
+/*
+ * 41 [appareil] [modèle, préfixé de 00 s'il est long] [commande] [adresse, données] [somme]
+ */
+static int codec_identify_roland(const uint8_t* payload_p, size_t length, SysexIdentity_t* identity_p)
+{
+    if(length < ROLAND_HEADER_SIZE)
+    {
+        return 0;
+    }
+    size_t position = 2;
+    uint32_t model = 0;
+    do
+    {
+        model = (model << 8) | payload_p[position];
+    } while(payload_p[position++] == 0x00 && position < length && position < 2 + ROLAND_MODEL_SIZE);
+    if(position >= length)
+    {
+        return 0;
+    }
+    uint8_t command = payload_p[position++];
+    identity_p->device = payload_p[1];
+    identity_p->model = model;
+    identity_p->model_name_p = codec_get_name(ROLAND_MODEL_TABLE, model);
+    identity_p->kind_name_p = codec_get_name(ROLAND_COMMAND_TABLE, command);
+    if(command == ROLAND_COMMAND_DT1 || command == ROLAND_COMMAND_DAT)
+    {
+        //adresse, données et somme totalisent 0 modulo 128.
+        unsigned sum = 0;
+        for(; position < length; ++position)
+        {
+            sum += payload_p[position];
+        }
+        identity_p->check = (sum & MIDI_DATA_MASK) ? SYSEX_CHECK_CHECKSUM : SYSEX_CHECK_VALID;
+    }
+    return 1;
+}
+
+/*
+ * 42 [3n] [modèle] [fonction] ...
+ */
+static int codec_identify_korg(const uint8_t* payload_p, size_t length, SysexIdentity_t* identity_p)
+{
+    if(length < KORG_HEADER_SIZE || (payload_p[1] & KORG_FORMAT_MASK) != KORG_FORMAT_ID)
+    {
+        return 0;
+    }
+    identity_p->device = payload_p[1] & ~KORG_FORMAT_MASK;
+    identity_p->model = payload_p[2];
+    identity_p->model_name_p = codec_get_name(KORG_MODEL_TABLE, payload_p[2]);
+    identity_p->kind_name_p = codec_get_name(KORG_FUNCTION_TABLE, payload_p[3]);
+    return 1;
+}
+
+const SysexCodec_t DX7_CODEC    = {"dx7",    MIDI_ID_YAMAHA, codec_identify_dx7};
+const SysexCodec_t ROLAND_CODEC = {"roland", MIDI_ID_ROLAND, codec_identify_roland};
+const SysexCodec_t KORG_CODEC   = {"korg",   MIDI_ID_KORG,   codec_identify_korg};
+
+static size_t codec_get_slot(uint32_t manufacturer)
+{
+    return (manufacturer & CODEC_EXTENDED_ID) ? MIDI_ID_EXTENDED : (manufacturer & MIDI_DATA_MASK);
+}
+
+void codec_registry_init(CodecRegistry_t* registry_p)
+{
+    registry_p->codec_count = 0;
+    memset(registry_p->first, -1, sizeof(registry_p->first));
+    codec_register(registry_p, &DX7_CODEC);
+    codec_register(registry_p, &ROLAND_CODEC);
+    codec_register(registry_p, &KORG_CODEC);
+}
+
+int codec_register(CodecRegistry_t* registry_p, const SysexCodec_t* codec_p)
+{
+    if(registry_p->codec_count >= CODEC_CAPACITY)
+    {
+        return -1;
+    }
+    int8_t index = registry_p->codec_count++;
+    registry_p->codecs[index] = codec_p;
+    registry_p->next[index] = -1;
+    int8_t* link_p = registry_p->first + codec_get_slot(codec_p->manufacturer);
+    while(*link_p >= 0)
+    {
+        link_p = registry_p->next + *link_p;
+    }
+    *link_p = index;
+    return 0;
+}
+
+uint32_t codec_get_manufacturer(const uint8_t* payload_p, size_t length, size_t* id_length_p)
+{
+    *id_length_p = 0;
+    if(length < 1)
+    {
+        return 0;
+    }
+    if(payload_p[0] != MIDI_ID_EXTENDED)
+    {
+        *id_length_p = 1;
+        return payload_p[0];
+    }
+    if(length < 3)
+    {
+        return 0;
+    }
+    *id_length_p = 3;
+    return CODEC_EXTENDED_ID | (payload_p[1] << 8) | payload_p[2];
+}
+
+const char* codec_get_manufacturer_name(uint32_t manufacturer)
+{
+    return (manufacturer & CODEC_EXTENDED_ID) ? NULL : MIDI_MANUFACTURER_NAME_TABLE[manufacturer & MIDI_DATA_MASK];
+}
+
+SysexIdentity_t codec_identify(const CodecRegistry_t* registry_p, const uint8_t* payload_p, size_t length)
+{
+    SysexIdentity_t identity = SYSEX_IDENTITY_INITIALISER;
+    size_t id_length;
+    identity.manufacturer = codec_get_manufacturer(payload_p, length, &id_length);
+    if(id_length == 0)
+    {
+        return identity;
+    }
+    for(int8_t index = registry_p->first[codec_get_slot(identity.manufacturer)];
+        index >= 0;
+        index = registry_p->next[index])
+    {
+        const SysexCodec_t* codec_p = registry_p->codecs[index];
+        SysexIdentity_t candidate = identity;
+        if(codec_p->manufacturer == identity.manufacturer
+        && codec_p->identify(payload_p, length, &candidate))
+        {
+            candidate.codec_p = codec_p;
+            return candidate;
+        }
+    }
+    return identity;
+}
+
+void codec_print_identity(FILE* file_p, const SysexIdentity_t* identity_p)
+{
+    const char* manufacturer_name_p = codec_get_manufacturer_name(identity_p->manufacturer);
+    fprintf(file_p, "Manufacturer: %s (%#x)\n",
+            manufacturer_name_p ? manufacturer_name_p : "unknown",
+            identity_p->manufacturer & ~CODEC_EXTENDED_ID);
+    if(identity_p->codec_p == NULL)
+    {
+        fprintf(file_p, "Codec:        none\n");
+        return;
+    }
+    fprintf(file_p, "Codec:        %s\n", identity_p->codec_p->name_p);
+    fprintf(file_p, "Model:        %s (%#x)\n",
+            identity_p->model_name_p ? identity_p->model_name_p : "unknown",
+            identity_p->model);
+    fprintf(file_p, "Message:      %s\n", identity_p->kind_name_p ? identity_p->kind_name_p : "unknown");
+    fprintf(file_p, "Device number:%4u\n", identity_p->device + 1);
+    if(identity_p->check != SYSEX_CHECK_NOT_BULK)
+    {
+        fprintf(file_p, "checksum: %s\n", SYSEX_CHECK_NAME_TABLE[identity_p->check]);
+    }
+}
@@ -0,0 +1,309 @@
+/*
+ * convert.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "convert.h"
+#include "help.h"
+#include "midi.h"
+#include "scanner.h"
+#include "smf.h"
+#include "walker.h"
+
+static const struct option CONVERT_LONG_OPTION_TABLE[] =
+{
+    {"to", required_argument, NULL, 't'},
+    {NULL, 0, NULL, 0}
+};
+
+static int convert_options(int argc, char* argv[], ConvertOptions_t* options_p)
+{
+    int opt;
+    optind = 1;
+    while(-1 != (opt = getopt_long(argc, argv, ":hi:j:m:r:t:u:", CONVERT_LONG_OPTION_TABLE, NULL)))
+    {
+        switch(opt)
+        {
+            case 'h':
+                printf("%s", get_help());
+            break;
+            case 'i':
+            {
+                int device = atoi(optarg);
+                if(device < 1 || device > 16)
+                {
+                    printf("invalid device number: %s\n", optarg);
+                    return -1;
+                }
+                options_p->device = device - 1;
+            }
+            break;
+            case 'j':
+                options_p->thread_count = atoi(optarg);
+                if(options_p->thread_count < 1)
+                {
+                    printf("invalid thread count: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'm':
+                options_p->smf_gap_ms = atoi(optarg);
+                if(options_p->smf_gap_ms < 0)
+                {
+                    printf("invalid gap: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'r':
+                options_p->validation = dx7_get_validation_mode(optarg);
+                if(options_p->validation == VALIDATION_MODE_COUNT)
+                {
+                    printf("unknown validation mode: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 't':
+                options_p->format = converter_get_format(optarg);
+                if(options_p->format == CONVERT_FORMAT_COUNT)
+                {
+                    printf("unknown format: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'u':
+                options_p->folder_p = optarg;
+            break;
+            case ':':
+                printf("error %c\n", optopt);
+                return -1;
+            default:
+                printf("unknown option %c\n", optopt);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static void convert_add_file(ConvertJob_t* job_p, const char* path_p, size_t relative_offset)
+{
+    if(job_p->file_count == job_p->file_capacity)
+    {
+        job_p->file_capacity = job_p->file_capacity ? 2 * job_p->file_capacity : CONVERT_FILE_CAPACITY;
+        job_p->files_p = realloc(job_p->files_p, job_p->file_capacity * sizeof(ConvertFile_t));
+    }
+    ConvertFile_t* file_p = job_p->files_p + job_p->file_count++;
+    file_p->input_p = strdup(path_p);
+    file_p->relative_offset = relative_offset;
+    file_p->output_p = NULL;
+    file_p->statistics = CONVERT_STATISTICS_INITIALISER;
+    file_p->result = 0;
+}
+
+/*
+ * adds the .syx and .mid files of a folder and of its sub folders, walked
+ * in parallel and sorted by path, their path relative to the folder kept
+ * for the output.
+ */
+static int convert_add_folder(ConvertJob_t* job_p, const char* folder_p, size_t thread_count)
+{
+    const char* const extensions[] = {MIDI_SYSEX_EXTENSION, SMF_EXTENSION, NULL};
+    Walker_t walker;
+    if(walker_walk(&walker, folder_p, thread_count, extensions))
+    {
+        return -1;
+    }
+    for(size_t path = 0; path < walker.path_count; ++path)
+    {
+        convert_add_file(job_p, walker.paths_pp[path], strlen(folder_p) + 1);
+    }
+    walker_free(&walker);
+    return 0;
+}
+
+/*
+ * <folder>/<relative path without extension>_<format>.syx, or .mid
+ */
+static char* convert_output_name(const ConvertOptions_t* options_p, const ConvertFile_t* file_p)
+{
+    PathBuilder_t path;
+    path_init(&path, options_p->folder_p);
+    if(options_p->folder_p != NULL)
+    {
+        path_append(&path, "/");
+    }
+    path_append_relative_root(&path, file_p->input_p + file_p->relative_offset);
+    path_append(&path, "_");
+    path_append(&path, CONVERT_FORMAT_TABLE[options_p->format].name_p);
+    path_append(&path, (options_p->smf_gap_ms < 0) ? MIDI_SYSEX_EXTENSION : SMF_EXTENSION);
+    const char* output_p = path_get(&path);
+    return (output_p != NULL) ? strdup(output_p) : NULL;
+}
+
+static int convert_file(Converter_t* converter_p, const ConvertOptions_t* options_p, ConvertFile_t* file_p)
+{
+    SysexScanner_t scanner;
+    if(scanner_open_file(&scanner, file_p->input_p, 0))
+    {
+        return -1;
+    }
+    file_p->output_p = convert_output_name(options_p, file_p);
+    FILE* output_file_p = (file_p->output_p != NULL) ? path_open(file_p->output_p, "wb") : NULL;
+    if(output_file_p == NULL)
+    {
+        scanner_close(&scanner);
+        return -1;
+    }
+    SmfWriter_t smf;
+    SmfWriter_t* smf_p = NULL;
+    int result = 0;
+    if(options_p->smf_gap_ms >= 0)
+    {
+        smf_p = &smf;
+        result = smf_writer_open(smf_p, output_file_p, options_p->smf_gap_ms);
+    }
+    converter_start(converter_p, output_file_p, smf_p);
+    ScannedMessage_t message;
+    while(result == 0 && scanner_next(&scanner, &message))
+    {
+        //les messages d'une autre nature sont comptés et passés.
+        if(converter_convert(converter_p, message.payload_p, message.length)
+        && ferror(output_file_p))
+        {
+            result = -1;
+        }
+    }
+    if(result == 0)
+    {
+        result = converter_finish(converter_p);
+    }
+    if(result == 0 && smf_p != NULL)
+    {
+        result = smf_writer_close(smf_p);
+    }
+    scanner_close(&scanner);
+    if(fclose(output_file_p))
+    {
+        result = -1;
+    }
+    file_p->statistics = converter_p->statistics;
+    if(file_p->statistics.written_count == 0)
+    {
+        unlink(file_p->output_p);
+    }
+    return result;
+}
+
+static void* convert_thread(void* argument_p)
+{
+    ConvertJob_t* job_p = argument_p;
+    Converter_t converter;
+    converter_init(&converter, job_p->options_p->format, job_p->options_p->device, job_p->options_p->validation);
+    size_t file;
+    while((file = __atomic_fetch_add(&job_p->next_file, 1, __ATOMIC_RELAXED)) < job_p->file_count)
+    {
+        ConvertFile_t* file_p = job_p->files_p + file;
+        file_p->result = convert_file(&converter, job_p->options_p, file_p);
+    }
+    converter_free(&converter);
+    return NULL;
+}
+
+int run_converter(int argc, char* argv[])
+{
+    ConvertOptions_t options = {CONVERT_FORMAT_COUNT, 0, 1, NULL, -1, VALIDATION_OFF};
+    if(convert_options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    if(options.format == CONVERT_FORMAT_COUNT || optind == argc)
+    {
+        printf("convert needs --to <format> and files or folders\n");
+        return EXIT_FAILURE;
+    }
+    ConvertJob_t job = {&options, NULL, 0, 0, 0};
+    for(int argument = optind; argument < argc; ++argument)
+    {
+        struct stat path_stat;
+        if(stat(argv[argument], &path_stat))
+        {
+            printf("can't open file: %s\n", argv[argument]);
+            continue;
+        }
+        if(S_ISDIR(path_stat.st_mode))
+        {
+            convert_add_folder(&job, argv[argument], options.thread_count);
+        }
+        else
+        {
+            convert_add_file(&job, argv[argument], path_to_file_name(argv[argument]) - argv[argument]);
+        }
+    }
+    int thread_count = (options.thread_count < (int) job.file_count) ? options.thread_count : (int) job.file_count;
+    pthread_t* threads_p = malloc((thread_count + 1) * sizeof(pthread_t));
+    int started_count = 0;
+    for(int thread = 1; thread < thread_count; ++thread)
+    {
+        started_count += (pthread_create(threads_p + started_count, NULL, convert_thread, &job) == 0);
+    }
+    convert_thread(&job);
+    for(int thread = 0; thread < started_count; ++thread)
+    {
+        pthread_join(threads_p[thread], NULL);
+    }
+    free(threads_p);
+
+    //compte rendu dans l'ordre des entrées.
+    int result = EXIT_SUCCESS;
+    ConvertStatistics_t total = CONVERT_STATISTICS_INITIALISER;
+    for(size_t file = 0; file < job.file_count; ++file)
+    {
+        ConvertFile_t* file_p = job.files_p + file;
+        const ConvertStatistics_t* statistics_p = &file_p->statistics;
+        if(file_p->result)
+        {
+            printf("%s: can't convert\n", file_p->input_p);
+            result = EXIT_FAILURE;
+        }
+        else if(statistics_p->written_count == 0)
+        {
+            printf("%s: nothing to convert\n", file_p->input_p);
+        }
+        else
+        {
+            printf("%s -> %s: %u records, %u messages, %u padded, %u skipped",
+                   file_p->input_p,
+                   file_p->output_p,
+                   statistics_p->record_count,
+                   statistics_p->written_count,
+                   statistics_p->padded_count,
+                   statistics_p->skipped_count);
+            if(options.validation != VALIDATION_OFF)
+            {
+                printf(", %u invalid voices", statistics_p->invalid_count);
+            }
+            printf("\n");
+        }
+        total.message_count += statistics_p->message_count;
+        total.record_count += statistics_p->record_count;
+        total.written_count += statistics_p->written_count;
+        free(file_p->input_p);
+        free(file_p->output_p);
+    }
+    printf("%zu files, %u messages read, %u records, %u messages written\n",
+           job.file_count,
+           total.message_count,
+           total.record_count,
+           total.written_count);
+    free(job.files_p);
+    return result;
+}
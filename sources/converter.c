@@ -0,0 +1,264 @@
+/*
+ * converter.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "converter.h"
+
+//F0 [43 0n] [format] [compte] ... [checksum] F7
+#define CONVERT_DATA_OFFSET (sizeof(uint8_t) + SYSEX_HEADER_SIZE + BULK_HEADER_SIZE + sizeof(TwoByte_t))
+#define CONVERT_FRAME_SIZE  (CONVERT_DATA_OFFSET + 2 * sizeof(uint8_t))
+
+const ConvertFormatEntry_t CONVERT_FORMAT_TABLE[CONVERT_FORMAT_COUNT] =
+{
+    {"vced", CONVERT_KIND_VOICE,       BULK_DATA_VOICE_EDIT_BUFFER,      UNIVERSAL_BULK_DATA_ERROR,
+     sizeof(VoiceParameters_t), 1, 0},
+    {"vmem", CONVERT_KIND_VOICE,       BULK_DATA_PACKED_32_VOICE,        UNIVERSAL_BULK_DATA_ERROR,
+     sizeof(PackedVoiceParameters_t), VOICE_COUNT, 1},
+    {"aced", CONVERT_KIND_SUPPLEMENT,  BULK_DATA_SUPPLEMENT_EDIT_BUFFER, UNIVERSAL_BULK_DATA_ERROR,
+     sizeof(SupplementVoiceParameters_t), 1, 0},
+    {"amem", CONVERT_KIND_SUPPLEMENT,  BULK_DATA_PACKED_32_SUPPLEMENT,   UNIVERSAL_BULK_DATA_ERROR,
+     sizeof(PackedSupplementVoiceParameters_t), VOICE_COUNT, 1},
+    {"pced", CONVERT_KIND_PERFORMANCE, BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PERFORMANCE_EDIT_BUFFER,
+     sizeof(PerformanceParameters_t), 1, 0},
+    {"pmem", CONVERT_KIND_PERFORMANCE, BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PACKED_32_PERFORMANCE,
+     sizeof(PerformanceParameters_t), PERFORMANCE_COUNT, 0}
+};
+
+const ConvertStatistics_t CONVERT_STATISTICS_INITIALISER = {0, 0, 0, 0, 0, 0};
+
+ConvertFormat_t converter_get_format(const char* name_p)
+{
+    ConvertFormat_t format;
+    for(format = 0; format < CONVERT_FORMAT_COUNT; ++format)
+    {
+        if(strcmp(name_p, CONVERT_FORMAT_TABLE[format].name_p) == 0)
+        {
+            break;
+        }
+    }
+    return format;
+}
+
+ConvertFormat_t converter_get_message_format(const uint8_t* payload_p, size_t length)
+{
+    //le classement écarte les autres messages avant tout calcul de checksum.
+    SysexClass_t sysex_class = dx7_classify_sysex(payload_p, length);
+    if(sysex_class.type != SYSEX_TYPE_BULK
+    || sysex_class.expected_length != length
+    || dx7_check_sysex(payload_p, length, NULL) != SYSEX_CHECK_VALID)
+    {
+        return CONVERT_FORMAT_COUNT;
+    }
+    ConvertFormat_t format;
+    for(format = 0; format < CONVERT_FORMAT_COUNT; ++format)
+    {
+        if(CONVERT_FORMAT_TABLE[format].bulk == sysex_class.format
+        && CONVERT_FORMAT_TABLE[format].universal == sysex_class.universal)
+        {
+            break;
+        }
+    }
+    return format;
+}
+
+/*
+ * length of the records of a message, universal header included.
+ */
+static size_t converter_get_data_size(const ConvertFormatEntry_t* format_p)
+{
+    size_t header_size = (format_p->universal != UNIVERSAL_BULK_DATA_ERROR) ? sizeof(UniversalBulkDataHeader_t) : 0;
+    return header_size + format_p->record_size * format_p->record_count;
+}
+
+void converter_init(Converter_t* converter_p, ConvertFormat_t output, uint8_t device, ValidationMode_t validation)
+{
+    converter_p->output_p = CONVERT_FORMAT_TABLE + output;
+    converter_p->device = device & 0x0F;
+    converter_p->validation = validation;
+    converter_p->file_p = NULL;
+    converter_p->buffer_size = CONVERT_FRAME_SIZE + converter_get_data_size(converter_p->output_p);
+    converter_p->buffer_p = malloc(converter_p->buffer_size);
+    converter_p->records_p = converter_p->buffer_p + CONVERT_DATA_OFFSET;
+    //les en-têtes ne changent pas d'un message à l'autre.
+    SysexHeader_t header = SYSEX_HEADER_INITIALISER_YAMAHA;
+    header.device = converter_p->device;
+    uint8_t* head_p = converter_p->buffer_p;
+    *head_p++ = MIDI_SYSTEM_EXCLUSIVE;
+    head_p += dx7_encode_sysex_header(&header, head_p);
+    *head_p++ = BULK_DATA_FORMAT_TABLE[converter_p->output_p->bulk];
+    *(TwoByte_t*) head_p = format_payload_size(converter_get_data_size(converter_p->output_p));
+    if(converter_p->output_p->universal != UNIVERSAL_BULK_DATA_ERROR)
+    {
+        memcpy(converter_p->records_p,
+               UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME,
+               UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
+        memcpy(converter_p->records_p + UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE,
+               UNIVERSAL_BULK_DATA_FORMAT_TABLE[converter_p->output_p->universal],
+               UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+        converter_p->records_p += sizeof(UniversalBulkDataHeader_t);
+    }
+    converter_p->buffer_p[converter_p->buffer_size - 1] = MIDI_EOX;
+    converter_p->record_count = 0;
+    converter_p->statistics = CONVERT_STATISTICS_INITIALISER;
+}
+
+void converter_free(Converter_t* converter_p)
+{
+    free(converter_p->buffer_p);
+    converter_p->buffer_p = NULL;
+    converter_p->records_p = NULL;
+}
+
+void converter_start(Converter_t* converter_p, FILE* file_p, SmfWriter_t* smf_p)
+{
+    converter_p->file_p = file_p;
+    converter_p->smf_p = smf_p;
+    converter_p->record_count = 0;
+    converter_p->statistics = CONVERT_STATISTICS_INITIALISER;
+}
+
+/*
+ * writes the message once its records are in place.
+ */
+static int converter_write(Converter_t* converter_p)
+{
+    size_t data_size = converter_get_data_size(converter_p->output_p);
+    const uint8_t* data_p = converter_p->buffer_p + CONVERT_DATA_OFFSET;
+    converter_p->buffer_p[CONVERT_DATA_OFFSET + data_size] = generate_checksum(data_p, data_size);
+    converter_p->record_count = 0;
+    ++converter_p->statistics.written_count;
+    if(converter_p->smf_p != NULL)
+    {
+        return smf_write_sysex(converter_p->smf_p, converter_p->buffer_p, converter_p->buffer_size);
+    }
+    if(fwrite(converter_p->buffer_p, converter_p->buffer_size, 1, converter_p->file_p) != 1)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * converts a record between the packed and unpacked formats of its kind.
+ */
+static void converter_convert_record(const ConvertFormatEntry_t* input_p,
+                                     const ConvertFormatEntry_t* output_p,
+                                     const uint8_t* record_p,
+                                     uint8_t* converted_p)
+{
+    if(input_p->packed == output_p->packed)
+    {
+        memcpy(converted_p, record_p, output_p->record_size);
+        return;
+    }
+    switch(input_p->kind)
+    {
+        case CONVERT_KIND_VOICE:
+            if(input_p->packed)
+            {
+                *(VoiceParameters_t*) converted_p = dx7_decode_packed_voice(record_p);
+            }
+            else
+            {
+                *(PackedVoiceParameters_t*) converted_p = dx7_pack_voice_parameters(*(const VoiceParameters_t*) record_p);
+            }
+        break;
+        case CONVERT_KIND_SUPPLEMENT:
+            if(input_p->packed)
+            {
+                *(SupplementVoiceParameters_t*) converted_p = dx7_decode_packed_supplement(record_p);
+            }
+            else
+            {
+                *(PackedSupplementVoiceParameters_t*) converted_p =
+                    dx7_pack_supplement_parameters(*(const SupplementVoiceParameters_t*) record_p);
+            }
+        break;
+        default:
+            memcpy(converted_p, record_p, output_p->record_size);
+        break;
+    }
+}
+
+/*
+ * validates a voice record, packed or not.
+ */
+static void converter_validate_record(Converter_t* converter_p, int packed, uint8_t* record_p)
+{
+    converter_p->statistics.invalid_count += packed
+        ? dx7_validate_packed_voices((PackedVoiceParameters_t*) record_p, 1, converter_p->validation, NULL)
+        : dx7_validate_voices((VoiceParameters_t*) record_p, 1, converter_p->validation, NULL);
+}
+
+int converter_convert(Converter_t* converter_p, const uint8_t* payload_p, size_t length)
+{
+    const ConvertFormatEntry_t* output_p = converter_p->output_p;
+    ++converter_p->statistics.message_count;
+    ConvertFormat_t format = converter_get_message_format(payload_p, length);
+    if(format == CONVERT_FORMAT_COUNT || CONVERT_FORMAT_TABLE[format].kind != output_p->kind)
+    {
+        ++converter_p->statistics.skipped_count;
+        return -1;
+    }
+    const ConvertFormatEntry_t* input_p = CONVERT_FORMAT_TABLE + format;
+    const uint8_t* record_p = payload_p + CONVERT_DATA_OFFSET - sizeof(uint8_t);
+    if(input_p->universal != UNIVERSAL_BULK_DATA_ERROR)
+    {
+        record_p += sizeof(UniversalBulkDataHeader_t);
+    }
+    for(size_t record = 0; record < input_p->record_count; ++record)
+    {
+        const uint8_t* source_p = record_p + record * input_p->record_size;
+        uint8_t* converted_p = converter_p->records_p + converter_p->record_count * output_p->record_size;
+        int validated = converter_p->validation != VALIDATION_OFF && input_p->kind == CONVERT_KIND_VOICE;
+        //une voix VCED est validée avant d'être compactée: un champ trop large y serait tronqué.
+        VoiceParameters_t voice;
+        if(validated && !input_p->packed)
+        {
+            memcpy(&voice, source_p, sizeof(VoiceParameters_t));
+            converter_validate_record(converter_p, 0, (uint8_t*) &voice);
+            source_p = (const uint8_t*) &voice;
+        }
+        converter_convert_record(input_p, output_p, source_p, converted_p);
+        if(validated && input_p->packed)
+        {
+            converter_validate_record(converter_p, output_p->packed, converted_p);
+        }
+        ++converter_p->statistics.record_count;
+        if(++converter_p->record_count == output_p->record_count && converter_write(converter_p))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int converter_finish(Converter_t* converter_p)
+{
+    const ConvertFormatEntry_t* output_p = converter_p->output_p;
+    if(converter_p->record_count == 0)
+    {
+        return 0;
+    }
+    //banque incomplète: le reste est initialisé.
+    PackedVoiceParameters_t initial_voice = dx7_pack_voice_parameters(VOICE_PARAMETERS_INITIALISER);
+    PackedSupplementVoiceParameters_t initial_supplement = dx7_pack_supplement_parameters(SUPPLEMENT_PARAMETERS_INITIALISER);
+    PerformanceParameters_t initial_performance = {{0}};
+    const void* initial_p = (output_p->kind == CONVERT_KIND_VOICE) ? (const void*) &initial_voice
+                          : (output_p->kind == CONVERT_KIND_SUPPLEMENT) ? (const void*) &initial_supplement
+                          : (const void*) &initial_performance;
+    while(converter_p->record_count < output_p->record_count)
+    {
+        memcpy(converter_p->records_p + converter_p->record_count * output_p->record_size,
+               initial_p,
+               output_p->record_size);
+        ++converter_p->record_count;
+        ++converter_p->statistics.padded_count;
+    }
+    return converter_write(converter_p);
+}
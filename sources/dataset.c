@@ -0,0 +1,272 @@
+/*
+ * dataset.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "dataset.h"
+#include "path.h"
+
+#define DATASET_MAGIC           "\x93NUMPY\x01\x00"
+//les flottants sont écrits dans l'ordre des octets de la machine.
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define DATASET_FLOAT_DESCRIPTOR ">f4"
+#else
+#define DATASET_FLOAT_DESCRIPTOR "<f4"
+#endif
+
+const char* const DATASET_TYPE_NAME_TABLE[DATASET_TYPE_COUNT] =
+{
+    "u8",
+    "f32"
+};
+
+//descripteurs NumPy.
+const char* const DATASET_DESCRIPTOR_TABLE[DATASET_TYPE_COUNT] =
+{
+    "|u1",
+    DATASET_FLOAT_DESCRIPTOR
+};
+
+static float DATASET_SCALE_TABLE[DATASET_COLUMN_COUNT];
+
+__attribute__((constructor))
+static void dataset_build_tables(void)
+{
+    for(int column = 0; column < DATASET_COLUMN_COUNT; ++column)
+    {
+        int range = VOICE_MAXIMUM_TABLE[column] - VOICE_MINIMUM_TABLE[column];
+        DATASET_SCALE_TABLE[column] = (range > 0) ? 1.0f / range : 0.0f;
+    }
+}
+
+DatasetType_t dataset_get_type(const char* name_p)
+{
+    DatasetType_t type;
+    for(type = 0; type < DATASET_TYPE_COUNT; ++type)
+    {
+        if(strcmp(name_p, DATASET_TYPE_NAME_TABLE[type]) == 0)
+        {
+            break;
+        }
+    }
+    return type;
+}
+
+void dataset_open(DatasetWriter_t* writer_p, const char* root_p, DatasetType_t type, uint64_t shard_rows)
+{
+    writer_p->type = type;
+    writer_p->root_p = strdup(root_p);
+    writer_p->shard_rows = shard_rows;
+    writer_p->file_p = NULL;
+    writer_p->shard_count = 0;
+    writer_p->shard_row_count = 0;
+    writer_p->row_count = 0;
+    writer_p->error = 0;
+    writer_p->manifest_p = NULL;
+    writer_p->rows_p = malloc(DATASET_ROW_BLOCK * DATASET_COLUMN_COUNT * sizeof(float));
+}
+
+/*
+ * the shape is padded with spaces so that the header keeps its size
+ * whatever the row count.
+ */
+static int dataset_write_header(FILE* file_p, DatasetType_t type, uint64_t row_count)
+{
+    char header[DATASET_HEADER_SIZE];
+    size_t magic_size = sizeof(DATASET_MAGIC) - 1;
+    memcpy(header, DATASET_MAGIC, magic_size);
+    uint16_t dictionary_size = DATASET_HEADER_SIZE - magic_size - sizeof(dictionary_size);
+    header[magic_size] = dictionary_size & 0xFF;
+    header[magic_size + 1] = dictionary_size >> 8;
+    char* dictionary_p = header + magic_size + sizeof(dictionary_size);
+    int length = snprintf(dictionary_p,
+                          dictionary_size,
+                          "{'descr': '%s', 'fortran_order': False, 'shape': (%llu, %d), }",
+                          DATASET_DESCRIPTOR_TABLE[type],
+                          (unsigned long long) row_count,
+                          DATASET_COLUMN_COUNT);
+    memset(dictionary_p + length, ' ', dictionary_size - length - 1);
+    dictionary_p[dictionary_size - 1] = '\n';
+    return fwrite(header, DATASET_HEADER_SIZE, 1, file_p) == 1 ? 0 : -1;
+}
+
+/*
+ * <root>.npy, or <root><shard>.npy once split.
+ */
+static const char* dataset_get_shard_name(const DatasetWriter_t* writer_p, uint32_t shard, PathBuilder_t* path_p)
+{
+    path_init(path_p, writer_p->root_p);
+    if(writer_p->shard_rows > 0)
+    {
+        path_append_counter(path_p, shard);
+    }
+    path_append(path_p, DATASET_EXTENSION);
+    return path_get(path_p);
+}
+
+static void dataset_close_shard(DatasetWriter_t* writer_p)
+{
+    if(writer_p->file_p == NULL)
+    {
+        return;
+    }
+    if(fseek(writer_p->file_p, 0, SEEK_SET)
+       || dataset_write_header(writer_p->file_p, writer_p->type, writer_p->shard_row_count))
+    {
+        writer_p->error = 1;
+    }
+    if(fclose(writer_p->file_p))
+    {
+        writer_p->error = 1;
+    }
+    writer_p->file_p = NULL;
+    PathBuilder_t path;
+    const char* file_name_p = dataset_get_shard_name(writer_p, writer_p->shard_count - 1, &path);
+    if(writer_p->manifest_p != NULL && file_name_p != NULL)
+    {
+        manifest_add_file(writer_p->manifest_p, file_name_p);
+    }
+}
+
+static int dataset_open_shard(DatasetWriter_t* writer_p)
+{
+    PathBuilder_t path;
+    const char* file_name_p = dataset_get_shard_name(writer_p, writer_p->shard_count, &path);
+    writer_p->file_p = (file_name_p != NULL) ? fopen(file_name_p, "wb") : NULL;
+    if(writer_p->file_p == NULL)
+    {
+        writer_p->error = 1;
+        return -1;
+    }
+    setvbuf(writer_p->file_p, NULL, _IOFBF, DATASET_BUFFER_SIZE);
+    ++writer_p->shard_count;
+    writer_p->shard_row_count = 0;
+    return dataset_write_header(writer_p->file_p, writer_p->type, 0);
+}
+
+/*
+ * rows are converted by blocks, so that each block is a single write.
+ */
+static size_t dataset_convert(DatasetType_t type, const VoiceParameters_t* voices_p, size_t voice_count, void* rows_p)
+{
+    if(type == DATASET_UINT8)
+    {
+        memcpy(rows_p, voices_p, voice_count * DATASET_COLUMN_COUNT);
+        return voice_count * DATASET_COLUMN_COUNT;
+    }
+    float* values_p = rows_p;
+    for(size_t voice = 0; voice < voice_count; ++voice)
+    {
+        const uint8_t* bytes_p = (const uint8_t*) (voices_p + voice);
+        for(int column = 0; column < DATASET_COLUMN_COUNT; ++column)
+        {
+            *values_p++ = (bytes_p[column] - VOICE_MINIMUM_TABLE[column]) * DATASET_SCALE_TABLE[column];
+        }
+    }
+    return voice_count * DATASET_COLUMN_COUNT * sizeof(float);
+}
+
+int dataset_add(DatasetWriter_t* writer_p, const VoiceParameters_t* voices_p, size_t voice_count)
+{
+    _Static_assert(sizeof(VoiceParameters_t) == DATASET_COLUMN_COUNT, "one byte per column");
+    while(voice_count > 0 && !writer_p->error)
+    {
+        if(writer_p->file_p == NULL && dataset_open_shard(writer_p))
+        {
+            break;
+        }
+        size_t count = (voice_count < DATASET_ROW_BLOCK) ? voice_count : DATASET_ROW_BLOCK;
+        if(writer_p->shard_rows > 0 && count > writer_p->shard_rows - writer_p->shard_row_count)
+        {
+            count = writer_p->shard_rows - writer_p->shard_row_count;
+        }
+        size_t length = dataset_convert(writer_p->type, voices_p, count, writer_p->rows_p);
+        if(fwrite(writer_p->rows_p, 1, length, writer_p->file_p) != length)
+        {
+            writer_p->error = 1;
+            break;
+        }
+        writer_p->shard_row_count += count;
+        writer_p->row_count += count;
+        voices_p += count;
+        voice_count -= count;
+        if(writer_p->shard_rows > 0 && writer_p->shard_row_count == writer_p->shard_rows)
+        {
+            dataset_close_shard(writer_p);
+        }
+    }
+    return writer_p->error ? -1 : 0;
+}
+
+void dataset_print_schema(FILE* file_p, const DatasetWriter_t* writer_p)
+{
+    fprintf(file_p, "{\n  \"dtype\": \"%s\",\n", DATASET_DESCRIPTOR_TABLE[writer_p->type]);
+    fprintf(file_p, "  \"normalized\": %s,\n", (writer_p->type == DATASET_FLOAT32) ? "true" : "false");
+    fprintf(file_p, "  \"rows\": %llu,\n", (unsigned long long) writer_p->row_count);
+    fprintf(file_p, "  \"shard_rows\": %llu,\n", (unsigned long long) writer_p->shard_rows);
+    fprintf(file_p, "  \"shards\": %u,\n", writer_p->shard_count);
+    fprintf(file_p, "  \"columns\": [\n");
+    int column = 0;
+    for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+    {
+        for(int field = 0; field < OPERATOR_FIELD_COUNT; ++field, ++column)
+        {
+            fprintf(file_p, "    {\"name\": \"operator_%d_%s\", \"minimum\": %u, \"maximum\": %u},\n",
+                    OPERATOR_COUNT - operator,
+                    OPERATOR_SCHEMA_TABLE[field].name,
+                    VOICE_MINIMUM_TABLE[column],
+                    VOICE_MAXIMUM_TABLE[column]);
+        }
+    }
+    for(int field = 0; field < VOICE_FIELD_COUNT; ++field, ++column)
+    {
+        fprintf(file_p, "    {\"name\": \"%s\", \"minimum\": %u, \"maximum\": %u},\n",
+                VOICE_SCHEMA_TABLE[field].name,
+                VOICE_MINIMUM_TABLE[column],
+                VOICE_MAXIMUM_TABLE[column]);
+    }
+    for(int character = 0; character < VOICE_NAME_SIZE; ++character, ++column)
+    {
+        fprintf(file_p, "    {\"name\": \"voice_name_%d\", \"minimum\": %u, \"maximum\": %u}%s\n",
+                character,
+                VOICE_MINIMUM_TABLE[column],
+                VOICE_MAXIMUM_TABLE[column],
+                (column + 1 < DATASET_COLUMN_COUNT) ? "," : "");
+    }
+    fprintf(file_p, "  ]\n}\n");
+}
+
+int dataset_close(DatasetWriter_t* writer_p)
+{
+    dataset_close_shard(writer_p);
+    PathBuilder_t path;
+    path_init(&path, writer_p->root_p);
+    path_append(&path, DATASET_SCHEMA_EXTENSION);
+    const char* schema_name_p = path_get(&path);
+    FILE* schema_file_p = (schema_name_p != NULL) ? fopen(schema_name_p, "w") : NULL;
+    if(schema_file_p == NULL)
+    {
+        writer_p->error = 1;
+    }
+    else
+    {
+        dataset_print_schema(schema_file_p, writer_p);
+        if(fclose(schema_file_p))
+        {
+            writer_p->error = 1;
+        }
+        else if(writer_p->manifest_p != NULL)
+        {
+            manifest_add_file(writer_p->manifest_p, schema_name_p);
+        }
+    }
+    free(writer_p->root_p);
+    writer_p->root_p = NULL;
+    free(writer_p->rows_p);
+    writer_p->rows_p = NULL;
+    return writer_p->error ? -1 : 0;
+}
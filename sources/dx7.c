@@ -5,6 +5,7 @@
  *      Author: moliver
  */
 
+#include <stddef.h>
 #include <string.h>
 #include <ctype.h>
 
@@ -16,7 +17,8 @@
 const char* const SYSEX_TYPE_NAME_TABLE[SYSEX_TYPE_COUNT] =
 {
     "Bulk data",
-    "Parameter"
+    "Parameter",
+    "Dump request"
 };
 
 const char* const BULK_DATA_FORMAT_NAME_TABLE[BULK_DATA_FORMAT_COUNT] =
@@ -58,6 +60,23 @@ const char* const UNIVERSAL_BULK_DATA_NAME_TABLE[UNIVERSAL_BULK_DATA_COUNT] =
     "Fractional scaling cartridge"
 };
 
+const char* const VALIDATION_MODE_NAME_TABLE[VALIDATION_MODE_COUNT] =
+{
+    "off",
+    "check",
+    "clamp",
+    "reset"
+};
+
+const char* const SYSEX_CHECK_NAME_TABLE[SYSEX_CHECK_COUNT] =
+{
+    "valid",
+    "not a bulk dump",
+    "truncated",
+    "too long",
+    "checksum error"
+};
+
 const ParameterChangeHeader_t PARAMETER_CHANGE_GROUP_TABLE[PARAMETER_CHANGE_COUNT] =
 {
     {1,0,28}, //PARAMETER_CHANGE_VOICE = 0,
@@ -113,6 +132,37 @@ const size_t UNIVERSAL_BULK_DATA_REPEAT_TABLE[UNIVERSAL_BULK_DATA_COUNT] =
     REPEAT_FRACTIONAL_SCALING_CARTRIDGE
 };
 
+const uint8_t BULK_DATA_LOOKUP_TABLE[BULK_DATA_LOOKUP_SIZE] =
+{
+    [0 ... BULK_DATA_LOOKUP_SIZE - 1]       = BULK_DATA_MALFORMED,
+    [BULK_DATA_FORMAT_VOICE_EDIT_BUFFER]      = BULK_DATA_VOICE_EDIT_BUFFER,
+    [BULK_DATA_FORMAT_SUPPLEMENT_EDIT_BUFFER] = BULK_DATA_SUPPLEMENT_EDIT_BUFFER,
+    [BULK_DATA_FORMAT_PACKED_32_SUPPLEMENT]   = BULK_DATA_PACKED_32_SUPPLEMENT,
+    [BULK_DATA_FORMAT_PACKED_32_VOICE]        = BULK_DATA_PACKED_32_VOICE,
+    [BULK_DATA_FORMAT_UNIVERSAL_BULK_DUMP]    = BULK_DATA_UNIVERSAL_BULK_DUMP
+};
+
+/*
+ * cases de dx7_hash_universal_tag, multiplicateur et repli trouvés par
+ * recherche sur les étiquettes de UNIVERSAL_BULK_DATA_FORMAT_TABLE.
+ */
+#define UNIVERSAL_BULK_DATA_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#define UNIVERSAL_BULK_DATA_HASH_FOLD       9U
+
+const int8_t UNIVERSAL_BULK_DATA_HASH_TABLE[UNIVERSAL_BULK_DATA_HASH_SIZE] =
+{
+    [0 ... UNIVERSAL_BULK_DATA_HASH_SIZE - 1] = UNIVERSAL_BULK_DATA_ERROR,
+    [ 6] = UNIVERSAL_BULK_DATA_PERFORMANCE_EDIT_BUFFER,        //8973PE
+    [11] = UNIVERSAL_BULK_DATA_PACKED_32_PERFORMANCE,          //8973PM
+    [10] = UNIVERSAL_BULK_DATA_SYSTEM_SET_UP,                  //8973S
+    [14] = UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER,       //MCRYE
+    [ 7] = UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_0,          //MCRYM0
+    [ 8] = UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_1,          //MCRYM1
+    [12] = UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE,         //MCRYC
+    [ 3] = UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER, //FKSYE
+    [ 0] = UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_CARTRIDGE    //FKSYC
+};
+
 const size_t PARAMETER_CHANGE_BYTE_COUNT_TABLE[PARAMETER_CHANGE_COUNT] =
 {
     SIZE_OF_FIELD(ParameterPayload_t, data), //PARAMETER_CHANGE_VOICE = 0,
@@ -123,6 +173,72 @@ const size_t PARAMETER_CHANGE_BYTE_COUNT_TABLE[PARAMETER_CHANGE_COUNT] =
     SIZE_OF_FIELD(ParameterPayload_t, data), //PARAMETER_CHANGE_SYSTEM_SET_UP,
 };
 
+#define SCHEMA_OPERATOR_ENTRY(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    {#FIELD, offsetof(OperatorParameters_t, FIELD), PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM},
+
+#define SCHEMA_VOICE_ENTRY(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    {#FIELD, offsetof(VoiceParameters_t, FIELD), PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM},
+
+const SchemaField_t OPERATOR_SCHEMA_TABLE[OPERATOR_FIELD_COUNT] =
+{
+    DX7_OPERATOR_SCHEMA(SCHEMA_OPERATOR_ENTRY)
+};
+
+const SchemaField_t VOICE_SCHEMA_TABLE[VOICE_FIELD_COUNT] =
+{
+    DX7_VOICE_SCHEMA(SCHEMA_VOICE_ENTRY)
+};
+
+#define SCHEMA_SUPPLEMENT_ENTRY(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    {#FIELD, offsetof(SupplementVoiceParameters_t, FIELD), PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM},
+
+const SchemaField_t SUPPLEMENT_SCHEMA_TABLE[SUPPLEMENT_FIELD_COUNT] =
+{
+    DX7_SUPPLEMENT_SCHEMA(SCHEMA_SUPPLEMENT_ENTRY)
+};
+
+#define SCHEMA_MINIMUM(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM) MINIMUM,
+#define SCHEMA_MAXIMUM(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM) MAXIMUM,
+#define SCHEMA_VOICE_TABLE(ENTRY, NAME_VALUE)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_OPERATOR_SCHEMA(ENTRY)\
+    DX7_VOICE_SCHEMA(ENTRY)\
+    NAME_VALUE, NAME_VALUE, NAME_VALUE, NAME_VALUE, NAME_VALUE,\
+    NAME_VALUE, NAME_VALUE, NAME_VALUE, NAME_VALUE, NAME_VALUE
+
+/* limites de chaque octet VCED, pour valider une voix d'un seul passage */
+const uint8_t VOICE_MINIMUM_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER] =
+{
+    SCHEMA_VOICE_TABLE(SCHEMA_MINIMUM, ' ')
+};
+
+const uint8_t VOICE_MAXIMUM_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER] =
+{
+    SCHEMA_VOICE_TABLE(SCHEMA_MAXIMUM, MIDI_DATA_MASK)
+};
+
+_Static_assert(VOICE_NAME_SIZE == 10, "SCHEMA_VOICE_TABLE lists ten name characters");
+
+//le numéro de paramètre VCED est la position de l'octet dans VoiceParameters_t.
+_Static_assert(sizeof(OperatorParameters_t) == OPERATOR_FIELD_COUNT,
+               "operator parameters must be one byte each");
+_Static_assert(sizeof(VoiceParameters_t) == BYTE_COUNT_VOICE_EDIT_BUFFER,
+               "voice parameters must match the VCED format");
+_Static_assert(sizeof(Packed32Voice_t) == BYTE_COUNT_PACKED_32_VOICE,
+               "packed voices must match the VMEM format");
+_Static_assert(sizeof(SupplementVoiceParameters_t) == BYTE_COUNT_SUPPLEMENT_EDIT_BUFFER,
+               "supplement parameters must match the ACED format");
+_Static_assert(sizeof(Packed32SupplementVoice_t) == BYTE_COUNT_PACKED_32_SUPPLEMENT,
+               "packed supplements must match the AMEM format");
+_Static_assert(sizeof(Packed32Performance_t) == BYTE_COUNT_PACKED_32_PERFORMANCE
+                                              - UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE
+                                              - UNIVERSAL_BULK_DATA_FORMAT_SIZE,
+               "packed performances must match the PMEM format");
+
 const SysexHeader_t SYSEX_HEADER_INITIALISER =
 {
     0,
@@ -156,6 +272,43 @@ const UniversalBulkDataHeader_t UNIVERSAL_BULK_HEADER_INITIALISER =
     {0}
 };
 
+#define INITIAL_OPERATOR(TOTAL_LEVEL)\
+    {99, 99, 99, 99, 99, 99, 99, 0, 39, 0, 0, 0, 0, 0, 0, 0, TOTAL_LEVEL, 0, 1, 0, 7}
+
+const VoiceParameters_t VOICE_PARAMETERS_INITIALISER =
+{
+    {
+        INITIAL_OPERATOR(0), //OPERATOR_6
+        INITIAL_OPERATOR(0),
+        INITIAL_OPERATOR(0),
+        INITIAL_OPERATOR(0),
+        INITIAL_OPERATOR(0),
+        INITIAL_OPERATOR(99) //OPERATOR_1
+    },
+    99, 99, 99, 99,
+    50, 50, 50, 50,
+    0, 0, 1,
+    35, 0, 0, 0, 1, 0, 3,
+    24,
+    {'I', 'N', 'I', 'T', ' ', 'V', 'O', 'I', 'C', 'E'}
+};
+
+//pitch bend de 2 demi-tons, biais des contrôleurs au centre.
+const SupplementVoiceParameters_t SUPPLEMENT_PARAMETERS_INITIALISER =
+{
+    .pitch_bend_range             = 2,
+    .breath_controller_pitch_bias = 50,
+    .aftertouch_pitch_bias        = 50
+};
+
+const ValidationReport_t VALIDATION_REPORT_INITIALISER =
+{
+    0,
+    0,
+    0,
+    {0}
+};
+
 const SysExData_t SYSEX_DATA_INITIALISER =
 {
     SYSEX_TYPE_BULK,
@@ -164,6 +317,15 @@ const SysExData_t SYSEX_DATA_INITIALISER =
     }
 };
 
+const SysexClass_t SYSEX_CLASS_INITIALISER =
+{
+    SYSEX_TYPE_COUNT,
+    0,
+    BULK_DATA_MALFORMED,
+    UNIVERSAL_BULK_DATA_ERROR,
+    0
+};
+
 uint8_t* dx7_format_sysex(const SysExData_t* sysex_data_p,
                           size_t* length_p,
                           uint8_t device_id)
@@ -175,10 +337,7 @@ uint8_t* dx7_format_sysex(const SysExData_t* sysex_data_p,
     SysexHeader_t header = SYSEX_HEADER_INITIALISER_YAMAHA;
     header.device = device_id;
 
-    BulkDataHeader_t bulk_header;
-    ParameterChangeHeader_t parameter_header;
-
-    void* header_data_p = NULL;
+    uint8_t header_data[PARAMETER_HEADER_SIZE];
     size_t header_data_length = 0;
     void* payload_p = NULL;
     size_t payload_length = 0;
@@ -186,38 +345,59 @@ uint8_t* dx7_format_sysex(const SysExData_t* sysex_data_p,
     switch(sysex_data_p->type)
     {
         case SYSEX_TYPE_BULK:
-            header_data_p = &bulk_header;
-            header_data_length = sizeof(BulkDataHeader_t);
             header.substatus = 0;
-            bulk_header.format = BULK_DATA_FORMAT_TABLE[sysex_data_p->bulk_data.type];
+            header_data[0] = BULK_DATA_FORMAT_TABLE[sysex_data_p->bulk_data.type];
+            header_data_length = BULK_HEADER_SIZE;
             payload_p = dx7_format_bulk_payload(&sysex_data_p->bulk_data,
                                                 &payload_length);
             break;
         case SYSEX_TYPE_PARAMETER:
-            parameter_header = dx7_get_parameter_header(&sysex_data_p->parameter_change);
+        {
+            ParameterChangeHeader_t parameter_header = dx7_get_parameter_header(&sysex_data_p->parameter_change);
+            header_data_length = dx7_encode_parameter_header(&parameter_header, header_data);
             payload_p = dx7_format_parameter_payload(&sysex_data_p->parameter_change,
                                                      &payload_length);
-            header_data_p = &parameter_header;
-            header_data_length = sizeof(ParameterChangeHeader_t);
-
-            //TODO: parameters.
             header.substatus = 1;
+        }
+        break;
+        case SYSEX_TYPE_DUMP_REQUEST:
+        {
+            const DumpRequest_t* request_p = &sysex_data_p->dump_request;
+            header.substatus = SYSEX_TYPE_DUMP_REQUEST;
+            header_data[0] = BULK_DATA_FORMAT_TABLE[request_p->format];
+            header_data_length = BULK_HEADER_SIZE;
+            if(request_p->format == BULK_DATA_UNIVERSAL_BULK_DUMP)
+            {
+                UniversalBulkDataHeader_t* universal_header_p = malloc(sizeof(UniversalBulkDataHeader_t));
+                memcpy(universal_header_p->classification,
+                       UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME,
+                       UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
+                memcpy(universal_header_p->format,
+                       UNIVERSAL_BULK_DATA_FORMAT_TABLE[request_p->universal],
+                       UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+                payload_p = universal_header_p;
+                payload_length = sizeof(UniversalBulkDataHeader_t);
+            }
+        }
         break;
         default:
         break;
     }
-    size_t sysex_message_length = sizeof(SysexHeader_t)
+    size_t sysex_message_length = SYSEX_HEADER_SIZE
                                 + header_data_length
                                 + payload_length;
     uint8_t* sysex_message_p = malloc(sysex_message_length);
 
-    *(SysexHeader_t*) sysex_message_p = header;
-    memcpy(sysex_message_p + sizeof(SysexHeader_t),
-           header_data_p,
+    dx7_encode_sysex_header(&header, sysex_message_p);
+    memcpy(sysex_message_p + SYSEX_HEADER_SIZE,
+           header_data,
            header_data_length);
-    memcpy(sysex_message_p + sizeof(SysexHeader_t) + header_data_length,
-           payload_p,
-           payload_length);
+    if(payload_length > 0)
+    {
+        memcpy(sysex_message_p + SYSEX_HEADER_SIZE + header_data_length,
+               payload_p,
+               payload_length);
+    }
     free(payload_p);
     if(length_p != NULL)
     {
@@ -228,24 +408,37 @@ uint8_t* dx7_format_sysex(const SysExData_t* sysex_data_p,
 
 SysExData_t* dx7_get_sysex(const uint8_t* payload_p, size_t length)
 {
-    const uint8_t* head_p = payload_p;
-    SysexHeader_t header;
-    header = *(SysexHeader_t*) head_p;
-    head_p += sizeof(SysexHeader_t);
     SysExData_t* data_p = malloc(sizeof(SysExData_t));
     *data_p = SYSEX_DATA_INITIALISER;
-    data_p->type = dx7_get_header(&header);
-    printf("Sysex type: %s\n", SYSEX_TYPE_NAME_TABLE[data_p->type]);
+    if(length < SYSEX_HEADER_SIZE)
+    {
+        return data_p;
+    }
+    const uint8_t* head_p = payload_p;
+    SysexHeader_t header = dx7_decode_sysex_header(head_p);
+    head_p += SYSEX_HEADER_SIZE;
+    length -= SYSEX_HEADER_SIZE;
+    SysexType_t type = dx7_get_header(&header);
+    if(header.id != MIDI_ID_YAMAHA || type >= SYSEX_TYPE_COUNT)
+    {
+        return data_p;
+    }
+    data_p->type = type;
     switch(data_p->type)
     {
         case SYSEX_TYPE_PARAMETER:
         {
-            data_p->parameter_change = dx7_get_sysex_parameter(head_p);
+            data_p->parameter_change = dx7_get_sysex_parameter(head_p, length);
         }
         break;
         case SYSEX_TYPE_BULK:
         {
-            data_p->bulk_data = dx7_get_sysex_bulk_data(head_p);
+            data_p->bulk_data = dx7_get_sysex_bulk_data(head_p, length);
+        }
+        break;
+        case SYSEX_TYPE_DUMP_REQUEST:
+        {
+            data_p->dump_request = dx7_get_dump_request(head_p, length);
         }
         break;
         default:
@@ -255,90 +448,434 @@ SysExData_t* dx7_get_sysex(const uint8_t* payload_p, size_t length)
 
 }
 
+SysexClass_t dx7_classify_sysex(const uint8_t* payload_p, size_t length)
+{
+    SysexClass_t sysex_class = SYSEX_CLASS_INITIALISER;
+    if(length < SYSEX_HEADER_SIZE || payload_p[0] != MIDI_ID_YAMAHA)
+    {
+        return sysex_class;
+    }
+    SysexHeader_t header = dx7_decode_sysex_header(payload_p);
+    SysexType_t type = dx7_get_header(&header);
+    if(type >= SYSEX_TYPE_COUNT)
+    {
+        return sysex_class;
+    }
+    sysex_class.type = type;
+    sysex_class.device = header.device;
+    const uint8_t* head_p = payload_p + SYSEX_HEADER_SIZE;
+    length -= SYSEX_HEADER_SIZE;
+    if(type == SYSEX_TYPE_PARAMETER)
+    {
+        ParameterPayload_t parameter = dx7_get_sysex_parameter(head_p, length);
+        if(parameter.parameter != PARAMETER_CHANGE_COUNT)
+        {
+            sysex_class.expected_length = SYSEX_HEADER_SIZE
+                                        + PARAMETER_HEADER_SIZE
+                                        + PARAMETER_CHANGE_BYTE_COUNT_TABLE[parameter.parameter];
+        }
+        return sysex_class;
+    }
+    if(length < BULK_HEADER_SIZE)
+    {
+        return sysex_class;
+    }
+    sysex_class.format = dx7_get_bulk_data_header((const BulkDataHeader_t*) head_p);
+    //les dumps ont un compte d'octets avant l'étiquette, les demandes non.
+    size_t count_size = (type == SYSEX_TYPE_BULK) ? sizeof(TwoByte_t) : 0;
+    size_t block_frame = count_size + ((type == SYSEX_TYPE_BULK) ? sizeof(uint8_t) : 0);
+    size_t byte_count;
+    size_t repeat_count = 1;
+    switch(sysex_class.format)
+    {
+        case BULK_DATA_MALFORMED:
+            return sysex_class;
+        case BULK_DATA_UNIVERSAL_BULK_DUMP:
+            if(length < BULK_HEADER_SIZE + count_size + sizeof(UniversalBulkDataHeader_t))
+            {
+                return sysex_class;
+            }
+            sysex_class.universal = dx7_get_universal_bulk_data_header(
+                    (const UniversalBulkDataHeader_t*) (head_p + BULK_HEADER_SIZE + count_size));
+            if(sysex_class.universal == UNIVERSAL_BULK_DATA_ERROR)
+            {
+                return sysex_class;
+            }
+            byte_count = UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[sysex_class.universal];
+            repeat_count = UNIVERSAL_BULK_DATA_REPEAT_TABLE[sysex_class.universal];
+            if(type == SYSEX_TYPE_DUMP_REQUEST)
+            {
+                byte_count = sizeof(UniversalBulkDataHeader_t);
+                repeat_count = 1;
+            }
+        break;
+        default:
+            byte_count = (type == SYSEX_TYPE_BULK) ? BULK_DATA_BYTE_COUNT_TABLE[sysex_class.format] : 0;
+        break;
+    }
+    sysex_class.expected_length = SYSEX_HEADER_SIZE
+                                + BULK_HEADER_SIZE
+                                + repeat_count * (block_frame + byte_count);
+    return sysex_class;
+}
+
+SysexCheck_t dx7_check_sysex(const uint8_t* payload_p,
+                             size_t length,
+                             size_t* valid_length_p)
+{
+    SysexCheck_t check = SYSEX_CHECK_VALID;
+    size_t position = SYSEX_HEADER_SIZE + BULK_HEADER_SIZE;
+    if(length < SYSEX_HEADER_SIZE
+    || payload_p[0] != MIDI_ID_YAMAHA
+    || dx7_decode_sysex_header(payload_p).substatus != SYSEX_TYPE_BULK)
+    {
+        check = SYSEX_CHECK_NOT_BULK;
+        position = length;
+    }
+    else if(length < position)
+    {
+        check = SYSEX_CHECK_TRUNCATED;
+        position = SYSEX_HEADER_SIZE;
+    }
+    else
+    {
+        int universal = payload_p[SYSEX_HEADER_SIZE] == BULK_DATA_FORMAT_UNIVERSAL_BULK_DUMP;
+        //les dumps universels enchaînent plusieurs blocs: [compte][données][checksum]...
+        do
+        {
+            if(length - position < sizeof(TwoByte_t))
+            {
+                check = SYSEX_CHECK_TRUNCATED;
+                break;
+            }
+            TwoByte_t byte_count = {payload_p[position], payload_p[position + 1]};
+            size_t count = get_payload_size(byte_count);
+            size_t block_length = sizeof(TwoByte_t) + count + sizeof(uint8_t);
+            if(length - position < block_length)
+            {
+                check = SYSEX_CHECK_TRUNCATED;
+                break;
+            }
+            if(!is_checksum_valid(payload_p + position + sizeof(TwoByte_t),
+                                  count,
+                                  payload_p[position + block_length - 1]))
+            {
+                check = SYSEX_CHECK_CHECKSUM;
+                break;
+            }
+            position += block_length;
+        } while(universal && position < length);
+        if(check == SYSEX_CHECK_VALID && position < length)
+        {
+            check = SYSEX_CHECK_TOO_LONG;
+        }
+    }
+    if(valid_length_p != NULL)
+    {
+        *valid_length_p = position;
+    }
+    return check;
+}
+
+uint8_t* dx7_salvage_packed32_voice(const uint8_t* payload_p,
+                                    size_t length,
+                                    size_t* salvaged_length_p,
+                                    int* voice_count_p)
+{
+    const size_t voices_offset = SYSEX_HEADER_SIZE + BULK_HEADER_SIZE + sizeof(TwoByte_t);
+    if(length < voices_offset
+    || payload_p[0] != MIDI_ID_YAMAHA
+    || payload_p[SYSEX_HEADER_SIZE] != BULK_DATA_FORMAT_PACKED_32_VOICE)
+    {
+        return NULL;
+    }
+    size_t available = (length - voices_offset) / PACKED_VOICE_SIZE;
+    available = (available > VOICE_COUNT) ? VOICE_COUNT : available;
+
+    Packed32Voice_t voices;
+    PackedVoiceParameters_t initial_voice = dx7_pack_voice_parameters(VOICE_PARAMETERS_INITIALISER);
+    int voice_count = 0;
+    for(size_t voice = 0; voice < VOICE_COUNT; ++voice)
+    {
+        const uint8_t* record_p = payload_p + voices_offset + voice * PACKED_VOICE_SIZE;
+        VoiceParameters_t parameters;
+        if(voice < available)
+        {
+            parameters = dx7_decode_packed_voice(record_p);
+        }
+        if(voice < available && dx7_validate_voice_parameters(&parameters) == 0)
+        {
+            memcpy(voices[voice].data, record_p, PACKED_VOICE_SIZE);
+            ++voice_count;
+        }
+        else
+        {
+            voices[voice] = initial_voice;
+        }
+    }
+
+    SysExData_t sysex_data;
+    sysex_data.type = SYSEX_TYPE_BULK;
+    sysex_data.bulk_data.type = BULK_DATA_PACKED_32_VOICE;
+    sysex_data.bulk_data.packed32_voice_p = &voices;
+    if(voice_count_p != NULL)
+    {
+        *voice_count_p = voice_count;
+    }
+    return dx7_format_sysex(&sysex_data,
+                            salvaged_length_p,
+                            dx7_decode_sysex_header(payload_p).device);
+}
+
+void dx7_free_sysex(SysExData_t* data_p)
+{
+    if(data_p == NULL)
+    {
+        return;
+    }
+    if(data_p->type == SYSEX_TYPE_BULK)
+    {
+        if(data_p->bulk_data.type == BULK_DATA_UNIVERSAL_BULK_DUMP)
+        {
+            free(data_p->bulk_data.universal.payload_p);
+        }
+        else
+        {
+            free(data_p->bulk_data.payload_p);
+        }
+    }
+    free(data_p);
+}
+
+void dx7_print_sysex(FILE* file_p,
+                     const uint8_t* payload_p,
+                     size_t length,
+                     const SysExData_t* data_p)
+{
+    if(length < SYSEX_HEADER_SIZE)
+    {
+        fprintf(file_p, "Sysex too short: %zuB\n", length);
+        return;
+    }
+    SysexHeader_t header = dx7_decode_sysex_header(payload_p);
+    fprintf(file_p, "Manufacturer: %#4x\n", header.id);
+    fprintf(file_p, "Substatus:    %#4x\n", header.substatus);
+    fprintf(file_p, "Device number:%4u\n",  header.device + 1);
+    switch(data_p->type)
+    {
+        case SYSEX_TYPE_PARAMETER:
+        {
+            const ParameterPayload_t* parameter_p = &data_p->parameter_change;
+            fprintf(file_p, "Sysex type: %s\n", SYSEX_TYPE_NAME_TABLE[data_p->type]);
+            if(parameter_p->parameter < PARAMETER_CHANGE_COUNT)
+            {
+                ParameterChangeHeader_t parameter_header = dx7_get_parameter_header(parameter_p);
+                fprintf(file_p,
+                        "Parameter group:   %01hhu,%01hhu\n"
+                        "Parameter number: %3hhu\n",
+                        parameter_header.group_g,
+                        parameter_header.group_h,
+                        parameter_header.parameter);
+            }
+            else
+            {
+                fprintf(file_p, "Parameter: unknown\n");
+            }
+        }
+        break;
+        case SYSEX_TYPE_DUMP_REQUEST:
+        {
+            const DumpRequest_t* request_p = &data_p->dump_request;
+            fprintf(file_p, "Sysex type: %s\n", SYSEX_TYPE_NAME_TABLE[data_p->type]);
+            fprintf(file_p, "%s\n", BULK_DATA_FORMAT_NAME_TABLE[request_p->format]);
+            if(request_p->format == BULK_DATA_UNIVERSAL_BULK_DUMP)
+            {
+                fprintf(file_p, "Universal: %s\n", UNIVERSAL_BULK_DATA_NAME_TABLE[request_p->universal]);
+            }
+        }
+        break;
+        case SYSEX_TYPE_BULK:
+        default:
+        {
+            const BulkDataPayload_t* bulk_data_p = &data_p->bulk_data;
+            fprintf(file_p, "Sysex type: %s\n", SYSEX_TYPE_NAME_TABLE[SYSEX_TYPE_BULK]);
+            fprintf(file_p, "%s\n", BULK_DATA_FORMAT_NAME_TABLE[bulk_data_p->type]);
+            if(bulk_data_p->type == BULK_DATA_MALFORMED)
+            {
+                break;
+            }
+            const uint8_t* count_p = payload_p + SYSEX_HEADER_SIZE + BULK_HEADER_SIZE;
+            TwoByte_t byte_count = {count_p[0], count_p[1]};
+            fprintf(file_p, "Payload size:   %huB\n", get_payload_size(byte_count));
+            if(bulk_data_p->type == BULK_DATA_PACKED_32_VOICE)
+            {
+                for(int voice = 0; voice < VOICE_COUNT; voice++)
+                {
+                    fprintf(file_p, "%3$2d: %1$.*2$s\n",
+                            (*bulk_data_p->packed32_voice_p)[voice].data + PACKED_VOICE_NAME_OFFSET,
+                            VOICE_NAME_SIZE, 1 + voice);
+                }
+            }
+            fprintf(file_p, "checksum: %s\n",
+                    SYSEX_CHECK_NAME_TABLE[dx7_check_sysex(payload_p, length, NULL)]);
+        }
+        break;
+    }
+}
+
+DumpRequest_t dx7_get_dump_request(const uint8_t* request_p, size_t length)
+{
+    DumpRequest_t request = {BULK_DATA_MALFORMED, UNIVERSAL_BULK_DATA_ERROR};
+    if(length < BULK_HEADER_SIZE)
+    {
+        return request;
+    }
+    BulkData_t format = dx7_get_bulk_data_header((const BulkDataHeader_t*) request_p);
+    if(format == BULK_DATA_UNIVERSAL_BULK_DUMP)
+    {
+        if(length < BULK_HEADER_SIZE + sizeof(UniversalBulkDataHeader_t))
+        {
+            return request;
+        }
+        request.universal = dx7_get_universal_bulk_data_header(
+                (const UniversalBulkDataHeader_t*) (request_p + BULK_HEADER_SIZE));
+        if(request.universal == UNIVERSAL_BULK_DATA_ERROR)
+        {
+            return request;
+        }
+    }
+    request.format = format;
+    return request;
+}
+
 static uint32_t dx7_get_key(ParameterChangeHeader_t header)
 {
     return (((header.group_g * 10) + header.group_h) * 1000) + header.parameter;
 }
 
-ParameterPayload_t dx7_get_sysex_parameter(const uint8_t* payload_p)
+ParameterPayload_t dx7_get_sysex_parameter(const uint8_t* payload_p, size_t length)
 {
+    ParameterPayload_t parameter;
+    parameter.parameter = PARAMETER_CHANGE_COUNT;
+    parameter.number = 0;
+    if(length < PARAMETER_HEADER_SIZE)
+    {
+        return parameter;
+    }
     const uint8_t* head_p = payload_p;
-    ParameterChangeHeader_t parameter_header = *(const ParameterChangeHeader_t*) (head_p);
-    head_p += sizeof(ParameterChangeHeader_t);
+    ParameterChangeHeader_t parameter_header = dx7_decode_parameter_header(head_p);
+    head_p += PARAMETER_HEADER_SIZE;
+    length -= PARAMETER_HEADER_SIZE;
     int parameter_type = PARAMETER_CHANGE_VOICE;
     uint32_t key = dx7_get_key(parameter_header);
-    ParameterPayload_t parameter;
-    parameter.parameter = PARAMETER_CHANGE_COUNT;
+    parameter.number = (parameter_header.group_h << MIDI_DATA_BITS) | parameter_header.parameter;
     for(;parameter_type<PARAMETER_CHANGE_COUNT;parameter_type++)
     {
         if(key <= dx7_get_key(PARAMETER_CHANGE_GROUP_TABLE[parameter_type]))
         {
+            if(length < PARAMETER_CHANGE_BYTE_COUNT_TABLE[parameter_type])
+            {
+                break;
+            }
             parameter.parameter = parameter_type;
             memcpy(&parameter.data, head_p, PARAMETER_CHANGE_BYTE_COUNT_TABLE[parameter_type]);
             break;
         }
     }
-    printf("Parameter group:   %01hhu,%01hhu\n"
-           "Parameter number: %3hhu\n"
-           "Key %05d\n",
-           parameter_header.group_g,
-           parameter_header.group_h,
-           parameter_header.parameter,
-           key);
-
     return parameter;
 }
 
 
-BulkDataPayload_t dx7_get_sysex_bulk_data(const uint8_t* payload_p)
+BulkDataPayload_t dx7_get_sysex_bulk_data(const uint8_t* payload_p, size_t length)
 {
-    BulkDataPayload_t bulk_data;
+    BulkDataPayload_t bulk_data = {BULK_DATA_MALFORMED, {NULL}};
+    //en-tête, compte d'octets et checksum doivent être présents avant toute lecture.
+    const size_t frame_length = BULK_HEADER_SIZE + sizeof(TwoByte_t) + sizeof(uint8_t);
+    if(length < frame_length)
+    {
+        return bulk_data;
+    }
 
     const uint8_t* head_p = payload_p;
     const BulkDataHeader_t* bulk_header_p = (const BulkDataHeader_t*) head_p;
-    head_p += sizeof(BulkDataHeader_t);
+    head_p += BULK_HEADER_SIZE;
 
-    bulk_data.type = dx7_get_bulk_data_header(bulk_header_p);
+    BulkData_t type = dx7_get_bulk_data_header(bulk_header_p);
 
     const TwoByte_t* byte_count_p = (const TwoByte_t*) (head_p);
     head_p += sizeof(TwoByte_t);
     uint16_t payload_size = get_payload_size(*byte_count_p);
-    printf("Payload size:   %huB\n", payload_size);
-
-    void* bulk_payload_p;
-    Packed32Voice_t voices;
-    if(bulk_data.type == BULK_DATA_PACKED_32_VOICE)
+    if(length - frame_length < payload_size)
     {
-        for(int voice = 0; voice < VOICE_COUNT; voice++)
-        {
-            voices[voice] = *(PackedVoiceParameters_t*) head_p;
-            head_p += sizeof(PackedVoiceParameters_t);
-            printf("%3$2d: %1$.*2$s\n", voices[voice].voice_name,
-            VOICE_NAME_SIZE, 1 + voice);
-        }
-        bulk_payload_p = voices;
+        return bulk_data;
     }
-    else
+    if(type == BULK_DATA_MALFORMED
+    || (type != BULK_DATA_UNIVERSAL_BULK_DUMP && payload_size != BULK_DATA_BYTE_COUNT_TABLE[type]))
     {
-        bulk_payload_p = malloc(payload_size);
-        memcpy(bulk_payload_p, head_p, payload_size);
-        head_p += payload_size;
+        return bulk_data;
     }
-    bulk_data.payload_p = malloc(payload_size);
-    memcpy(bulk_data.payload_p, bulk_payload_p, payload_size);
-
-    int checksum = get_checksum(bulk_payload_p, payload_size);
-    int byte = *((uint8_t*) head_p);
-    ++head_p;
+    bulk_data.type = type;
 
-    if(bulk_data.type != BULK_DATA_PACKED_32_VOICE)
+    if(bulk_data.type == BULK_DATA_UNIVERSAL_BULK_DUMP)
     {
-        free(bulk_payload_p);
+        bulk_data.universal = dx7_get_universal_bulk_data(head_p - sizeof(TwoByte_t),
+                                                          payload_p + length);
+        return bulk_data;
     }
-    printf("checksum: %3d + %3d = %3d\n", checksum, byte, checksum + byte);
+    //les voix compactées sont des enregistrements d'octets: une copie suffit.
+    void* copy_p = malloc(payload_size);
+    memcpy(copy_p, head_p, payload_size);
+    bulk_data.payload_p = copy_p;
     return bulk_data;
 }
 
+UniversalBulkDataPayload_t dx7_get_universal_bulk_data(const uint8_t* head_p, const uint8_t* end_p)
+{
+    UniversalBulkDataPayload_t universal = {UNIVERSAL_BULK_DATA_ERROR, {NULL}};
+    UniversalBulkData_t type = UNIVERSAL_BULK_DATA_ERROR;
+    size_t repeat_count = 0;
+    size_t data_size = 0;
+    uint8_t* data_p = NULL;
+    //[compte][LM  xxxxxx][données][checksum] pour chaque répétition, données mises bout à bout.
+    for(size_t repeat = 0; end_p - head_p >= (ptrdiff_t) sizeof(TwoByte_t); ++repeat)
+    {
+        TwoByte_t byte_count = {head_p[0], head_p[1]};
+        size_t count = get_payload_size(byte_count);
+        if(count < sizeof(UniversalBulkDataHeader_t)
+        || end_p - head_p < (ptrdiff_t) (sizeof(TwoByte_t) + count))
+        {
+            break;
+        }
+        UniversalBulkData_t block_type =
+            dx7_get_universal_bulk_data_header((const UniversalBulkDataHeader_t*) (head_p + sizeof(TwoByte_t)));
+        if(repeat == 0 && block_type != UNIVERSAL_BULK_DATA_ERROR)
+        {
+            type = block_type;
+            repeat_count = UNIVERSAL_BULK_DATA_REPEAT_TABLE[type];
+            data_size = UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[type] - sizeof(UniversalBulkDataHeader_t);
+            data_p = malloc(repeat_count * data_size);
+        }
+        if(type == UNIVERSAL_BULK_DATA_ERROR
+        || block_type != type
+        || count != UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[type])
+        {
+            break;
+        }
+        memcpy(data_p + repeat * data_size,
+               head_p + sizeof(TwoByte_t) + sizeof(UniversalBulkDataHeader_t),
+               data_size);
+        head_p += sizeof(TwoByte_t) + count + sizeof(uint8_t);
+        if(repeat + 1 == repeat_count)
+        {
+            universal.type = type;
+            universal.payload_p = data_p;
+            return universal;
+        }
+    }
+    free(data_p);
+    return universal;
+}
+
 
 uint8_t* dx7_format_bulk_payload(const BulkDataPayload_t* bulk_data_p,
                                  size_t* length_p)
@@ -353,7 +890,7 @@ uint8_t* dx7_format_bulk_payload(const BulkDataPayload_t* bulk_data_p,
         break;
     case BULK_DATA_PACKED_32_SUPPLEMENT:
     case BULK_DATA_PACKED_32_VOICE:
-        data_p = *(void**) bulk_data_p->payload_p;
+        data_p = bulk_data_p->payload_p;
         break;
     case BULK_DATA_UNIVERSAL_BULK_DUMP:
         payload_p = dx7_format_universal_bulk_payload(&bulk_data_p->universal,
@@ -376,49 +913,41 @@ uint8_t* dx7_format_bulk_payload(const BulkDataPayload_t* bulk_data_p,
 uint8_t* dx7_format_universal_bulk_payload(const UniversalBulkDataPayload_t* data_p,
                                            size_t* data_length_p)
 {
-    uint8_t* payload_p = NULL;
-    size_t payload_length = 0;
-    int repeat;
-    uint8_t** block_payload_pp = malloc(UNIVERSAL_BULK_DATA_REPEAT_TABLE[data_p->type] * sizeof(uint8_t*));
+    if(data_p->type < 0 || data_p->type >= UNIVERSAL_BULK_DATA_COUNT)
+    {
+        return NULL;
+    }
+    //les comptes d'octets incluent l'en-tête "LM  xxxxxx".
     int repeat_count = UNIVERSAL_BULK_DATA_REPEAT_TABLE[data_p->type];
-    for(repeat = 0;
-        repeat < repeat_count;
-        ++repeat)
-    {
-        UniversalBulkDataHeader_t universal_bulk_header;
-        strncpy(universal_bulk_header.classification,
-                UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME,
-                UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
-        strncpy(universal_bulk_header.format,
-                UNIVERSAL_BULK_DATA_FORMAT_TABLE[data_p->type],
-                UNIVERSAL_BULK_DATA_FORMAT_SIZE);
-        size_t format_length = UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[data_p->type] + sizeof(UniversalBulkDataHeader_t);
-        uint8_t* block_payload_p = malloc(format_length);
-        memcpy(block_payload_p,
-               &universal_bulk_header,
-               sizeof(UniversalBulkDataHeader_t));
-        const void* block_p = (repeat_count > 1) //si il y a plusieurs repetitions, nous avons un pointeur vers un tableau.
-                             ? * (void**) data_p->payload_p + repeat * UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[data_p->type]
-                             : data_p->payload_p;
-        memcpy(block_payload_p, block_p, UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[data_p->type]);
+    size_t format_length = UNIVERSAL_BULK_DATA_BYTE_COUNT_TABLE[data_p->type];
+    size_t data_size = format_length - sizeof(UniversalBulkDataHeader_t);
+    size_t block_length = sizeof(TwoByte_t) + format_length + sizeof(uint8_t);
+    uint8_t* payload_p = malloc(repeat_count * block_length);
+    uint8_t* block_payload_p = malloc(format_length);
+    UniversalBulkDataHeader_t universal_bulk_header;
+    memcpy(universal_bulk_header.classification,
+           UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME,
+           UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
+    memcpy(universal_bulk_header.format,
+           UNIVERSAL_BULK_DATA_FORMAT_TABLE[data_p->type],
+           UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+    memcpy(block_payload_p,
+           &universal_bulk_header,
+           sizeof(UniversalBulkDataHeader_t));
+    for(int repeat = 0; repeat < repeat_count; ++repeat)
+    {
+        //les répétitions sont rangées bout à bout derrière payload_p.
+        const uint8_t* block_p = (const uint8_t*) data_p->payload_p + repeat * data_size;
+        memcpy(block_payload_p + sizeof(UniversalBulkDataHeader_t), block_p, data_size);
         size_t length = 0;
-        block_payload_pp[repeat] = dx7_wrap_bulk_payload(block_payload_p,
-                                                         format_length,
-                                                         &length);
-        payload_length += length;
-        free(block_payload_p);
-    }
-    payload_p = malloc(payload_length);
-    size_t block_length = payload_length/repeat_count;
-    uint8_t* head_p;
-    for(repeat = 0, head_p = payload_p;
-        repeat < repeat_count;
-        repeat++, head_p += block_length)
-    {
-        memcpy(head_p, block_payload_pp[repeat], block_length);
-        free(block_payload_pp[repeat]);
-    }
-    free(block_payload_pp);
+        uint8_t* wrapped_p = dx7_wrap_bulk_payload(block_payload_p,
+                                                   format_length,
+                                                   &length);
+        memcpy(payload_p + repeat * block_length, wrapped_p, block_length);
+        free(wrapped_p);
+    }
+    free(block_payload_p);
+    *data_length_p = repeat_count * block_length;
     return payload_p;
 }
 
@@ -445,184 +974,532 @@ uint8_t* dx7_wrap_bulk_payload(const void* data_p,
 uint8_t* dx7_format_parameter_payload(const ParameterPayload_t* parameter_p,
                                       size_t* length_p)
 {
-    //TODO: convert.
+    size_t length = 0;
+    uint8_t* payload_p = NULL;
+    if(parameter_p->parameter < PARAMETER_CHANGE_COUNT)
+    {
+        length = PARAMETER_CHANGE_BYTE_COUNT_TABLE[parameter_p->parameter];
+        payload_p = malloc(length);
+        memcpy(payload_p, &parameter_p->data, length);
+    }
     if(length_p != NULL)
     {
-        *length_p = 0;
+        *length_p = length;
     }
-    return NULL;
+    return payload_p;
 }
 
 ParameterChangeHeader_t dx7_get_parameter_header(const ParameterPayload_t* parameter_p)
 {
-    //TODO: convert.
-    return PARAMETER_HEADER_INITIALISER;
+    ParameterChangeHeader_t header = PARAMETER_HEADER_INITIALISER;
+    if(parameter_p->parameter < PARAMETER_CHANGE_COUNT)
+    {
+        header.group_g   = PARAMETER_CHANGE_GROUP_TABLE[parameter_p->parameter].group_g;
+        header.group_h   = parameter_p->number >> MIDI_DATA_BITS;
+        header.parameter = parameter_p->number & MIDI_DATA_MASK;
+    }
+    return header;
+}
+
+
+SysexHeader_t dx7_decode_sysex_header(const uint8_t* bytes_p)
+{
+    SysexHeader_t header;
+    header.id        = bytes_p[0];
+    header.device    = bytes_p[1] & 0x0F;
+    header.substatus = (bytes_p[1] >> 4) & 0x07;
+    return header;
 }
 
+size_t dx7_encode_sysex_header(const SysexHeader_t* header_p, uint8_t* bytes_p)
+{
+    bytes_p[0] = header_p->id;
+    bytes_p[1] = ((header_p->substatus & 0x07) << 4) | (header_p->device & 0x0F);
+    return SYSEX_HEADER_SIZE;
+}
+
+ParameterChangeHeader_t dx7_decode_parameter_header(const uint8_t* bytes_p)
+{
+    ParameterChangeHeader_t header;
+    header.group_h   = bytes_p[0] & 0x03;
+    header.group_g   = (bytes_p[0] >> 2) & 0x1F;
+    header.parameter = bytes_p[1] & MIDI_DATA_MASK;
+    return header;
+}
+
+size_t dx7_encode_parameter_header(const ParameterChangeHeader_t* header_p, uint8_t* bytes_p)
+{
+    bytes_p[0] = ((header_p->group_g & 0x1F) << 2) | (header_p->group_h & 0x03);
+    bytes_p[1] = header_p->parameter & MIDI_DATA_MASK;
+    return PARAMETER_HEADER_SIZE;
+}
 
 SysexType_t dx7_get_header(const SysexHeader_t* header_p)
 {
-    printf("Manufacturer: %#4x\n", header_p->id);
-    printf("Substatus:    %#4x\n", header_p->substatus);
-    printf("Device number:%4u\n",  header_p->device + 1);
     return header_p->substatus;
 }
 
 BulkData_t dx7_get_bulk_data_header(const BulkDataHeader_t* header_p)
 {
-    BulkData_t type;
-    switch(header_p->format)
+    return BULK_DATA_LOOKUP_TABLE[header_p->format];
+}
+
+/*
+ * reads size bytes as a little endian integer.
+ */
+static uint64_t dx7_pack_tag(const void* bytes_p, size_t size)
+{
+    const uint8_t* byte_p = bytes_p;
+    uint64_t tag = 0;
+    for(size_t byte = 0; byte < size; ++byte)
     {
-        case BULK_DATA_FORMAT_VOICE_EDIT_BUFFER:
-            type = BULK_DATA_VOICE_EDIT_BUFFER;
-        break;
-        case BULK_DATA_FORMAT_SUPPLEMENT_EDIT_BUFFER:
-            type = BULK_DATA_SUPPLEMENT_EDIT_BUFFER;
-        break;
-        case BULK_DATA_FORMAT_PACKED_32_SUPPLEMENT:
-            type = BULK_DATA_PACKED_32_SUPPLEMENT;
-        break;
-        case BULK_DATA_FORMAT_PACKED_32_VOICE:
-            type = BULK_DATA_PACKED_32_VOICE;
-        break;
-        case BULK_DATA_FORMAT_UNIVERSAL_BULK_DUMP:
-            type = BULK_DATA_UNIVERSAL_BULK_DUMP;
-        break;
-        default:
-            type = BULK_DATA_MALFORMED;
-        break;
+        tag |= (uint64_t) byte_p[byte] << (8 * byte);
+    }
+    return tag;
+}
+
+static size_t dx7_hash_universal_tag(uint64_t tag)
+{
+    tag ^= tag >> UNIVERSAL_BULK_DATA_HASH_FOLD;
+    return (tag * UNIVERSAL_BULK_DATA_HASH_MULTIPLIER) >> (64 - UNIVERSAL_BULK_DATA_HASH_BITS);
+}
+
+UniversalBulkData_t dx7_get_universal_bulk_data_header(const UniversalBulkDataHeader_t* header_p)
+{
+    if(dx7_pack_tag(header_p->classification, UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE)
+    != dx7_pack_tag(UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME, UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE))
+    {
+        return UNIVERSAL_BULK_DATA_ERROR;
+    }
+    uint64_t tag = dx7_pack_tag(header_p->format, UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+    UniversalBulkData_t type = UNIVERSAL_BULK_DATA_HASH_TABLE[dx7_hash_universal_tag(tag)];
+    //une étiquette inconnue peut tomber dans une case occupée.
+    if(type == UNIVERSAL_BULK_DATA_ERROR
+    || tag != dx7_pack_tag(UNIVERSAL_BULK_DATA_FORMAT_TABLE[type], UNIVERSAL_BULK_DATA_FORMAT_SIZE))
+    {
+        return UNIVERSAL_BULK_DATA_ERROR;
     }
-    printf("%s\n", BULK_DATA_FORMAT_NAME_TABLE[type]);
     return type;
 }
 
+#define SCHEMA_PACK_OPERATOR_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    packed_operator_p[PACKED_OFFSET] |= (uint8_t) ((operator_p->FIELD & SCHEMA_FIELD_MASK(WIDTH)) << SHIFT);
+
+#define SCHEMA_PACK_VOICE_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    packed_parameters.data[PACKED_OFFSET] |= (uint8_t) ((parameters.FIELD & SCHEMA_FIELD_MASK(WIDTH)) << SHIFT);
+
+#define SCHEMA_UNPACK_OPERATOR_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    operator_p->FIELD = (packed_operator_p[PACKED_OFFSET] >> SHIFT) & SCHEMA_FIELD_MASK(WIDTH);
+
+#define SCHEMA_UNPACK_VOICE_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    unpacked_parameters.FIELD = (bytes_p[PACKED_OFFSET] >> SHIFT) & SCHEMA_FIELD_MASK(WIDTH);
+
 PackedVoiceParameters_t dx7_pack_voice_parameters(VoiceParameters_t parameters)
 {
-    PackedVoiceParameters_t packed_parameters;
-
-    for(int operator = OPERATOR_1; operator <= OPERATOR_6; ++operator)
-    {
-       PackedOperatorParameters_t* packed_operator_p = packed_parameters.Operator + operator;
-       OperatorParameters_t*       operator_p        = parameters.Operator        + operator;
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_rate_1);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_rate_2);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_rate_3);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_rate_4);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_level_1);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_level_2);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_level_3);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, eg_level_4);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, break_point);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, left_depth);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, right_depth);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, left_curve);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, right_curve);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, rate_scaling);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, modulation_sensitivity);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, touch_sensitivity);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, total_level);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, frequency_mode);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, frequency_coarse);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, frequency_fine);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *packed_operator_p, detune);
-    }
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_rate_1);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_rate_2);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_rate_3);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_rate_4);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_level_1);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_level_2);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_level_3);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, peg_level_4);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, algorithm);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, feedback_level);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, oscillator_phase_init);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, lfo_speed);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, lfo_delay_time);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, pitch_modulation_depth);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, amplitude_modulation_depth);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, lfo_key_sync);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, lfo_wave);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, lfo_pitch_modulation_sensitivity);
-    CONVERT_STRUCT_PARAMETER(parameters, packed_parameters, transpose);
-    memcpy(packed_parameters.voice_name, parameters.voice_name, VOICE_NAME_SIZE);
+    PackedVoiceParameters_t packed_parameters = {{0}};
+
+    for(int operator = OPERATOR_6; operator < OPERATOR_COUNT; ++operator)
+    {
+        uint8_t*                    packed_operator_p = packed_parameters.data + operator * PACKED_OPERATOR_SIZE;
+        const OperatorParameters_t* operator_p        = parameters.Operator    + operator;
+        DX7_OPERATOR_SCHEMA(SCHEMA_PACK_OPERATOR_FIELD)
+    }
+    DX7_VOICE_SCHEMA(SCHEMA_PACK_VOICE_FIELD)
+    memcpy(packed_parameters.data + PACKED_VOICE_NAME_OFFSET, parameters.voice_name, VOICE_NAME_SIZE);
 
     return packed_parameters;
 }
 
 VoiceParameters_t dx7_unpack_voice_parameters(PackedVoiceParameters_t parameters)
+{
+    return dx7_decode_packed_voice(parameters.data);
+}
+
+VoiceParameters_t dx7_decode_packed_voice(const uint8_t* bytes_p)
 {
     VoiceParameters_t unpacked_parameters;
-    for(int operator = OPERATOR_1; operator <= OPERATOR_6; ++operator)
-    {
-       OperatorParameters_t*       unpacked_operator_p = unpacked_parameters.Operator + operator;
-       PackedOperatorParameters_t* operator_p          = parameters.Operator          + operator;
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_rate_1);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_rate_2);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_rate_3);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_rate_4);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_level_1);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_level_2);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_level_3);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, eg_level_4);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, break_point);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, left_depth);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, right_depth);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, left_curve);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, right_curve);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, rate_scaling);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, modulation_sensitivity);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, touch_sensitivity);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, total_level);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, frequency_mode);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, frequency_coarse);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, frequency_fine);
-       CONVERT_STRUCT_PARAMETER(*operator_p, *unpacked_operator_p, detune);
-    }
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_rate_1);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_rate_2);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_rate_3);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_rate_4);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_level_1);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_level_2);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_level_3);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, peg_level_4);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, algorithm);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, feedback_level);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, oscillator_phase_init);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, lfo_speed);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, lfo_delay_time);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, pitch_modulation_depth);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, amplitude_modulation_depth);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, lfo_key_sync);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, lfo_wave);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, lfo_pitch_modulation_sensitivity);
-    CONVERT_STRUCT_PARAMETER(parameters, unpacked_parameters, transpose);
-
-    memcpy(unpacked_parameters.voice_name, parameters.voice_name, VOICE_NAME_SIZE);
+    for(int operator = OPERATOR_6; operator < OPERATOR_COUNT; ++operator)
+    {
+        const uint8_t*        packed_operator_p = bytes_p                      + operator * PACKED_OPERATOR_SIZE;
+        OperatorParameters_t* operator_p        = unpacked_parameters.Operator + operator;
+        DX7_OPERATOR_SCHEMA(SCHEMA_UNPACK_OPERATOR_FIELD)
+    }
+    DX7_VOICE_SCHEMA(SCHEMA_UNPACK_VOICE_FIELD)
+    memcpy(unpacked_parameters.voice_name, bytes_p + PACKED_VOICE_NAME_OFFSET, VOICE_NAME_SIZE);
 
     return unpacked_parameters;
 }
 
-char*
-dx7_copy_patch_name(VoiceParameters_t parameters)
+#define SCHEMA_PACK_SUPPLEMENT_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    packed_parameters.data[PACKED_OFFSET] |= (uint8_t) ((parameters.FIELD & SCHEMA_FIELD_MASK(WIDTH)) << SHIFT);
+
+#define SCHEMA_UNPACK_SUPPLEMENT_FIELD(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    unpacked_parameters.FIELD = (bytes_p[PACKED_OFFSET] >> SHIFT) & SCHEMA_FIELD_MASK(WIDTH);
+
+PackedSupplementVoiceParameters_t dx7_pack_supplement_parameters(SupplementVoiceParameters_t parameters)
 {
-    char* voice_name_p = malloc(sizeof(parameters.voice_name) + 1);
-    strncpy(voice_name_p, parameters.voice_name, sizeof(parameters.voice_name));
-    char* character_p = voice_name_p + sizeof(parameters.voice_name);
-    do
+    PackedSupplementVoiceParameters_t packed_parameters = {{0}};
+    DX7_SUPPLEMENT_SCHEMA(SCHEMA_PACK_SUPPLEMENT_FIELD)
+    return packed_parameters;
+}
+
+SupplementVoiceParameters_t dx7_decode_packed_supplement(const uint8_t* bytes_p)
+{
+    SupplementVoiceParameters_t unpacked_parameters;
+    DX7_SUPPLEMENT_SCHEMA(SCHEMA_UNPACK_SUPPLEMENT_FIELD)
+    return unpacked_parameters;
+}
+
+const SchemaField_t* dx7_get_voice_schema_field(uint16_t number, Operator_t* operator_p)
+{
+    const SchemaField_t* field_p = NULL;
+    Operator_t operator = OPERATOR_COUNT;
+    if(number < OPERATOR_COUNT * sizeof(OperatorParameters_t))
+    {
+        operator = number / sizeof(OperatorParameters_t);
+        field_p  = OPERATOR_SCHEMA_TABLE + number % sizeof(OperatorParameters_t);
+    }
+    else if(number < offsetof(VoiceParameters_t, voice_name))
+    {
+        field_p = VOICE_SCHEMA_TABLE + (number - offsetof(VoiceParameters_t, peg_rate_1));
+    }
+    if(operator_p != NULL)
+    {
+        *operator_p = operator;
+    }
+    return field_p;
+}
+
+int dx7_validate_voice_parameters(const VoiceParameters_t* parameters_p)
+{
+    const uint8_t* bytes_p = (const uint8_t*) parameters_p;
+    int error_count = 0;
+    for(size_t byte = 0; byte < sizeof(VoiceParameters_t); ++byte)
+    {
+        error_count += (bytes_p[byte] < VOICE_MINIMUM_TABLE[byte])
+                     | (bytes_p[byte] > VOICE_MAXIMUM_TABLE[byte]);
+    }
+    return error_count;
+}
+
+int dx7_validate_voices(VoiceParameters_t* voices_p,
+                        size_t voice_count,
+                        ValidationMode_t mode,
+                        ValidationReport_t* report_p)
+{
+    const uint8_t* initial_p = (const uint8_t*) &VOICE_PARAMETERS_INITIALISER;
+    uint8_t violations[sizeof(VoiceParameters_t)];
+    int invalid_voice_count = 0;
+    for(size_t voice = 0; voice < voice_count; ++voice)
+    {
+        uint8_t* bytes_p = (uint8_t*) (voices_p + voice);
+        uint8_t  invalid = 0;
+        //sans branchement: le compilateur vectorise ces boucles.
+        for(size_t byte = 0; byte < sizeof(VoiceParameters_t); ++byte)
+        {
+            violations[byte] = (bytes_p[byte] < VOICE_MINIMUM_TABLE[byte])
+                             | (bytes_p[byte] > VOICE_MAXIMUM_TABLE[byte]);
+            invalid |= violations[byte];
+        }
+        if(!invalid)
+        {
+            continue;
+        }
+        ++invalid_voice_count;
+        switch(mode)
+        {
+            case VALIDATION_CLAMP:
+                for(size_t byte = 0; byte < sizeof(VoiceParameters_t); ++byte)
+                {
+                    uint8_t value = bytes_p[byte];
+                    value = (value < VOICE_MINIMUM_TABLE[byte]) ? VOICE_MINIMUM_TABLE[byte] : value;
+                    value = (value > VOICE_MAXIMUM_TABLE[byte]) ? VOICE_MAXIMUM_TABLE[byte] : value;
+                    bytes_p[byte] = value;
+                }
+            break;
+            case VALIDATION_RESET:
+                for(size_t byte = 0; byte < sizeof(VoiceParameters_t); ++byte)
+                {
+                    bytes_p[byte] = violations[byte] ? initial_p[byte] : bytes_p[byte];
+                }
+            break;
+            default:
+            break;
+        }
+        if(report_p != NULL)
+        {
+            for(size_t byte = 0; byte < sizeof(VoiceParameters_t); ++byte)
+            {
+                report_p->field_violation_count[byte] += violations[byte];
+                report_p->violation_count += violations[byte];
+            }
+        }
+    }
+    if(report_p != NULL)
+    {
+        report_p->voice_count += voice_count;
+        report_p->invalid_voice_count += invalid_voice_count;
+    }
+    return invalid_voice_count;
+}
+
+//octet, décalage et masque VMEM de chaque octet VCED: une voix compactée se valide d'un seul passage.
+static uint8_t PACKED_BYTE_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER];
+static uint8_t PACKED_SHIFT_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER];
+static uint8_t PACKED_MASK_TABLE[BYTE_COUNT_VOICE_EDIT_BUFFER];
+
+__attribute__((constructor))
+static void dx7_build_packed_tables(void)
+{
+    for(uint16_t number = 0; number < BYTE_COUNT_VOICE_EDIT_BUFFER; ++number)
+    {
+        Operator_t operator;
+        const SchemaField_t* field_p = dx7_get_voice_schema_field(number, &operator);
+        if(field_p == NULL)
+        {
+            //le nom occupe des octets entiers.
+            PACKED_BYTE_TABLE[number] = PACKED_VOICE_NAME_OFFSET + (number - offsetof(VoiceParameters_t, voice_name));
+            PACKED_SHIFT_TABLE[number] = 0;
+            PACKED_MASK_TABLE[number] = 0xFF;
+            continue;
+        }
+        PACKED_BYTE_TABLE[number] = field_p->packed_offset + ((operator < OPERATOR_COUNT) ? operator * PACKED_OPERATOR_SIZE : 0);
+        PACKED_SHIFT_TABLE[number] = field_p->shift;
+        PACKED_MASK_TABLE[number] = (uint8_t) SCHEMA_FIELD_MASK(field_p->width);
+    }
+}
+
+int dx7_validate_packed_voices(PackedVoiceParameters_t* voices_p,
+                               size_t voice_count,
+                               ValidationMode_t mode,
+                               ValidationReport_t* report_p)
+{
+    const uint8_t* initial_p = (const uint8_t*) &VOICE_PARAMETERS_INITIALISER;
+    uint8_t violations[BYTE_COUNT_VOICE_EDIT_BUFFER];
+    int invalid_voice_count = 0;
+    for(size_t voice = 0; voice < voice_count; ++voice)
+    {
+        uint8_t* bytes_p = voices_p[voice].data;
+        uint8_t  invalid = 0;
+        //sans branchement, comme dx7_validate_voices: les champs sont lus par les tables.
+        for(size_t number = 0; number < BYTE_COUNT_VOICE_EDIT_BUFFER; ++number)
+        {
+            uint8_t value = (bytes_p[PACKED_BYTE_TABLE[number]] >> PACKED_SHIFT_TABLE[number]) & PACKED_MASK_TABLE[number];
+            violations[number] = (value < VOICE_MINIMUM_TABLE[number])
+                               | (value > VOICE_MAXIMUM_TABLE[number]);
+            invalid |= violations[number];
+        }
+        if(invalid && (mode == VALIDATION_CLAMP || mode == VALIDATION_RESET))
+        {
+            for(size_t number = 0; number < BYTE_COUNT_VOICE_EDIT_BUFFER; ++number)
+            {
+                if(!violations[number])
+                {
+                    continue;
+                }
+                uint8_t* byte_p = bytes_p + PACKED_BYTE_TABLE[number];
+                uint8_t  shift = PACKED_SHIFT_TABLE[number];
+                uint8_t  mask = PACKED_MASK_TABLE[number];
+                uint8_t  value = (*byte_p >> shift) & mask;
+                if(mode == VALIDATION_CLAMP)
+                {
+                    value = (value < VOICE_MINIMUM_TABLE[number]) ? VOICE_MINIMUM_TABLE[number] : VOICE_MAXIMUM_TABLE[number];
+                }
+                else
+                {
+                    value = initial_p[number];
+                }
+                *byte_p = (uint8_t) ((*byte_p & ~(mask << shift)) | ((value & mask) << shift));
+            }
+        }
+        if(!invalid)
+        {
+            continue;
+        }
+        ++invalid_voice_count;
+        if(report_p != NULL)
+        {
+            for(size_t byte = 0; byte < BYTE_COUNT_VOICE_EDIT_BUFFER; ++byte)
+            {
+                report_p->field_violation_count[byte] += violations[byte];
+                report_p->violation_count += violations[byte];
+            }
+        }
+    }
+    if(report_p != NULL)
+    {
+        report_p->voice_count += voice_count;
+        report_p->invalid_voice_count += invalid_voice_count;
+    }
+    return invalid_voice_count;
+}
+
+void dx7_merge_validation_report(ValidationReport_t* report_p, const ValidationReport_t* other_p)
+{
+    report_p->voice_count += other_p->voice_count;
+    report_p->invalid_voice_count += other_p->invalid_voice_count;
+    report_p->violation_count += other_p->violation_count;
+    for(int number = 0; number < BYTE_COUNT_VOICE_EDIT_BUFFER; ++number)
+    {
+        report_p->field_violation_count[number] += other_p->field_violation_count[number];
+    }
+}
+
+void dx7_print_validation_report(FILE* file_p, const ValidationReport_t* report_p)
+{
+    fprintf(file_p,
+            "Validation: %u/%u invalid voices, %u violations\n",
+            report_p->invalid_voice_count,
+            report_p->voice_count,
+            report_p->violation_count);
+    for(uint16_t number = 0; number < sizeof(VoiceParameters_t); ++number)
+    {
+        uint32_t count = report_p->field_violation_count[number];
+        if(count == 0)
+        {
+            continue;
+        }
+        Operator_t operator;
+        const SchemaField_t* field_p = dx7_get_voice_schema_field(number, &operator);
+        if(field_p == NULL)
+        {
+            fprintf(file_p, "  %3hu voice_name[%d]: %u\n",
+                    number, number - (int) offsetof(VoiceParameters_t, voice_name), count);
+        }
+        else if(operator < OPERATOR_COUNT)
+        {
+            fprintf(file_p, "  %3hu OP%d %s: %u\n",
+                    number, OPERATOR_COUNT - operator, field_p->name, count);
+        }
+        else
+        {
+            fprintf(file_p, "  %3hu %s: %u\n", number, field_p->name, count);
+        }
+    }
+}
+
+ValidationMode_t dx7_get_validation_mode(const char* name_p)
+{
+    ValidationMode_t mode;
+    for(mode = VALIDATION_OFF; mode < VALIDATION_MODE_COUNT; ++mode)
     {
-        *character_p = 0;
-        character_p--;
-    } while(isspace(*character_p));
-    for(;character_p>=voice_name_p; --character_p)
+        if(strcmp(name_p, VALIDATION_MODE_NAME_TABLE[mode]) == 0)
+        {
+            break;
+        }
+    }
+    return mode;
+}
+
+int dx7_apply_voice_parameter(VoiceParameters_t* parameters_p,
+                              const ParameterPayload_t* parameter_p)
+{
+    if(parameter_p->parameter != PARAMETER_CHANGE_VOICE)
     {
-        if(!is_valid_byte(*character_p))
+        return -1;
+    }
+    uint8_t* bytes_p = (uint8_t*) parameters_p;
+    uint16_t number  = parameter_p->number;
+    uint8_t  value   = parameter_p->data;
+    Operator_t operator;
+    const SchemaField_t* field_p = dx7_get_voice_schema_field(number, &operator);
+    if(field_p != NULL)
+    {
+        if(value < field_p->minimum || value > field_p->maximum)
         {
-            *character_p = '_';
+            return -1;
         }
+        bytes_p[number] = value;
     }
+    else if(number < sizeof(VoiceParameters_t))
+    {
+        if(value & ~MIDI_DATA_MASK)
+        {
+            return -1;
+        }
+        bytes_p[number] = value;
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static int dx7_print_schema_json(FILE* file_p,
+                                 const uint8_t* bytes_p,
+                                 const SchemaField_t* table_p,
+                                 int field_count)
+{
+    int count = 0;
+    for(int field = 0; field < field_count; ++field)
+    {
+        count += fprintf(file_p,
+                         "%s\"%s\":%hhu",
+                         field ? "," : "",
+                         table_p[field].name,
+                         bytes_p[table_p[field].offset]);
+    }
+    return count;
+}
 
+int dx7_print_voice_json(FILE* file_p, const VoiceParameters_t* parameters_p)
+{
+    const uint8_t* bytes_p = (const uint8_t*) parameters_p;
+    int count = fprintf(file_p, "{\"operators\":[");
+    for(int operator = OPERATOR_6; operator < OPERATOR_COUNT; ++operator)
+    {
+        count += fprintf(file_p, "%s{\"operator\":%d,", operator ? "," : "", OPERATOR_COUNT - operator);
+        count += dx7_print_schema_json(file_p,
+                                       bytes_p + operator * sizeof(OperatorParameters_t),
+                                       OPERATOR_SCHEMA_TABLE,
+                                       OPERATOR_FIELD_COUNT);
+        count += fprintf(file_p, "}");
+    }
+    count += fprintf(file_p, "],");
+    count += dx7_print_schema_json(file_p, bytes_p, VOICE_SCHEMA_TABLE, VOICE_FIELD_COUNT);
+    count += fprintf(file_p, ",\"voice_name\":\"");
+    for(int character = 0; character < VOICE_NAME_SIZE; ++character)
+    {
+        uint8_t byte = parameters_p->voice_name[character];
+        if(byte == '"' || byte == '\\')
+        {
+            count += fprintf(file_p, "\\%c", byte);
+        }
+        else if(byte < ' ' || byte > '~')
+        {
+            count += fprintf(file_p, "\\u%04x", byte);
+        }
+        else
+        {
+            count += fprintf(file_p, "%c", byte);
+        }
+    }
+    count += fprintf(file_p, "\"}");
+    return count;
+}
+
+size_t dx7_get_patch_name(const VoiceParameters_t* parameters_p, char* name_p)
+{
+    size_t length = sizeof(parameters_p->voice_name);
+    while(length > 0 && isspace((uint8_t) parameters_p->voice_name[length - 1]))
+    {
+        --length;
+    }
+    for(size_t character = 0; character < length; ++character)
+    {
+        char byte = parameters_p->voice_name[character];
+        name_p[character] = is_valid_byte(byte) ? byte : '_';
+    }
+    name_p[length] = 0;
+    return length;
+}
+
+char*
+dx7_copy_patch_name(VoiceParameters_t parameters)
+{
+    char* voice_name_p = malloc(sizeof(parameters.voice_name) + 1);
+    dx7_get_patch_name(&parameters, voice_name_p);
     return voice_name_p;
 }
 
@@ -9,29 +9,131 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <sys/stat.h>
 
 #include "engine.h"
+#include "dataset.h"
 #include "help.h"
 #include "midi.h"
+#include "names.h"
+#include "path.h"
+#include "pipeline.h"
+#include "scanner.h"
+#include "smf.h"
+#include "tuning.h"
+#include "walker.h"
 
-typedef struct olidx_engine_t
+const olidx_engine_t OLIDX_ENGINE_INITIALISER =
 {
-    int unpack;
-    uint8_t file_number;
-    const char* file_root_p;
-    const char* unpack_folder_p;
-} olidx_engine_t;
+    0,
+    0,
+    NULL,
+    NULL,
+    NULL,
+    VALIDATION_OFF,
+    {0, 0, 0, {0}},
+    {{{NULL, NULL, 0}}, 0, 0},
+    {{{0}}},
+    0,
+    NULL,
+    NULL,
+    TUNING_FILE_COUNT,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0,
+    0,
+    NULL
+};
 
+/*
+ * ends a run which failed once its outputs are open: the name index and
+ * the dataset are closed, the manifest removed.
+ */
+static int fail_engine(olidx_engine_t* engine_p)
+{
+    if(engine_p->name_index_p != NULL)
+    {
+        close_name_index(engine_p);
+    }
+    if(engine_p->dataset_p != NULL)
+    {
+        close_dataset(engine_p);
+    }
+    if(engine_p->manifest_p != NULL)
+    {
+        manifest_discard(engine_p->manifest_p);
+        engine_p->manifest_p = NULL;
+    }
+    return EXIT_FAILURE;
+}
+
+/*
+ * the root of the output names of the current input.
+ */
+static const char* get_engine_root(const olidx_engine_t* engine_p)
+{
+    return (engine_p->root_p != NULL) ? engine_p->root_p : path_to_file_name(engine_p->file_root_p);
+}
 
-olidx_engine_t olidx_engine = {0, 0, NULL, NULL};
+void subscribe_engine(olidx_engine_t* engine_p)
+{
+    engine_p->dispatcher = SYSEX_DISPATCHER_INITIALISER;
+    if(engine_p->unpack)
+    {
+        events_subscribe(&engine_p->dispatcher,
+                         unpack_voice_handler,
+                         engine_p,
+                         SYSEX_EVENT_MASK(SYSEX_EVENT_VOICE));
+        events_subscribe(&engine_p->dispatcher,
+                         unpack_bank_handler,
+                         engine_p,
+                         SYSEX_EVENT_MASK(SYSEX_EVENT_BANK_END));
+        if(engine_p->tuning_format != TUNING_FILE_COUNT)
+        {
+            events_subscribe(&engine_p->dispatcher,
+                             export_tuning_handler,
+                             engine_p,
+                             SYSEX_EVENT_MASK(SYSEX_EVENT_UNIVERSAL_BLOCK));
+        }
+    }
+    if(engine_p->dataset_p != NULL)
+    {
+        events_subscribe(&engine_p->dispatcher,
+                         export_voice_handler,
+                         engine_p,
+                         SYSEX_EVENT_MASK(SYSEX_EVENT_VOICE));
+    }
+}
 
 int run_engine(int argc, char* argv[])
 {
     ProgramOptions_t options = {0};
+    options.tuning_format = TUNING_FILE_COUNT;
+    options.dataset_type = DATASET_TYPE_COUNT;
+    olidx_engine_t olidx_engine = OLIDX_ENGINE_INITIALISER;
     olidx_engine.file_root_p = option_handler(argc, argv, &options);
     olidx_engine.unpack = options.unpack;
     olidx_engine.unpack_folder_p = options.unpack_folder_p;
+    olidx_engine.validation = options.validation;
+    olidx_engine.validation_report = VALIDATION_REPORT_INITIALISER;
+    olidx_engine.recover = options.recover;
+    olidx_engine.tuning_format = options.tuning_format;
+    olidx_engine.log_p = stdout;
+    PathTemplate_t voice_template;
+    const char* voice_template_text_p = options.voice_template_p ? options.voice_template_p : PATH_VOICE_TEMPLATE;
+    if(path_compile_template(&voice_template, voice_template_text_p))
+    {
+        printf("invalid name template: %s\n", voice_template_text_p);
+        return EXIT_FAILURE;
+    }
+    olidx_engine.voice_template_p = &voice_template;
+    CodecRegistry_t codecs;
+    codec_registry_init(&codecs);
+    olidx_engine.codecs_p = &codecs;
     if(olidx_engine.file_root_p)
     {
         printf("File: %s\n", olidx_engine.file_root_p);
@@ -41,57 +143,732 @@ int run_engine(int argc, char* argv[])
         printf("no file specified: OOST!\n");
         return EXIT_FAILURE;
     }
-    FILE* midi_file_p = fopen(olidx_engine.file_root_p, "r");
-    if(!midi_file_p)
+    olidx_engine.input_number = 1;
+    Manifest_t manifest;
+    if(olidx_engine.unpack && options.query_p == NULL)
     {
-        printf("can't open file: %s\n", olidx_engine.file_root_p);
-        return EXIT_FAILURE;
+        if(manifest_open(&manifest, olidx_engine.unpack_folder_p))
+        {
+            printf("can't write manifest in: %s\n", olidx_engine.unpack_folder_p);
+            return EXIT_FAILURE;
+        }
+        olidx_engine.manifest_p = &manifest;
     }
-    int size;
+    DatasetWriter_t dataset;
+    if(options.dataset_type != DATASET_TYPE_COUNT && options.query_p == NULL)
+    {
+        open_dataset(&olidx_engine, &dataset, options.dataset_type, options.shard_rows);
+    }
+    subscribe_engine(&olidx_engine);
     olidx_engine.file_number = 0;
-    do
+    if(options.query_p != NULL)
     {
-        uint8_t* buffer_p = midi_get_next_sysex_payload(midi_file_p, &size);
-        if(buffer_p)
+        return query_name_index(olidx_engine.file_root_p, options.query_p, options.similar)
+               ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    NameIndex_t name_index;
+    if(olidx_engine.unpack)
+    {
+        open_name_index(&olidx_engine, &name_index);
+    }
+    struct stat root_stat;
+    TuningFileFormat_t import_format = tuning_get_file_format(olidx_engine.file_root_p);
+    if(import_format != TUNING_FILE_COUNT)
+    {
+        if(!olidx_engine.unpack)
         {
-            printf("--------------\n");
-            printf("Payload no: %d\n", ++olidx_engine.file_number);
-            printf("Sysex size: %dB\n", size);
-            process_sysex_data(buffer_p, size, &options);
-            free(buffer_p);
+            printf("tuning import needs -u <folder>\n");
+            return EXIT_FAILURE;
         }
-    } while(size > 0);
+        if(import_tuning(&olidx_engine, import_format))
+        {
+            return fail_engine(&olidx_engine);
+        }
+    }
+    else if(stat(olidx_engine.file_root_p, &root_stat) == 0 && S_ISDIR(root_stat.st_mode))
+    {
+        if(run_folder(&olidx_engine, options.thread_count))
+        {
+            return fail_engine(&olidx_engine);
+        }
+    }
+    else if(options.thread_count > 0)
+    {
+        if(run_pipeline(&olidx_engine, options.thread_count))
+        {
+            return fail_engine(&olidx_engine);
+        }
+    }
+    else if(decode_file(&olidx_engine))
+    {
+        return fail_engine(&olidx_engine);
+    }
+    if(olidx_engine.validation != VALIDATION_OFF)
+    {
+        dx7_print_validation_report(stdout, &olidx_engine.validation_report);
+    }
+    if(olidx_engine.name_index_p != NULL)
+    {
+        close_name_index(&olidx_engine);
+    }
+    if(olidx_engine.dataset_p != NULL)
+    {
+        close_dataset(&olidx_engine);
+    }
+    if(olidx_engine.manifest_p != NULL && close_manifest(&olidx_engine))
+    {
+        return EXIT_FAILURE;
+    }
     printf("fin\n");
     return EXIT_SUCCESS;
 }
 
+void open_name_index(olidx_engine_t* engine_p, NameIndex_t* index_p)
+{
+    //l'index du dossier est complété d'une exécution à l'autre.
+    PathBuilder_t index_path;
+    start_path(engine_p, &index_path);
+    path_append(&index_path, NAME_INDEX_FILE_ROOT NAME_INDEX_EXTENSION);
+    const char* index_name_p = path_get(&index_path);
+    FILE* index_file_p = (index_name_p != NULL) ? fopen(index_name_p, "rb") : NULL;
+    if(index_file_p == NULL || names_read(index_file_p, index_p))
+    {
+        *index_p = NAME_INDEX_INITIALISER;
+    }
+    if(index_file_p != NULL)
+    {
+        fclose(index_file_p);
+    }
+    engine_p->name_index_p = index_p;
+}
+
+void close_name_index(olidx_engine_t* engine_p)
+{
+    PathBuilder_t index_path;
+    start_path(engine_p, &index_path);
+    path_append(&index_path, NAME_INDEX_FILE_ROOT NAME_INDEX_EXTENSION);
+    const char* index_name_p = path_get(&index_path);
+    names_build(engine_p->name_index_p);
+    FILE* index_file_p = (index_name_p != NULL) ? fopen(index_name_p, "wb") : NULL;
+    if(index_file_p == NULL || names_write(index_file_p, engine_p->name_index_p))
+    {
+        printf("can't write name index: %s\n", index_path.text);
+    }
+    else
+    {
+        printf("name index: %u voices, %u names\n",
+               engine_p->name_index_p->entry_count,
+               engine_p->name_index_p->names.count);
+    }
+    if(index_file_p != NULL && fclose(index_file_p) == 0 && engine_p->manifest_p != NULL)
+    {
+        manifest_add_file(engine_p->manifest_p, index_name_p);
+    }
+    names_free(engine_p->name_index_p);
+    engine_p->name_index_p = NULL;
+}
+
+void open_dataset(olidx_engine_t* engine_p, DatasetWriter_t* writer_p, DatasetType_t type, uint64_t shard_rows)
+{
+    PathBuilder_t root_path;
+    if(engine_p->unpack_folder_p != NULL)
+    {
+        start_path(engine_p, &root_path);
+    }
+    else
+    {
+        //à côté de l'entrée.
+        path_init(&root_path, NULL);
+        path_append_length(&root_path,
+                           engine_p->file_root_p,
+                           path_to_file_name(engine_p->file_root_p) - engine_p->file_root_p);
+    }
+    path_append_root(&root_path, engine_p->file_root_p);
+    dataset_open(writer_p, root_path.text, type, shard_rows);
+    writer_p->manifest_p = engine_p->manifest_p;
+    engine_p->dataset_p = writer_p;
+}
+
+void close_dataset(olidx_engine_t* engine_p)
+{
+    uint64_t row_count = engine_p->dataset_p->row_count;
+    uint32_t shard_count = engine_p->dataset_p->shard_count;
+    if(dataset_close(engine_p->dataset_p))
+    {
+        printf("can't write dataset\n");
+    }
+    else
+    {
+        printf("dataset: %llu voices in %u files\n", (unsigned long long) row_count, shard_count);
+    }
+    engine_p->dataset_p = NULL;
+}
+
+int close_manifest(olidx_engine_t* engine_p)
+{
+    Manifest_t* manifest_p = engine_p->manifest_p;
+    uint32_t entry_count = manifest_p->entry_count;
+    int result = 0;
+    if(manifest_p->conflict_count > 0)
+    {
+        printf("manifest: %u outputs written over another one with other bytes, first: %s\n",
+               manifest_p->conflict_count,
+               names_get(&manifest_p->paths, manifest_p->conflict_id));
+        result = -1;
+    }
+    if(manifest_close(manifest_p))
+    {
+        printf("can't write manifest\n");
+        result = -1;
+    }
+    else
+    {
+        printf("manifest: %u files\n", entry_count);
+    }
+    engine_p->manifest_p = NULL;
+    return result;
+}
+
+int query_name_index(const char* index_name_p, const char* query_p, int similar)
+{
+    FILE* index_file_p = fopen(index_name_p, "rb");
+    if(index_file_p == NULL)
+    {
+        printf("can't open file: %s\n", index_name_p);
+        return -1;
+    }
+    NameIndex_t index;
+    int result = names_read(index_file_p, &index);
+    fclose(index_file_p);
+    if(result)
+    {
+        printf("not a name index: %s\n", index_name_p);
+        return -1;
+    }
+    size_t capacity = index.names.count;
+    size_t found;
+    if(similar)
+    {
+        NameMatch_t* matches_p = malloc((capacity + 1) * sizeof(NameMatch_t));
+        found = names_find_similar(&index, query_p, NAME_SIMILARITY_THRESHOLD, matches_p, capacity);
+        for(size_t match = 0; match < found; ++match)
+        {
+            printf("%.2f ", matches_p[match].score);
+            names_print(stdout, &index, matches_p[match].name_id);
+        }
+        free(matches_p);
+    }
+    else
+    {
+        uint32_t* ids_p = malloc((capacity + 1) * sizeof(uint32_t));
+        found = names_find(&index, query_p, ids_p, capacity);
+        for(size_t match = 0; match < found; ++match)
+        {
+            names_print(stdout, &index, ids_p[match]);
+        }
+        free(ids_p);
+    }
+    printf("%zu names\n", found);
+    names_free(&index);
+    return 0;
+}
+
+int scan_file(olidx_engine_t* engine_p)
+{
+    SysexScanner_t scanner;
+    if(scanner_open_file(&scanner, engine_p->file_root_p, engine_p->recover))
+    {
+        fprintf(engine_p->log_p, "can't open file: %s\n", engine_p->file_root_p);
+        return -1;
+    }
+    ScannedMessage_t message;
+    while(scanner_next(&scanner, &message))
+    {
+        ++engine_p->file_number;
+        process_message(engine_p, &message);
+    }
+    if(engine_p->recover)
+    {
+        fprintf(engine_p->log_p, "--------------\n");
+        scanner_print_statistics(engine_p->log_p, &scanner.statistics);
+    }
+    scanner_close(&scanner);
+    return 0;
+}
+
+/*
+ * reads the next message without the scanner.
+ * returns its payload, to be freed, or NULL at the end of the input: the
+ * only end rule of decode_file and read_stage.
+ */
+static uint8_t* read_message(FILE* midi_file_p, ScannedMessage_t* message_p)
+{
+    int size;
+    uint8_t* payload_p = midi_get_next_sysex_payload(midi_file_p, &size);
+    if(payload_p != NULL)
+    {
+        ScannedMessage_t message = {payload_p, size, 0, 1, SYSEX_CHECK_VALID, 0};
+        *message_p = message;
+    }
+    return payload_p;
+}
+
+int decode_file(olidx_engine_t* engine_p)
+{
+    if(engine_p->recover || smf_is_file(engine_p->file_root_p))
+    {
+        return scan_file(engine_p);
+    }
+    FILE* midi_file_p = fopen(engine_p->file_root_p, "r");
+    if(!midi_file_p)
+    {
+        fprintf(engine_p->log_p, "can't open file: %s\n", engine_p->file_root_p);
+        return -1;
+    }
+    ScannedMessage_t message;
+    uint8_t* buffer_p;
+    while((buffer_p = read_message(midi_file_p, &message)) != NULL)
+    {
+        ++engine_p->file_number;
+        process_message(engine_p, &message);
+        free(buffer_p);
+    }
+    fclose(midi_file_p);
+    return 0;
+}
+
+/**
+ * shared by the stages of run_pipeline and run_folder.
+ */
+typedef struct EnginePipeline_t
+{
+    const olidx_engine_t* engine_p;
+    FILE* midi_file_p;         //lecture simple
+    int scanning;              //lecture par le scanner: récupération ou fichier MIDI standard.
+    SysexScanner_t scanner;
+    char* const* paths_pp;     //fichiers d'un dossier, un travail chacun.
+    size_t path_count;
+    size_t root_offset;        //début des chemins relatifs au dossier.
+    size_t next_path;
+    PipelineQueue_t decode_queue;
+    PipelineQueue_t write_queue;
+    sem_t window;              //messages lus mais pas encore écrits.
+    int decoder_count;         //décodeurs encore actifs.
+} EnginePipeline_t;
+
+typedef struct EngineDecoder_t
+{
+    EnginePipeline_t* pipeline_p;
+    olidx_engine_t engine;
+    pthread_t thread;
+} EngineDecoder_t;
+
+static void* read_stage(void* argument_p)
+{
+    EnginePipeline_t* pipeline_p = argument_p;
+    uint32_t number = 0;
+    for(;;)
+    {
+        ScannedMessage_t message = {NULL, 0, 0, 1, SYSEX_CHECK_VALID, 0};
+        uint8_t* payload_p;
+        if(pipeline_p->scanning)
+        {
+            if(!scanner_next(&pipeline_p->scanner, &message))
+            {
+                break;
+            }
+            payload_p = malloc(message.length + 1);
+            memcpy(payload_p, message.payload_p, message.length);
+        }
+        else
+        {
+            payload_p = read_message(pipeline_p->midi_file_p, &message);
+            if(payload_p == NULL)
+            {
+                break;
+            }
+        }
+        sem_wait(&pipeline_p->window);
+        pipeline_queue_push(&pipeline_p->decode_queue, pipeline_new_job(++number, &message, payload_p));
+    }
+    pipeline_queue_close(&pipeline_p->decode_queue);
+    return NULL;
+}
+
+static void* decode_stage(void* argument_p)
+{
+    EngineDecoder_t* decoder_p = argument_p;
+    EnginePipeline_t* pipeline_p = decoder_p->pipeline_p;
+    olidx_engine_t* engine_p = &decoder_p->engine;
+    PipelineJob_t* job_p;
+    while((job_p = pipeline_queue_pop(&pipeline_p->decode_queue)) != NULL)
+    {
+        engine_p->file_number = job_p->number;
+        engine_p->job_p = job_p;
+        engine_p->log_p = open_memstream(&job_p->log_p, &job_p->log_length);
+        process_message(engine_p, &job_p->message);
+        fclose(engine_p->log_p);
+        pipeline_queue_push(&pipeline_p->write_queue, job_p);
+    }
+    if(__atomic_sub_fetch(&pipeline_p->decoder_count, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        pipeline_queue_close(&pipeline_p->write_queue);
+    }
+    return NULL;
+}
+
+static void index_job(olidx_engine_t* engine_p, const PipelineJob_t* job_p)
+{
+    if(engine_p->name_index_p == NULL)
+    {
+        return;
+    }
+    for(size_t file = 0; file < job_p->file_count; ++file)
+    {
+        const PipelineFile_t* file_p = job_p->files_p + file;
+        if(file_p->written && file_p->voice_name[0] != 0)
+        {
+            names_add(engine_p->name_index_p, file_p->voice_name, file_p->name_p);
+        }
+    }
+}
+
+/*
+ * writes the jobs in the calling thread, in the order of their numbers.
+ * returns the number of jobs written.
+ */
+static uint32_t write_stage(olidx_engine_t* engine_p, EnginePipeline_t* pipeline_p)
+{
+    PipelineReorder_t reorder = PIPELINE_REORDER_INITIALISER;
+    PipelineJob_t* job_p;
+    while((job_p = pipeline_queue_pop(&pipeline_p->write_queue)) != NULL)
+    {
+        pipeline_reorder_put(&reorder, job_p);
+        while((job_p = pipeline_reorder_take(&reorder)) != NULL)
+        {
+            pipeline_write_job(stdout, job_p, engine_p->manifest_p);
+            index_job(engine_p, job_p);
+            if(engine_p->dataset_p != NULL)
+            {
+                dataset_add(engine_p->dataset_p, job_p->voices_p, job_p->voice_count);
+            }
+            pipeline_free_job(job_p);
+            sem_post(&pipeline_p->window);
+        }
+    }
+    return reorder.next_number - 1;
+}
+
+/*
+ * decodes whole files of a folder, each one a job: its files are
+ * numbered from 1 as if it were decoded alone.
+ */
+static void* folder_stage(void* argument_p)
+{
+    EngineDecoder_t* decoder_p = argument_p;
+    EnginePipeline_t* pipeline_p = decoder_p->pipeline_p;
+    olidx_engine_t* engine_p = &decoder_p->engine;
+    for(;;)
+    {
+        //la place dans la fenêtre d'abord: les numéros en cours restent consécutifs.
+        sem_wait(&pipeline_p->window);
+        size_t path = __atomic_fetch_add(&pipeline_p->next_path, 1, __ATOMIC_RELAXED);
+        if(path >= pipeline_p->path_count)
+        {
+            sem_post(&pipeline_p->window);
+            break;
+        }
+        ScannedMessage_t message = {NULL, 0, 0, 1, SYSEX_CHECK_VALID, 0};
+        PipelineJob_t* job_p = pipeline_new_job(path + 1, &message, NULL);
+        engine_p->file_root_p = pipeline_p->paths_pp[path];
+        engine_p->root_p = engine_p->file_root_p + pipeline_p->root_offset;
+        engine_p->input_number = path + 1;
+        engine_p->file_number = 0;
+        engine_p->job_p = job_p;
+        engine_p->log_p = open_memstream(&job_p->log_p, &job_p->log_length);
+        fprintf(engine_p->log_p, "==============\nFile: %s\n", engine_p->file_root_p);
+        decode_file(engine_p);
+        fclose(engine_p->log_p);
+        pipeline_queue_push(&pipeline_p->write_queue, job_p);
+    }
+    if(__atomic_sub_fetch(&pipeline_p->decoder_count, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        pipeline_queue_close(&pipeline_p->write_queue);
+    }
+    return NULL;
+}
+
+int run_pipeline(olidx_engine_t* engine_p, int thread_count)
+{
+    EnginePipeline_t pipeline;
+    pipeline.engine_p = engine_p;
+    pipeline.midi_file_p = NULL;
+    pipeline.scanning = engine_p->recover || smf_is_file(engine_p->file_root_p);
+    if(pipeline.scanning)
+    {
+        if(scanner_open_file(&pipeline.scanner, engine_p->file_root_p, engine_p->recover))
+        {
+            printf("can't open file: %s\n", engine_p->file_root_p);
+            return -1;
+        }
+    }
+    else
+    {
+        pipeline.midi_file_p = fopen(engine_p->file_root_p, "r");
+        if(!pipeline.midi_file_p)
+        {
+            printf("can't open file: %s\n", engine_p->file_root_p);
+            return -1;
+        }
+    }
+    pipeline_queue_init(&pipeline.decode_queue);
+    pipeline_queue_init(&pipeline.write_queue);
+    sem_init(&pipeline.window, 0, PIPELINE_WINDOW);
+    pipeline.decoder_count = thread_count;
+
+    //chaque décodeur a sa propre copie du moteur: banque et rapport privés.
+    EngineDecoder_t* decoders_p = malloc(thread_count * sizeof(EngineDecoder_t));
+    for(int decoder = 0; decoder < thread_count; ++decoder)
+    {
+        decoders_p[decoder].pipeline_p = &pipeline;
+        decoders_p[decoder].engine = *engine_p;
+        decoders_p[decoder].engine.validation_report = VALIDATION_REPORT_INITIALISER;
+        subscribe_engine(&decoders_p[decoder].engine);
+        pthread_create(&decoders_p[decoder].thread, NULL, decode_stage, decoders_p + decoder);
+    }
+    pthread_t reader;
+    pthread_create(&reader, NULL, read_stage, &pipeline);
+
+    engine_p->file_number = write_stage(engine_p, &pipeline);
+
+    pthread_join(reader, NULL);
+    for(int decoder = 0; decoder < thread_count; ++decoder)
+    {
+        pthread_join(decoders_p[decoder].thread, NULL);
+        dx7_merge_validation_report(&engine_p->validation_report,
+                                    &decoders_p[decoder].engine.validation_report);
+    }
+    free(decoders_p);
+    sem_destroy(&pipeline.window);
+    pipeline_queue_destroy(&pipeline.decode_queue);
+    pipeline_queue_destroy(&pipeline.write_queue);
+    if(pipeline.scanning)
+    {
+        if(engine_p->recover)
+        {
+            printf("--------------\n");
+            scanner_print_statistics(stdout, &pipeline.scanner.statistics);
+        }
+        scanner_close(&pipeline.scanner);
+    }
+    else
+    {
+        fclose(pipeline.midi_file_p);
+    }
+    return 0;
+}
+
+static int compare_roots(const void* first_p, const void* second_p)
+{
+    const char* first_root_p = *(const char* const*) first_p;
+    const char* second_root_p = *(const char* const*) second_p;
+    size_t first_length = path_get_root_length(first_root_p);
+    size_t second_length = path_get_root_length(second_root_p);
+    int result = memcmp(first_root_p, second_root_p, (first_length < second_length) ? first_length : second_length);
+    return (result != 0) ? result : (first_length > second_length) - (first_length < second_length);
+}
+
+/*
+ * two files whose relative paths differ only by their extension would
+ * write to the same outputs.
+ * returns the number of such pairs, each one printed.
+ */
+static size_t check_folder_roots(char* const* paths_pp, size_t path_count, size_t root_offset)
+{
+    if(path_count < 2)
+    {
+        return 0;
+    }
+    const char** roots_pp = malloc(path_count * sizeof(const char*));
+    for(size_t path = 0; path < path_count; ++path)
+    {
+        roots_pp[path] = paths_pp[path] + root_offset;
+    }
+    qsort(roots_pp, path_count, sizeof(const char*), compare_roots);
+    size_t collision_count = 0;
+    for(size_t path = 1; path < path_count; ++path)
+    {
+        if(compare_roots(roots_pp + path - 1, roots_pp + path) == 0)
+        {
+            printf("same output names for %s and %s\n", roots_pp[path - 1], roots_pp[path]);
+            ++collision_count;
+        }
+    }
+    free(roots_pp);
+    return collision_count;
+}
+
+int run_folder(olidx_engine_t* engine_p, int thread_count)
+{
+    const char* const extensions[] = {MIDI_SYSEX_EXTENSION, SMF_EXTENSION, NULL};
+    size_t decoder_count = (thread_count > 0) ? thread_count : 1;
+    Walker_t walker;
+    if(walker_walk(&walker, engine_p->file_root_p, decoder_count, extensions))
+    {
+        printf("can't open folder: %s\n", engine_p->file_root_p);
+        return -1;
+    }
+    printf("%zu files in %u folders\n", walker.path_count, walker.folder_count);
+    size_t root_offset = strlen(engine_p->file_root_p) + 1;
+    if(engine_p->unpack_folder_p != NULL && check_folder_roots(walker.paths_pp, walker.path_count, root_offset) > 0)
+    {
+        walker_free(&walker);
+        return -1;
+    }
+    EnginePipeline_t pipeline;
+    pipeline.engine_p = engine_p;
+    pipeline.midi_file_p = NULL;
+    pipeline.scanning = 0;
+    pipeline.paths_pp = walker.paths_pp;
+    pipeline.path_count = walker.path_count;
+    pipeline.root_offset = root_offset;
+    pipeline.next_path = 0;
+    pipeline_queue_init(&pipeline.write_queue);
+    sem_init(&pipeline.window, 0, PIPELINE_WINDOW);
+    pipeline.decoder_count = decoder_count;
+
+    EngineDecoder_t* decoders_p = malloc(decoder_count * sizeof(EngineDecoder_t));
+    for(size_t decoder = 0; decoder < decoder_count; ++decoder)
+    {
+        decoders_p[decoder].pipeline_p = &pipeline;
+        decoders_p[decoder].engine = *engine_p;
+        decoders_p[decoder].engine.validation_report = VALIDATION_REPORT_INITIALISER;
+        subscribe_engine(&decoders_p[decoder].engine);
+        pthread_create(&decoders_p[decoder].thread, NULL, folder_stage, decoders_p + decoder);
+    }
+    write_stage(engine_p, &pipeline);
+    engine_p->file_number = 0;
+
+    for(size_t decoder = 0; decoder < decoder_count; ++decoder)
+    {
+        pthread_join(decoders_p[decoder].thread, NULL);
+        dx7_merge_validation_report(&engine_p->validation_report,
+                                    &decoders_p[decoder].engine.validation_report);
+    }
+    free(decoders_p);
+    sem_destroy(&pipeline.window);
+    pipeline_queue_destroy(&pipeline.write_queue);
+    walker_free(&walker);
+    return 0;
+}
+
 const char* option_handler(int argc, char* argv[], ProgramOptions_t* options_p)
 {
     int opt;
     int flag_b = 0;
-    char* folder_name_p = NULL;
+    const char* folder_name_p = NULL;
     char* file_name_p = NULL;
-    while(-1 != (opt = getopt(argc, argv, ":f:hu:")))
+    while(-1 != (opt = getopt(argc, argv, ":e:f:hj:n:o:q:r:st:u:z:")))
     {
         switch(opt)
         {
+            case 'e':
+                if(options_p != NULL)
+                {
+                    options_p->dataset_type = dataset_get_type(optarg);
+                    if(options_p->dataset_type == DATASET_TYPE_COUNT)
+                    {
+                        printf("unknown dataset type: %s\n", optarg);
+                    }
+                }
+            break;
             case 'f':
                 file_name_p = optarg;
             break;
             case 'h':
                 printf("%s", get_help());
             break;
+            case 'j':
+                if(options_p != NULL)
+                {
+                    options_p->thread_count = atoi(optarg);
+                    if(options_p->thread_count < 0)
+                    {
+                        printf("invalid thread count: %s\n", optarg);
+                        options_p->thread_count = 0;
+                    }
+                }
+            break;
+            case 'n':
+                if(options_p != NULL)
+                {
+                    options_p->shard_rows = strtoull(optarg, NULL, 0);
+                }
+            break;
+            case 'o':
+                if(options_p != NULL)
+                {
+                    options_p->voice_template_p = optarg;
+                }
+            break;
+            case 'q':
+            case 'z':
+                if(options_p != NULL)
+                {
+                    options_p->query_p = optarg;
+                    options_p->similar = (opt == 'z');
+                }
+            break;
+            case 'r':
+                if(options_p != NULL)
+                {
+                    options_p->validation = dx7_get_validation_mode(optarg);
+                    if(options_p->validation == VALIDATION_MODE_COUNT)
+                    {
+                        printf("unknown validation mode: %s\n", optarg);
+                        options_p->validation = VALIDATION_OFF;
+                    }
+                }
+            break;
+            case 's':
+                if(options_p != NULL)
+                {
+                    options_p->recover = 1;
+                }
+            break;
+            case 't':
+                if(options_p != NULL)
+                {
+                    options_p->tuning_format = tuning_get_file_format(optarg);
+                    if(options_p->tuning_format == TUNING_FILE_COUNT)
+                    {
+                        //le format peut aussi être donné sans point.
+                        char extension[8] = ".";
+                        strncat(extension, optarg, sizeof(extension) - 2);
+                        options_p->tuning_format = tuning_get_file_format(extension);
+                    }
+                    if(options_p->tuning_format == TUNING_FILE_COUNT)
+                    {
+                        printf("unknown tuning format: %s\n", optarg);
+                    }
+                }
+            break;
             case 'u':
                 if(!flag_b)
                 {
                     flag_b = 1;
                     printf("unpack %s\n", optarg);
-                    folder_name_p = malloc(strlen(optarg) + 2);
-                    strcpy(folder_name_p, optarg);
+                    folder_name_p = optarg;
                     if(options_p != NULL)
                     {
-                        options_p->unpack = 1;
-                        options_p->unpack_folder_p = folder_name_p;
+                        path_init(&options_p->unpack_folder, optarg);
+                        path_append(&options_p->unpack_folder, "/");
+                        options_p->unpack_folder_p = path_get(&options_p->unpack_folder);
+                        options_p->unpack = (options_p->unpack_folder_p != NULL);
+                        if(!options_p->unpack)
+                        {
+                            printf("folder name too long: %s\n", optarg);
+                        }
                     }
                 }
                 else
@@ -117,71 +894,195 @@ const char* option_handler(int argc, char* argv[], ProgramOptions_t* options_p)
             break;
         }
     }
-    mkdir(folder_name_p, S_IRWXU | S_IRWXG | S_IRWXO);
-    if(flag_b)
+    if(folder_name_p != NULL)
     {
-        strcat(folder_name_p,"/");
+        mkdir(folder_name_p, S_IRWXU | S_IRWXG | S_IRWXO);
     }
 
     return file_name_p;
 }
 
-void process_sysex_data(const void* data_p, size_t length, const ProgramOptions_t* options_p)
+void process_message(olidx_engine_t* engine_p, const ScannedMessage_t* message_p)
 {
+    FILE* log_p = engine_p->log_p;
+    fprintf(log_p, "--------------\n");
+    fprintf(log_p, "Payload no: %u\n", engine_p->file_number);
+    engine_p->slot = 0;
+    if(!engine_p->recover)
+    {
+        fprintf(log_p, "Sysex size: %dB\n", (int) message_p->length);
+        process_sysex_data(engine_p, message_p->payload_p, message_p->length);
+        return;
+    }
+    fprintf(log_p, "Offset:     %zu\n", message_p->offset);
+    fprintf(log_p, "Sysex size: %zuB%s\n", message_p->length, message_p->terminated ? "" : " (unterminated)");
+    fprintf(log_p, "Check:      %s\n", SYSEX_CHECK_NAME_TABLE[message_p->check]);
+    switch(message_p->check)
+    {
+        case SYSEX_CHECK_TRUNCATED:
+        case SYSEX_CHECK_CHECKSUM:
+            if(message_p->salvaged_voice_count == 0)
+            {
+                fprintf(log_p, "skipped\n");
+                break;
+            }
+            fprintf(log_p, "salvaged voices: %d\n", message_p->salvaged_voice_count);
+            __attribute__((fallthrough));
+        default:
+            process_sysex_data(engine_p, message_p->payload_p, message_p->length);
+        break;
+    }
+}
+
+/*
+ * messages of other devices are logged and written as they are, straight
+ * from the input buffer, after the number of the message and the codec.
+ */
+static void process_foreign_data(olidx_engine_t* engine_p,
+                                 const SysexIdentity_t* identity_p,
+                                 const void* data_p,
+                                 size_t length)
+{
+    codec_print_identity(engine_p->log_p, identity_p);
+    events_dispatch(&engine_p->dispatcher, data_p, length);
+    if(engine_p->unpack_folder_p == NULL)
+    {
+        return;
+    }
+    PathBuilder_t path;
+    start_path(engine_p, &path);
+    path_append_relative_root(&path, get_engine_root(engine_p));
+    path_append_counter(&path, engine_p->file_number);
+    path_append(&path, "_");
+    path_append(&path, (identity_p->codec_p != NULL) ? identity_p->codec_p->name_p : CODEC_UNKNOWN_NAME);
+    path_append(&path, MIDI_SYSEX_EXTENSION);
+    write_sysex_file(engine_p, path_get(&path), data_p, length);
+}
+
+void process_sysex_data(olidx_engine_t* engine_p, const void* data_p, size_t length)
+{
+    if(engine_p->codecs_p != NULL)
+    {
+        SysexIdentity_t identity = codec_identify(engine_p->codecs_p, data_p, length);
+        if(identity.codec_p != &DX7_CODEC)
+        {
+            process_foreign_data(engine_p, &identity, data_p, length);
+            return;
+        }
+    }
     SysExData_t* sysex_p = dx7_get_sysex(data_p, length);
-    char* file_name_p;
-    FILE* file_p;
-    char* temp_name_p;
+    dx7_print_sysex(engine_p->log_p, data_p, length, sysex_p);
+    PathBuilder_t path;
+    events_dispatch(&engine_p->dispatcher, data_p, length);
     switch(sysex_p->type)
     {
         case SYSEX_TYPE_BULK:
-            if(process_sysex_bulk_data(&sysex_p->bulk_data))
+            if(process_sysex_bulk_data(engine_p, &sysex_p->bulk_data))
             {
                 break;
             }
-            /* no break */
+            __attribute__((fallthrough));
         case SYSEX_TYPE_PARAMETER:
         default:
-            temp_name_p = strip_extension(path_to_file_name(olidx_engine.file_root_p));
-            append_counter(&temp_name_p, olidx_engine.file_number);
-            file_name_p = file_name(temp_name_p);
-            free(temp_name_p);
-            file_p = fopen(file_name_p, "w+");
-            if(file_p == NULL)
-            {
-                OK(OH NON);
-            }
-            else
+            //sans dossier de déballage, rien n'est écrit.
+            if(engine_p->unpack_folder_p == NULL)
             {
-                printf("writing file: %s\n", file_name_p);
+                break;
             }
-            midi_write_sysex_payload(file_p, data_p, length);
-            fclose(file_p);
-            free(file_name_p);
-            file_name_p = NULL;
-            file_p = NULL;
+            start_path(engine_p, &path);
+            path_append_relative_root(&path, get_engine_root(engine_p));
+            path_append_counter(&path, engine_p->file_number);
+            path_append(&path, MIDI_SYSEX_EXTENSION);
+            write_sysex_file(engine_p, path_get(&path), data_p, length);
         break;
     }
-    free(sysex_p);
+    dx7_free_sysex(sysex_p);
+}
+
+static void write_engine_file(olidx_engine_t* engine_p,
+                              const char* file_name_p,
+                              const uint8_t* payload_p,
+                              size_t length,
+                              int sysex,
+                              const char* voice_name_p)
+{
+    if(file_name_p == NULL)
+    {
+        fprintf(engine_p->log_p, "file name too long\n");
+        return;
+    }
+    ManifestSequence_t sequence = {engine_p->input_number, engine_p->file_number, ++engine_p->slot};
+    //dans le pipeline, l'écriture attend son tour.
+    if(engine_p->job_p != NULL)
+    {
+        pipeline_add_file(engine_p->job_p, &sequence, file_name_p, payload_p, length, sysex, voice_name_p);
+        fprintf(engine_p->log_p, "writing file: %s\n", file_name_p);
+        return;
+    }
+    FILE* file_p = path_open(file_name_p, "w+");
+    if(file_p == NULL)
+    {
+        fprintf(engine_p->log_p, "can't write file: %s\n", file_name_p);
+        return;
+    }
+    fprintf(engine_p->log_p, "writing file: %s\n", file_name_p);
+    if(sysex)
+    {
+        midi_write_sysex_payload(file_p, payload_p, length);
+    }
+    else
+    {
+        fwrite(payload_p, sizeof(uint8_t), length, file_p);
+    }
+    fclose(file_p);
+    if(engine_p->manifest_p != NULL)
+    {
+        manifest_add(engine_p->manifest_p, &sequence, file_name_p, payload_p, length, sysex);
+    }
+    if(voice_name_p != NULL && engine_p->name_index_p != NULL)
+    {
+        names_add(engine_p->name_index_p, voice_name_p, file_name_p);
+    }
+}
+
+void write_sysex_file(olidx_engine_t* engine_p,
+                      const char* file_name_p,
+                      const uint8_t* payload_p,
+                      size_t length)
+{
+    write_engine_file(engine_p, file_name_p, payload_p, length, 1, NULL);
+}
+
+void write_voice_file(olidx_engine_t* engine_p,
+                      const char* file_name_p,
+                      const uint8_t* payload_p,
+                      size_t length,
+                      const char* voice_name_p)
+{
+    write_engine_file(engine_p, file_name_p, payload_p, length, 1, voice_name_p);
+}
+
+void write_raw_file(olidx_engine_t* engine_p,
+                    const char* file_name_p,
+                    const uint8_t* data_p,
+                    size_t length)
+{
+    write_engine_file(engine_p, file_name_p, data_p, length, 0, NULL);
 }
 
-int process_sysex_bulk_data(const BulkDataPayload_t* bulk_data_p)
+int process_sysex_bulk_data(olidx_engine_t* engine_p, const BulkDataPayload_t* bulk_data_p)
 {
     switch(bulk_data_p->type)
     {
         case BULK_DATA_PACKED_32_VOICE:
-            if(olidx_engine.unpack)
-            {
-                //TODO: déballage complet. et déballage simple
-                unpack_packed32_voice(*bulk_data_p->packed32_voice_p);
-            }
-            else
+            //déballé par les abonnés aux évènements.
+            if(!engine_p->unpack)
             {
                 return 1;
             }
         break;
         case BULK_DATA_UNIVERSAL_BULK_DUMP:
-            process_sysex_universal_bulk_data(&bulk_data_p->universal);
+            process_sysex_universal_bulk_data(engine_p, &bulk_data_p->universal);
         break;
         default:
         break;
@@ -189,7 +1090,8 @@ int process_sysex_bulk_data(const BulkDataPayload_t* bulk_data_p)
     return 0;
 }
 
-int process_sysex_universal_bulk_data(const UniversalBulkDataPayload_t* bulk_data_p)
+int process_sysex_universal_bulk_data(olidx_engine_t* engine_p,
+                                      const UniversalBulkDataPayload_t* bulk_data_p)
 {
     switch(bulk_data_p->type)
     {
@@ -202,9 +1104,9 @@ int process_sysex_universal_bulk_data(const UniversalBulkDataPayload_t* bulk_dat
         case UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE:
         case UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER:
         case UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_CARTRIDGE:
-        case UNIVERSAL_BULK_DATA_COUNT:
-            printf("Universal: %s\n", UNIVERSAL_BULK_DATA_NAME_TABLE[bulk_data_p->type]);
+            fprintf(engine_p->log_p, "Universal: %s\n", UNIVERSAL_BULK_DATA_NAME_TABLE[bulk_data_p->type]);
             break;
+        case UNIVERSAL_BULK_DATA_COUNT:
         case UNIVERSAL_BULK_DATA_ERROR:
         default:
             break;
@@ -212,47 +1114,154 @@ int process_sysex_universal_bulk_data(const UniversalBulkDataPayload_t* bulk_dat
     return 0;
 }
 
-void unpack_packed32_voice(const Packed32Voice_t voice_parameters)
+void unpack_voice_handler(const SysexEvent_t* event_p, void* user_p)
 {
+    olidx_engine_t* engine_p = user_p;
+    if(event_p->voice.format == BULK_DATA_PACKED_32_VOICE)
+    {
+        memcpy(engine_p->bank[event_p->voice.index].data, event_p->voice.bytes_p, PACKED_VOICE_SIZE);
+    }
+}
+
+void export_voice_handler(const SysexEvent_t* event_p, void* user_p)
+{
+    olidx_engine_t* engine_p = user_p;
+    VoiceParameters_t voice;
+    if(event_p->voice.format == BULK_DATA_PACKED_32_VOICE)
+    {
+        voice = dx7_decode_packed_voice(event_p->voice.bytes_p);
+    }
+    else
+    {
+        memcpy(&voice, event_p->voice.bytes_p, BYTE_COUNT_VOICE_EDIT_BUFFER);
+    }
+    //dans le pipeline, l'export attend son tour comme les fichiers.
+    if(engine_p->job_p != NULL)
+    {
+        pipeline_add_voice(engine_p->job_p, &voice);
+    }
+    else
+    {
+        dataset_add(engine_p->dataset_p, &voice, 1);
+    }
+}
+
+void unpack_bank_handler(const SysexEvent_t* event_p, void* user_p)
+{
+    olidx_engine_t* engine_p = user_p;
+    if(event_p->bank.format != BULK_DATA_PACKED_32_VOICE)
+    {
+        return;
+    }
+    PackedVoiceParameters_t* voices = engine_p->bank;
     SysExData_t sysex_message;
     sysex_message.type = SYSEX_TYPE_BULK;
     sysex_message.bulk_data.type = BULK_DATA_VOICE_EDIT_BUFFER;
-    VoiceParameters_t parameters;
-    sysex_message.bulk_data.payload_p = &parameters;
     int voice;
+    PathBuilder_t path;
+    start_path(engine_p, &path);
+    size_t folder_length = path.length;
+    PathValues_t values = {get_engine_root(engine_p), engine_p->file_number, 0, NULL, 0, 0};
+    if(engine_p->validation != VALIDATION_OFF)
+    {
+        int invalid_count = dx7_validate_packed_voices(voices,
+                                                       VOICE_COUNT,
+                                                       engine_p->validation,
+                                                       &engine_p->validation_report);
+        fprintf(engine_p->log_p, "invalid voices: %d\n", invalid_count);
+    }
     for(voice = 0; voice < VOICE_COUNT; ++voice)
     {
-        parameters =  dx7_unpack_voice_parameters(voice_parameters[voice]);
-        char* patch_name_p = dx7_copy_patch_name(parameters);
-        printf("patch %2d: %*s ", voice+1, VOICE_NAME_SIZE, patch_name_p);
-        char* file_root_p = strip_extension(path_to_file_name(olidx_engine.file_root_p));
-        append_counter(&file_root_p, olidx_engine.file_number);
-        append_counter(&file_root_p, voice+1);
-        append_str(&file_root_p, "_");
-        append_str(&file_root_p, patch_name_p);
-        char* file_name_p = file_name(file_root_p);
-        FILE* file_p = fopen(file_name_p, "w+");
+        VoiceParameters_t parameters = dx7_decode_packed_voice(voices[voice].data);
+        sysex_message.bulk_data.payload_p = &parameters;
+        char patch_name_p[VOICE_NAME_SIZE + 1];
+        dx7_get_patch_name(&parameters, patch_name_p);
+        fprintf(engine_p->log_p, "patch %2d: %*s ", voice+1, VOICE_NAME_SIZE, patch_name_p);
+        path_truncate(&path, folder_length);
+        values.voice = voice + 1;
+        values.name_p = patch_name_p;
+        values.name_length = strlen(patch_name_p);
+        values.hash = path_hash(&parameters, sizeof(parameters));
+        path_append_template(&path, engine_p->voice_template_p, &values);
+        path_append(&path, MIDI_SYSEX_EXTENSION);
         size_t length;
         uint8_t* payload_p = dx7_format_sysex(&sysex_message,
                                               &length,
                                               0);
-        printf("writing file: %s\n", file_name_p);
-        midi_write_sysex_payload(file_p, payload_p, length);
-        fclose(file_p);
+        write_voice_file(engine_p, path_get(&path), payload_p, length, patch_name_p);
         free(payload_p);
-        free(file_name_p);
-        free(file_root_p);
-        free(patch_name_p);
     }
 }
 
-char* file_name(const char* root_p)
+void export_tuning_handler(const SysexEvent_t* event_p, void* user_p)
 {
-    char* file_name_p = malloc(strlen(olidx_engine.unpack_folder_p) + 1);
-    strcpy(file_name_p, olidx_engine.unpack_folder_p);
-    append_str(&file_name_p, root_p);
-    append_str(&file_name_p, MIDI_SYSEX_EXTENSION);
-    return file_name_p;
+    olidx_engine_t* engine_p = user_p;
+    switch(event_p->universal.format)
+    {
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_0:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_1:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE:
+        break;
+        default:
+            return;
+    }
+    if(event_p->universal.length != sizeof(MicroTuningParameters_t))
+    {
+        return;
+    }
+    TuningTable_t table;
+    int invalid_count = tuning_decode((const MicroTuningParameter_t*) event_p->universal.data_p, &table);
+    PathBuilder_t path;
+    start_path(engine_p, &path);
+    size_t folder_length = path.length;
+    path_append_relative_root(&path, get_engine_root(engine_p));
+    path_append_counter(&path, engine_p->file_number);
+    path_append_counter(&path, event_p->universal.index + 1);
+    //le nom sans dossier sert de description.
+    char file_root[PATH_CAPACITY];
+    strcpy(file_root, path.text + folder_length);
+    path_append(&path, TUNING_FILE_EXTENSION_TABLE[engine_p->tuning_format]);
+    char* text_p = NULL;
+    size_t text_length = 0;
+    FILE* text_file_p = open_memstream(&text_p, &text_length);
+    tuning_write_file(text_file_p, &table, engine_p->tuning_format, file_root);
+    fclose(text_file_p);
+    fprintf(engine_p->log_p, "tuning %2d: %d notes out of range ", event_p->universal.index + 1, invalid_count);
+    write_raw_file(engine_p, path_get(&path), (const uint8_t*) text_p, text_length);
+    free(text_p);
+}
+
+int import_tuning(olidx_engine_t* engine_p, TuningFileFormat_t format)
+{
+    FILE* tuning_file_p = fopen(engine_p->file_root_p, "r");
+    if(tuning_file_p == NULL)
+    {
+        printf("can't open file: %s\n", engine_p->file_root_p);
+        return -1;
+    }
+    TuningTable_t table;
+    int result = tuning_read_file(tuning_file_p, &table, format);
+    fclose(tuning_file_p);
+    if(result)
+    {
+        printf("no tuning in file: %s\n", engine_p->file_root_p);
+        return -1;
+    }
+    size_t length;
+    uint8_t* payload_p = tuning_format_sysex(&table, 1, 0, &length);
+    PathBuilder_t path;
+    start_path(engine_p, &path);
+    path_append_relative_root(&path, get_engine_root(engine_p));
+    path_append(&path, MIDI_SYSEX_EXTENSION);
+    write_sysex_file(engine_p, path_get(&path), payload_p, length);
+    free(payload_p);
+    return 0;
+}
+
+void start_path(const olidx_engine_t* engine_p, PathBuilder_t* path_p)
+{
+    path_init(path_p, engine_p->unpack_folder_p);
 }
 
 
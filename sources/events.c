@@ -0,0 +1,163 @@
+/*
+ * events.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include "events.h"
+#include "midi.h"
+#include "utility.h"
+
+const SysexDispatcher_t SYSEX_DISPATCHER_INITIALISER =
+{
+    {{NULL, NULL, 0}},
+    0,
+    0
+};
+
+int events_subscribe(SysexDispatcher_t* dispatcher_p,
+                     SysexEventHandler_t handler,
+                     void* user_p,
+                     uint32_t mask)
+{
+    if(dispatcher_p->subscriber_count >= SYSEX_SUBSCRIBER_COUNT)
+    {
+        return -1;
+    }
+    SysexSubscriber_t* subscriber_p = dispatcher_p->subscribers + dispatcher_p->subscriber_count++;
+    subscriber_p->handler = handler;
+    subscriber_p->user_p = user_p;
+    subscriber_p->mask = mask;
+    return 0;
+}
+
+static void events_raise(const SysexDispatcher_t* dispatcher_p,
+                         SysexEventType_t type,
+                         SysexEvent_t* event_p)
+{
+    event_p->type = type;
+    for(size_t subscriber = 0; subscriber < dispatcher_p->subscriber_count; ++subscriber)
+    {
+        const SysexSubscriber_t* subscriber_p = dispatcher_p->subscribers + subscriber;
+        if(subscriber_p->mask & SYSEX_EVENT_MASK(type))
+        {
+            subscriber_p->handler(event_p, subscriber_p->user_p);
+        }
+    }
+}
+
+static void events_dispatch_universal(const SysexDispatcher_t* dispatcher_p,
+                                      SysexEvent_t* event_p,
+                                      const uint8_t* head_p,
+                                      const uint8_t* end_p)
+{
+    //[compte][LM  xxxxxx][données][checksum], répété jusqu'à la fin du message.
+    for(int index = 0; end_p - head_p >= (long) sizeof(TwoByte_t); ++index)
+    {
+        TwoByte_t byte_count = {head_p[0], head_p[1]};
+        size_t count = get_payload_size(byte_count);
+        head_p += sizeof(TwoByte_t);
+        //l'en-tête, les données et le checksum du bloc doivent tenir avant la fin.
+        if(count < sizeof(UniversalBulkDataHeader_t)
+        || (size_t) (end_p - head_p) < count + sizeof(uint8_t))
+        {
+            event_p->check = SYSEX_CHECK_TRUNCATED;
+            events_raise(dispatcher_p, SYSEX_EVENT_CHECK_ERROR, event_p);
+            return;
+        }
+        const UniversalBulkDataHeader_t* header_p = (const UniversalBulkDataHeader_t*) head_p;
+        event_p->universal.format = dx7_get_universal_bulk_data_header(header_p);
+        event_p->universal.index = index;
+        event_p->universal.header_p = header_p;
+        event_p->universal.data_p = head_p + sizeof(UniversalBulkDataHeader_t);
+        event_p->universal.length = count - sizeof(UniversalBulkDataHeader_t);
+        events_raise(dispatcher_p, SYSEX_EVENT_UNIVERSAL_BLOCK, event_p);
+        head_p += count + sizeof(uint8_t);
+    }
+}
+
+void events_dispatch(SysexDispatcher_t* dispatcher_p,
+                     const uint8_t* payload_p,
+                     size_t length)
+{
+    SysexEvent_t event;
+    event.message_index = dispatcher_p->message_index++;
+    event.payload_p = payload_p;
+    event.length = length;
+    event.header = (length >= SYSEX_HEADER_SIZE) ? dx7_decode_sysex_header(payload_p)
+                                                  : SYSEX_HEADER_INITIALISER;
+    events_raise(dispatcher_p, SYSEX_EVENT_MESSAGE, &event);
+    if(length < SYSEX_HEADER_SIZE || event.header.id != MIDI_ID_YAMAHA)
+    {
+        return;
+    }
+    switch(event.header.substatus)
+    {
+        case SYSEX_TYPE_PARAMETER:
+            event.parameter = dx7_get_sysex_parameter(payload_p + SYSEX_HEADER_SIZE,
+                                                      length - SYSEX_HEADER_SIZE);
+            events_raise(dispatcher_p, SYSEX_EVENT_PARAMETER_CHANGE, &event);
+        break;
+        case SYSEX_TYPE_BULK:
+        {
+            event.check = dx7_check_sysex(payload_p, length, NULL);
+            if(event.check != SYSEX_CHECK_VALID)
+            {
+                events_raise(dispatcher_p, SYSEX_EVENT_CHECK_ERROR, &event);
+                //un checksum faux laisse complet un dump de voix, pas les blocs d'un dump universel.
+                if(event.check != SYSEX_CHECK_CHECKSUM
+                || payload_p[SYSEX_HEADER_SIZE] == BULK_DATA_FORMAT_UNIVERSAL_BULK_DUMP)
+                {
+                    return;
+                }
+            }
+            const uint8_t* head_p = payload_p + SYSEX_HEADER_SIZE;
+            BulkData_t format = dx7_get_bulk_data_header((const BulkDataHeader_t*) head_p);
+            head_p += BULK_HEADER_SIZE;
+            TwoByte_t byte_count = {head_p[0], head_p[1]};
+            size_t count = get_payload_size(byte_count);
+            if(format != BULK_DATA_UNIVERSAL_BULK_DUMP
+            && format != BULK_DATA_MALFORMED
+            && count != BULK_DATA_BYTE_COUNT_TABLE[format])
+            {
+                event.check = (count < BULK_DATA_BYTE_COUNT_TABLE[format]) ? SYSEX_CHECK_TRUNCATED
+                                                                          : SYSEX_CHECK_TOO_LONG;
+                events_raise(dispatcher_p, SYSEX_EVENT_CHECK_ERROR, &event);
+                return;
+            }
+            switch(format)
+            {
+                case BULK_DATA_PACKED_32_VOICE:
+                    event.bank.format = format;
+                    event.bank.voice_count = VOICE_COUNT;
+                    events_raise(dispatcher_p, SYSEX_EVENT_BANK_START, &event);
+                    for(int voice = 0; voice < VOICE_COUNT; ++voice)
+                    {
+                        event.voice.format = format;
+                        event.voice.index = voice;
+                        event.voice.bytes_p = head_p + sizeof(TwoByte_t) + voice * PACKED_VOICE_SIZE;
+                        events_raise(dispatcher_p, SYSEX_EVENT_VOICE, &event);
+                    }
+                    event.bank.format = format;
+                    event.bank.voice_count = VOICE_COUNT;
+                    events_raise(dispatcher_p, SYSEX_EVENT_BANK_END, &event);
+                break;
+                case BULK_DATA_VOICE_EDIT_BUFFER:
+                    event.voice.format = format;
+                    event.voice.index = 0;
+                    event.voice.bytes_p = head_p + sizeof(TwoByte_t);
+                    events_raise(dispatcher_p, SYSEX_EVENT_VOICE, &event);
+                break;
+                case BULK_DATA_UNIVERSAL_BULK_DUMP:
+                    events_dispatch_universal(dispatcher_p, &event, head_p, payload_p + length);
+                break;
+                default:
+                break;
+            }
+        }
+        break;
+        default:
+        break;
+    }
+}
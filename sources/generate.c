@@ -0,0 +1,268 @@
+/*
+ * generate.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "generate.h"
+#include "events.h"
+#include "help.h"
+#include "midi.h"
+#include "path.h"
+#include "scanner.h"
+
+typedef struct GenerateSeeds_t
+{
+    VoiceParameters_t* voices_p;
+    size_t capacity;
+    size_t count;
+} GenerateSeeds_t;
+
+static void generate_seed_handler(const SysexEvent_t* event_p, void* user_p)
+{
+    GenerateSeeds_t* seeds_p = user_p;
+    if(seeds_p->count == seeds_p->capacity)
+    {
+        return;
+    }
+    if(event_p->voice.format == BULK_DATA_PACKED_32_VOICE)
+    {
+        seeds_p->voices_p[seeds_p->count++] = dx7_decode_packed_voice(event_p->voice.bytes_p);
+    }
+    else if(event_p->voice.format == BULK_DATA_VOICE_EDIT_BUFFER)
+    {
+        memcpy(&seeds_p->voices_p[seeds_p->count++], event_p->voice.bytes_p, BYTE_COUNT_VOICE_EDIT_BUFFER);
+    }
+}
+
+int generate_read_seeds(const char* file_name_p, VoiceParameters_t* seeds_p, size_t capacity)
+{
+    SysexScanner_t scanner;
+    if(scanner_open_file(&scanner, file_name_p, 0))
+    {
+        return -1;
+    }
+    GenerateSeeds_t seeds = {seeds_p, capacity, 0};
+    SysexDispatcher_t dispatcher = SYSEX_DISPATCHER_INITIALISER;
+    events_subscribe(&dispatcher, generate_seed_handler, &seeds, SYSEX_EVENT_MASK(SYSEX_EVENT_VOICE));
+    ScannedMessage_t message;
+    while(scanner_next(&scanner, &message))
+    {
+        events_dispatch(&dispatcher, message.payload_p, message.length);
+    }
+    scanner_close(&scanner);
+    //les parents hors limites donneraient des enfants hors limites.
+    dx7_validate_voices(seeds_p, seeds.count, VALIDATION_CLAMP, NULL);
+    return seeds.count;
+}
+
+void generate_bank(const GenerateOptions_t* options_p,
+                   const VoiceParameters_t* seeds_p,
+                   size_t seed_count,
+                   uint64_t bank,
+                   VoiceParameters_t* voices_p)
+{
+    GeneratorRandom_t random;
+    generator_seed(&random, options_p->seed, bank);
+    for(int voice = 0; voice < VOICE_COUNT; ++voice)
+    {
+        if(seed_count > 0)
+        {
+            uint64_t bits = generator_next(&random);
+            generator_crossover(&random,
+                                &seeds_p[((uint32_t) bits * (uint64_t) seed_count) >> 32],
+                                &seeds_p[((bits >> 32) * seed_count) >> 32],
+                                &voices_p[voice]);
+            generator_mutate(&random, &voices_p[voice], options_p->mutation_rate);
+        }
+        else
+        {
+            generator_random_voice(&random, &voices_p[voice]);
+        }
+        generator_name_voice(&voices_p[voice], bank * VOICE_COUNT + voice);
+    }
+}
+
+static void* generate_thread(void* argument_p)
+{
+    GenerateThread_t* thread_p = argument_p;
+    thread_p->result = -1;
+    FILE* file_p = path_open(thread_p->file_name_p, "wb");
+    if(file_p == NULL)
+    {
+        return NULL;
+    }
+    setvbuf(file_p, NULL, _IOFBF, GENERATE_BUFFER_SIZE);
+    VoiceParameters_t voices[VOICE_COUNT];
+    Packed32Voice_t packed_voices;
+    SysExData_t sysex_data;
+    sysex_data.type = SYSEX_TYPE_BULK;
+    sysex_data.bulk_data.type = BULK_DATA_PACKED_32_VOICE;
+    sysex_data.bulk_data.packed32_voice_p = &packed_voices;
+    int result = 0;
+    for(uint64_t bank = thread_p->first_bank;
+        bank < thread_p->first_bank + thread_p->bank_count && result == 0;
+        ++bank)
+    {
+        generate_bank(thread_p->options_p, thread_p->seeds_p, thread_p->seed_count, bank, voices);
+        for(int voice = 0; voice < VOICE_COUNT; ++voice)
+        {
+            packed_voices[voice] = dx7_pack_voice_parameters(voices[voice]);
+        }
+        size_t length;
+        uint8_t* payload_p = dx7_format_sysex(&sysex_data, &length, 0);
+        if(payload_p == NULL || midi_write_sysex_payload(file_p, payload_p, length) <= 0)
+        {
+            result = -1;
+        }
+        free(payload_p);
+    }
+    if(fclose(file_p) == 0)
+    {
+        thread_p->result = result;
+    }
+    return NULL;
+}
+
+static int generate_options(int argc, char* argv[], GenerateOptions_t* options_p)
+{
+    int opt;
+    optind = 1;
+    while(-1 != (opt = getopt(argc, argv, ":f:hj:m:n:s:u:")))
+    {
+        switch(opt)
+        {
+            case 'f':
+                options_p->seed_file_p = optarg;
+            break;
+            case 'h':
+                printf("%s", get_help());
+            break;
+            case 'j':
+                options_p->thread_count = atoi(optarg);
+                if(options_p->thread_count < 1)
+                {
+                    printf("invalid thread count: %s\n", optarg);
+                    options_p->thread_count = 1;
+                }
+            break;
+            case 'm':
+            {
+                int percent = atoi(optarg);
+                percent = (percent < 0) ? 0 : (percent > 100) ? 100 : percent;
+                options_p->mutation_rate = (percent * 255 + 50) / 100;
+            }
+            break;
+            case 'n':
+                options_p->voice_count = strtoull(optarg, NULL, 0);
+            break;
+            case 's':
+                options_p->seed = strtoull(optarg, NULL, 0);
+            break;
+            case 'u':
+                options_p->folder_p = optarg;
+            break;
+            case ':':
+                printf("error %c\n", optopt);
+                return -1;
+            default:
+                printf("unknown option %c\n", optopt);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+int run_generator(int argc, char* argv[])
+{
+    GenerateOptions_t options = {VOICE_COUNT, 1, 0, NULL, 0, ""};
+    if(generate_options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    VoiceParameters_t* seeds_p = NULL;
+    int seed_count = 0;
+    if(options.seed_file_p != NULL)
+    {
+        seeds_p = malloc(GENERATE_SEED_CAPACITY * sizeof(VoiceParameters_t));
+        seed_count = generate_read_seeds(options.seed_file_p, seeds_p, GENERATE_SEED_CAPACITY);
+        if(seed_count <= 0)
+        {
+            printf("no seed voice in file: %s\n", options.seed_file_p);
+            free(seeds_p);
+            return EXIT_FAILURE;
+        }
+        printf("seed voices: %d\n", seed_count);
+    }
+
+    uint64_t bank_count = (options.voice_count + VOICE_COUNT - 1) / VOICE_COUNT;
+    if((uint64_t) options.thread_count > bank_count)
+    {
+        options.thread_count = (bank_count > 0) ? bank_count : 1;
+    }
+    GenerateThread_t* threads_p = calloc(options.thread_count, sizeof(GenerateThread_t));
+    pthread_t* thread_ids_p = calloc(options.thread_count, sizeof(pthread_t));
+    int* started_p = calloc(options.thread_count, sizeof(int));
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    uint64_t first_bank = 0;
+    for(int thread = 0; thread < options.thread_count; ++thread)
+    {
+        GenerateThread_t* thread_p = &threads_p[thread];
+        thread_p->options_p = &options;
+        thread_p->seeds_p = seeds_p;
+        thread_p->seed_count = seed_count;
+        thread_p->first_bank = first_bank;
+        thread_p->bank_count = bank_count / options.thread_count + ((uint64_t) thread < bank_count % options.thread_count);
+        first_bank += thread_p->bank_count;
+        PathBuilder_t path;
+        path_init(&path, options.folder_p);
+        path_append(&path, GENERATE_FILE_ROOT);
+        path_append_counter(&path, thread);
+        path_append(&path, GENERATE_EXTENSION);
+        thread_p->file_name_p = strdup(path.text);
+        started_p[thread] = !pthread_create(&thread_ids_p[thread], NULL, generate_thread, thread_p);
+        if(!started_p[thread])
+        {
+            generate_thread(thread_p);
+        }
+    }
+    int result = EXIT_SUCCESS;
+    for(int thread = 0; thread < options.thread_count; ++thread)
+    {
+        if(started_p[thread])
+        {
+            pthread_join(thread_ids_p[thread], NULL);
+        }
+        if(threads_p[thread].result)
+        {
+            printf("can't write file: %s\n", threads_p[thread].file_name_p);
+            result = EXIT_FAILURE;
+        }
+        free(threads_p[thread].file_name_p);
+    }
+    //un fil en échec n'a pas tout écrit: pas de débit.
+    if(result == EXIT_SUCCESS)
+    {
+        struct timespec end_time;
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        double seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) * 1e-9;
+        uint64_t voice_count = bank_count * VOICE_COUNT;
+        printf("voices: %llu in %.3f s, %.0f voices/s\n",
+               (unsigned long long) voice_count,
+               seconds,
+               (seconds > 0) ? voice_count / seconds : 0.0);
+    }
+    free(started_p);
+    free(thread_ids_p);
+    free(threads_p);
+    free(seeds_p);
+    return result;
+}
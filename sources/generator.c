@@ -0,0 +1,123 @@
+/*
+ * generator.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "generator.h"
+
+#define GENERATOR_DIGITS "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define GENERATOR_BASE   36
+
+static uint64_t generator_split_mix(uint64_t* state_p)
+{
+    uint64_t value = (*state_p += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+static inline uint64_t generator_rotate(uint64_t value, int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+void generator_seed(GeneratorRandom_t* random_p, uint64_t seed, uint64_t stream)
+{
+    uint64_t state = seed ^ generator_split_mix(&stream);
+    for(int word = 0; word < 4; ++word)
+    {
+        random_p->state[word] = generator_split_mix(&state);
+    }
+}
+
+uint64_t generator_next(GeneratorRandom_t* random_p)
+{
+    uint64_t* state = random_p->state;
+    uint64_t result = generator_rotate(state[1] * 5, 7) * 9;
+    uint64_t shifted = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = generator_rotate(state[3], 45);
+    return result;
+}
+
+/*
+ * returns a value in [0, range[ from 32 random bits.
+ */
+static inline uint8_t generator_bounded(uint32_t bits, uint32_t range)
+{
+    return ((uint64_t) bits * range) >> 32;
+}
+
+void generator_random_voice(GeneratorRandom_t* random_p, VoiceParameters_t* voice_p)
+{
+    uint8_t* bytes_p = (uint8_t*) voice_p;
+    //deux tirages de 32 bits par appel.
+    for(int byte = 0; byte < GENERATOR_PARAMETER_COUNT; byte += 2)
+    {
+        uint64_t bits = generator_next(random_p);
+        bytes_p[byte] = VOICE_MINIMUM_TABLE[byte]
+                      + generator_bounded(bits, VOICE_MAXIMUM_TABLE[byte] - VOICE_MINIMUM_TABLE[byte] + 1);
+        if(byte + 1 < GENERATOR_PARAMETER_COUNT)
+        {
+            bytes_p[byte + 1] = VOICE_MINIMUM_TABLE[byte + 1]
+                              + generator_bounded(bits >> 32,
+                                                  VOICE_MAXIMUM_TABLE[byte + 1] - VOICE_MINIMUM_TABLE[byte + 1] + 1);
+        }
+    }
+}
+
+void generator_crossover(GeneratorRandom_t* random_p,
+                         const VoiceParameters_t* mother_p,
+                         const VoiceParameters_t* father_p,
+                         VoiceParameters_t* child_p)
+{
+    uint64_t bits = generator_next(random_p);
+    for(int operator = 0; operator < OPERATOR_COUNT; ++operator, bits >>= 1)
+    {
+        child_p->Operator[operator] = (bits & 1) ? father_p->Operator[operator] : mother_p->Operator[operator];
+    }
+    const uint8_t* mother_bytes_p = (const uint8_t*) mother_p;
+    const uint8_t* father_bytes_p = (const uint8_t*) father_p;
+    uint8_t* child_bytes_p = (uint8_t*) child_p;
+    for(int byte = sizeof(child_p->Operator); byte < GENERATOR_PARAMETER_COUNT; ++byte, bits >>= 1)
+    {
+        child_bytes_p[byte] = (bits & 1) ? father_bytes_p[byte] : mother_bytes_p[byte];
+    }
+    memcpy(child_p->voice_name, mother_p->voice_name, VOICE_NAME_SIZE);
+}
+
+void generator_mutate(GeneratorRandom_t* random_p, VoiceParameters_t* voice_p, uint8_t rate)
+{
+    uint8_t* bytes_p = (uint8_t*) voice_p;
+    for(int byte = 0; byte < GENERATOR_PARAMETER_COUNT; ++byte)
+    {
+        uint64_t bits = generator_next(random_p);
+        if((uint8_t) bits >= rate)
+        {
+            continue;
+        }
+        int minimum = VOICE_MINIMUM_TABLE[byte];
+        int maximum = VOICE_MAXIMUM_TABLE[byte];
+        int amount = (maximum - minimum) / 8 + 1;
+        int value = bytes_p[byte] + (int) generator_bounded(bits >> 32, 2 * amount + 1) - amount;
+        bytes_p[byte] = (value < minimum) ? minimum : (value > maximum) ? maximum : value;
+    }
+}
+
+void generator_name_voice(VoiceParameters_t* voice_p, uint64_t number)
+{
+    const size_t prefix_size = sizeof(GENERATOR_NAME_PREFIX) - 1;
+    memcpy(voice_p->voice_name, GENERATOR_NAME_PREFIX, prefix_size);
+    for(size_t character = VOICE_NAME_SIZE; character > prefix_size; --character, number /= GENERATOR_BASE)
+    {
+        voice_p->voice_name[character - 1] = GENERATOR_DIGITS[number % GENERATOR_BASE];
+    }
+}
@@ -5,12 +5,80 @@
  *      Author: moliver
  */
 #include "help.h"
+#include "manifest.h"
+#include "path.h"
 
 static const char* const HELP_TEXT =
 "help\n"
+"-e <type>   : export the voices as u8 or normalised f32 rows of <file root>.npy\n"
+"              with their columns in <file root>.schema.json\n"
 "-f <file>   : open file <file>\n"
+"              a .tun or .scl <file> is converted to a micro tuning dump\n"
+"              a .mid <file> is read through the SysEx events of its tracks\n"
+"              a folder is walked, its .syx and .mid files decoded in path order\n"
+"              and unpacked under their path relative to the folder\n"
 "-h          : show this help\n"
-"-u <folder> : unpack into <folder>\n"
+"-j <count>  : decode with <count> threads, reading and writing in parallel,\n"
+"              or walk a folder and decode its files with <count> threads\n"
+"-n <count>  : split the export in files of <count> voices, <file root>_<n>.npy\n"
+"-o <text>   : name unpacked voices after the template <text>, with the fields\n"
+"              {root} {file} {voice} {name} {hash} and {shard}, e.g. {shard}/{hash}\n"
+"              default: " PATH_VOICE_TEMPLATE "\n"
+"-q <text>   : find the voice names containing <text> in the name index <file>\n"
+"-r <mode>   : validate unpacked voices: check, clamp or reset\n"
+"-s          : recover damaged dumps: check, resynchronise and salvage\n"
+"-t <format> : export micro tunings as tun or scl files while unpacking\n"
+"-u <folder> : unpack into <folder>, indexing voice names in <folder>/names.idx\n"
+"              and listing every file written, with its hash, in <folder>/" MANIFEST_FILE_NAME "\n"
+"-z <text>   : find the voice names close to <text> in the name index <file>\n"
+"\n"
+"generate    : write random Packed32 banks as <folder>generated_<thread>.syx\n"
+"-f <file>   : breed the voices from the banks of <file> instead\n"
+"-j <count>  : generate with <count> threads\n"
+"-m <percent>: mutate each bred parameter with probability <percent>\n"
+"-n <count>  : generate <count> voices, rounded up to whole banks\n"
+"-s <seed>   : random seed, the same seed gives the same banks\n"
+"-u <folder> : write into <folder>\n"
+"\n"
+"send <files>: send the SysEx messages of <files> to every port at once\n"
+"-c <count>  : write <count> bytes between two pauses\n"
+"-d <type>   : file (file or FIFO, the default) or raw (MIDI device)\n"
+"-g <ms>     : wait <ms> after each message, 100 by default\n"
+"-i <device> : format the dumps again for device number <device>, 1 to 16\n"
+"-p <port>   : send to <port>, can be repeated\n"
+"-r <rate>   : send <rate> bytes per ms, 3.125 by default (MIDI), 0 unpaced\n"
+"\n"
+"backup      : request every memory of every device and unpack the replies\n"
+"-c <count>  : write <count> bytes between two pauses\n"
+"-d <type>   : file (file or FIFO, the default) or raw (MIDI device)\n"
+"-g <ms>     : wait <ms> after each request, 100 by default\n"
+"-i <device> : request from device number <device>, 1 to 16, 1 by default\n"
+"-p <out>[:<in>]: send the requests to <out> and read the replies from <in>,\n"
+"              <out> itself without <in>, can be repeated\n"
+"-r <rate>   : send <rate> bytes per ms, 3.125 by default (MIDI), 0 unpaced\n"
+"-u <folder> : unpack into <folder>, indexing voice names in <folder>/names.idx\n"
+"              and listing every file written, with its hash, in <folder>/" MANIFEST_FILE_NAME "\n"
+"\n"
+"simulate    : run a DX7II-FD on every port, answering until its input closes\n"
+"-c <count>  : write <count> bytes between two pauses\n"
+"-d <type>   : file (file or FIFO, the default) or raw (MIDI device)\n"
+"-f <file>   : load the dumps of <file> into every device first\n"
+"-g <ms>     : wait <ms> after each reply, 100 by default\n"
+"-i <device> : answer as device number <device>, 1 to 16, 1 by default\n"
+"-l <ms>     : wait <ms> before each reply\n"
+"-p <out>[:<in>]: reply on <out> to the messages read from <in>,\n"
+"              <out> itself without <in>, can be repeated\n"
+"-r <rate>   : reply at <rate> bytes per ms, 3.125 by default (MIDI), 0 unpaced\n"
+"\n"
+"convert <files or folders>: convert every dump to one format, in one pass,\n"
+"              as <folder>/<path>_<format>.syx, the .syx and .mid files of folders included\n"
+"-i <device> : write for device number <device>, 1 to 16, 1 by default\n"
+"-j <count>  : walk folders and convert <count> files at once\n"
+"-m <ms>     : write type 0 .mid files instead, <ms> between two messages\n"
+"-r <mode>   : validate the voices written: check, clamp or reset\n"
+"-t, --to <format>: vced or vmem (voices), aced or amem (supplements),\n"
+"              pced or pmem (performances), banks completed with initial records\n"
+"-u <folder> : write into <folder>, the current folder by default\n"
 ;
 
 
@@ -1,13 +1,39 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "utility.h"
 #include "dx7.h"
 #include "midi.h"
 #include "engine.h"
+#include "generate.h"
+#include "send.h"
+#include "backup.h"
+#include "simulate.h"
+#include "convert.h"
 
 int main(int argc, char* argv[])
 {
+	if(argc > 1 && strcmp(argv[1], GENERATE_COMMAND) == 0)
+	{
+		return run_generator(argc - 1, argv + 1);
+	}
+	if(argc > 1 && strcmp(argv[1], SEND_COMMAND) == 0)
+	{
+		return run_sender(argc - 1, argv + 1);
+	}
+	if(argc > 1 && strcmp(argv[1], BACKUP_COMMAND) == 0)
+	{
+		return run_backup(argc - 1, argv + 1);
+	}
+	if(argc > 1 && strcmp(argv[1], SIMULATE_COMMAND) == 0)
+	{
+		return run_simulator(argc - 1, argv + 1);
+	}
+	if(argc > 1 && strcmp(argv[1], CONVERT_COMMAND) == 0)
+	{
+		return run_converter(argc - 1, argv + 1);
+	}
 	return run_engine(argc, argv);
 }
 
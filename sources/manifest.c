@@ -0,0 +1,173 @@
+/*
+ * manifest.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "manifest.h"
+#include "midi.h"
+#include "path.h"
+
+int manifest_compare_sequences(const ManifestSequence_t* left_p, const ManifestSequence_t* right_p)
+{
+    if(left_p->input != right_p->input)
+    {
+        return (left_p->input < right_p->input) ? -1 : 1;
+    }
+    if(left_p->message != right_p->message)
+    {
+        return (left_p->message < right_p->message) ? -1 : 1;
+    }
+    if(left_p->slot != right_p->slot)
+    {
+        return (left_p->slot < right_p->slot) ? -1 : 1;
+    }
+    return 0;
+}
+
+int manifest_open(Manifest_t* manifest_p, const char* folder_p)
+{
+    memset(manifest_p, 0, sizeof(Manifest_t));
+    PathBuilder_t path;
+    path_init(&path, folder_p);
+    path_append(&path, MANIFEST_FILE_NAME);
+    const char* path_p = path_get(&path);
+    manifest_p->file_p = (path_p != NULL) ? path_open(path_p, "w") : NULL;
+    if(manifest_p->file_p == NULL)
+    {
+        return -1;
+    }
+    manifest_p->folder_p = strdup(folder_p);
+    manifest_p->folder_length = strlen(folder_p);
+    fprintf(manifest_p->file_p, "# input:message:slot fnv1a64 size path\n");
+    return 0;
+}
+
+static void manifest_write(Manifest_t* manifest_p,
+                           const ManifestSequence_t* sequence_p,
+                           const char* path_p,
+                           uint64_t hash,
+                           uint64_t size)
+{
+    //chemins relatifs au dossier: le manifeste suit l'arborescence si elle est déplacée.
+    if(strncmp(path_p, manifest_p->folder_p, manifest_p->folder_length) == 0)
+    {
+        path_p += manifest_p->folder_length;
+    }
+    //une sortie réécrite à l'identique (voix répétée sous {hash}) n'est listée qu'une fois.
+    uint32_t count = manifest_p->paths.count;
+    uint32_t id = names_intern(&manifest_p->paths, path_p);
+    if(manifest_p->paths.count == count)
+    {
+        const ManifestEntry_t* entry_p = manifest_p->entries_p + id;
+        if((entry_p->hash != hash || entry_p->size != size) && manifest_p->conflict_count++ == 0)
+        {
+            manifest_p->conflict_id = id;
+        }
+        return;
+    }
+    if(id == manifest_p->entry_capacity)
+    {
+        manifest_p->entry_capacity = manifest_p->entry_capacity ? 2 * manifest_p->entry_capacity
+                                                                : MANIFEST_ENTRY_COUNT;
+        manifest_p->entries_p = realloc(manifest_p->entries_p,
+                                        manifest_p->entry_capacity * sizeof(ManifestEntry_t));
+    }
+    manifest_p->entries_p[id].hash = hash;
+    manifest_p->entries_p[id].size = size;
+    fprintf(manifest_p->file_p,
+            "%u:%u:%u %016llx %llu %s\n",
+            sequence_p->input,
+            sequence_p->message,
+            sequence_p->slot,
+            (unsigned long long) hash,
+            (unsigned long long) size,
+            path_p);
+    ++manifest_p->entry_count;
+}
+
+void manifest_add(Manifest_t* manifest_p,
+                  const ManifestSequence_t* sequence_p,
+                  const char* path_p,
+                  const uint8_t* data_p,
+                  size_t length,
+                  int sysex)
+{
+    uint64_t hash = PATH_HASH_SEED;
+    if(sysex)
+    {
+        const uint8_t start = MIDI_SYSTEM_EXCLUSIVE;
+        const uint8_t end = MIDI_EOX;
+        hash = path_hash_continue(hash, &start, 1);
+        hash = path_hash_continue(hash, data_p, length);
+        hash = path_hash_continue(hash, &end, 1);
+    }
+    else
+    {
+        hash = path_hash_continue(hash, data_p, length);
+    }
+    manifest_write(manifest_p, sequence_p, path_p, hash, length + (sysex ? 2 : 0));
+}
+
+int manifest_add_file(Manifest_t* manifest_p, const char* path_p)
+{
+    FILE* file_p = fopen(path_p, "rb");
+    if(file_p == NULL)
+    {
+        return -1;
+    }
+    uint8_t* buffer_p = malloc(MANIFEST_BUFFER_SIZE);
+    uint64_t hash = PATH_HASH_SEED;
+    uint64_t size = 0;
+    size_t length;
+    while((length = fread(buffer_p, 1, MANIFEST_BUFFER_SIZE, file_p)) > 0)
+    {
+        hash = path_hash_continue(hash, buffer_p, length);
+        size += length;
+    }
+    int result = ferror(file_p) ? -1 : 0;
+    fclose(file_p);
+    free(buffer_p);
+    if(result == 0)
+    {
+        ManifestSequence_t sequence = {MANIFEST_RUN_INPUT, 0, ++manifest_p->run_slot};
+        manifest_write(manifest_p, &sequence, path_p, hash, size);
+    }
+    return result;
+}
+
+int manifest_close(Manifest_t* manifest_p)
+{
+    int result = 0;
+    if(manifest_p->file_p != NULL && fclose(manifest_p->file_p))
+    {
+        result = -1;
+    }
+    manifest_p->file_p = NULL;
+    free(manifest_p->folder_p);
+    manifest_p->folder_p = NULL;
+    free(manifest_p->paths.text_p);
+    free(manifest_p->paths.offsets_p);
+    free(manifest_p->paths.slots_p);
+    memset(&manifest_p->paths, 0, sizeof(NameTable_t));
+    free(manifest_p->entries_p);
+    manifest_p->entries_p = NULL;
+    manifest_p->entry_capacity = 0;
+    return result;
+}
+
+void manifest_discard(Manifest_t* manifest_p)
+{
+    PathBuilder_t path;
+    path_init(&path, manifest_p->folder_p);
+    path_append(&path, MANIFEST_FILE_NAME);
+    manifest_close(manifest_p);
+    const char* path_p = path_get(&path);
+    if(path_p != NULL)
+    {
+        remove(path_p);
+    }
+}
@@ -14,41 +14,51 @@ const char* const MIDI_SYSEX_EXTENSION = ".syx";
 uint8_t* midi_get_next_sysex_payload(FILE* file_p, int* size_p)
 {
     int byte;
-    do
-    {
-        byte = getc(file_p);
-        if(byte == EOF)
-        {
-            break;
-        }
-    } while(byte != MIDI_SYSTEM_EXCLUSIVE);
-
     uint8_t* buffer_p = NULL;
     size_t payload_size = 0;
-    if(byte == MIDI_SYSTEM_EXCLUSIVE)
+    //un F0 isolé ou un message vide ne termine pas la lecture: on passe au suivant.
+    do
     {
-        long int position_start = ftell(file_p);
-
-        for(byte = getc(file_p); byte != MIDI_EOX; byte = getc(file_p))
+        free(buffer_p);
+        buffer_p = NULL;
+        do
         {
+            byte = getc(file_p);
             if(byte == EOF)
             {
                 break;
             }
-        }
+        } while(byte != MIDI_SYSTEM_EXCLUSIVE);
 
-        long int position_end = ftell(file_p);
-        payload_size = position_end - position_start - 1;
-        buffer_p = malloc(payload_size);
-        fseek(file_p, position_start, SEEK_SET);
-        fread(buffer_p, sizeof(uint8_t), payload_size, file_p);
+        if(byte == MIDI_SYSTEM_EXCLUSIVE)
+        {
+            long int position_start = ftell(file_p);
 
-        fseek(file_p, position_end, SEEK_SET);
-    }
+            //un octet de statut autre que EOX coupe le message: il est relu au prochain appel.
+            for(byte = getc(file_p); byte != EOF; byte = getc(file_p))
+            {
+                if(byte & MIDI_STATUS_BIT)
+                {
+                    break;
+                }
+            }
+
+            long int position_end = ftell(file_p);
+            payload_size = position_end - position_start - (byte != EOF);
+            buffer_p = malloc(payload_size + 1);
+            fseek(file_p, position_start, SEEK_SET);
+            payload_size = fread(buffer_p, sizeof(uint8_t), payload_size, file_p);
+
+            if(byte == MIDI_EOX || byte == EOF)
+            {
+                fseek(file_p, position_end, SEEK_SET);
+            }
+        }
+    } while(buffer_p != NULL && payload_size == 0);
 
     if(size_p)
     {
-        *size_p = (byte != EOF)? payload_size : EOF;
+        *size_p = (buffer_p != NULL)? (int) payload_size : EOF;
     }
 
     return buffer_p;
@@ -0,0 +1,637 @@
+/*
+ * names.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <string.h>
+
+#include "names.h"
+
+#define NAME_TABLE_SLOT_COUNT 1024U
+#define NAME_TABLE_TEXT_SIZE  4096U
+#define NAME_TRIGRAM_BITS     7
+
+const NameIndex_t NAME_INDEX_INITIALISER =
+{
+    {NULL, 0, 0, NULL, 0, 0, NULL, 0},
+    {NULL, 0, 0, NULL, 0, 0, NULL, 0},
+    NULL,
+    0,
+    0,
+    0,
+    0,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0
+};
+
+static uint32_t names_hash(const char* text_p)
+{
+    //FNV-1a
+    uint32_t hash = 2166136261U;
+    for(; *text_p; ++text_p)
+    {
+        hash = (hash ^ (uint8_t) *text_p) * 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t* names_find_slot(const NameTable_t* table_p, const char* text_p)
+{
+    uint32_t mask = table_p->slot_count - 1;
+    uint32_t slot = names_hash(text_p) & mask;
+    while(table_p->slots_p[slot] != 0
+       && strcmp(table_p->text_p + table_p->offsets_p[table_p->slots_p[slot] - 1], text_p) != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return table_p->slots_p + slot;
+}
+
+static void names_rehash(NameTable_t* table_p, uint32_t slot_count)
+{
+    free(table_p->slots_p);
+    table_p->slots_p = calloc(slot_count, sizeof(uint32_t));
+    table_p->slot_count = slot_count;
+    for(uint32_t id = 0; id < table_p->count; ++id)
+    {
+        *names_find_slot(table_p, table_p->text_p + table_p->offsets_p[id]) = id + 1;
+    }
+}
+
+uint32_t names_lookup(const NameTable_t* table_p, const char* text_p)
+{
+    if(table_p->slot_count == 0)
+    {
+        return NAME_NOT_FOUND;
+    }
+    uint32_t slot = *names_find_slot(table_p, text_p);
+    return slot ? slot - 1 : NAME_NOT_FOUND;
+}
+
+uint32_t names_intern(NameTable_t* table_p, const char* text_p)
+{
+    //au plus à moitié plein.
+    if(2 * (table_p->count + 1) > table_p->slot_count)
+    {
+        names_rehash(table_p, table_p->slot_count ? 2 * table_p->slot_count : NAME_TABLE_SLOT_COUNT);
+    }
+    uint32_t* slot_p = names_find_slot(table_p, text_p);
+    if(*slot_p != 0)
+    {
+        return *slot_p - 1;
+    }
+    uint32_t length = strlen(text_p) + 1;
+    if(table_p->text_length + length > table_p->text_capacity)
+    {
+        uint32_t capacity = table_p->text_capacity ? table_p->text_capacity : NAME_TABLE_TEXT_SIZE;
+        while(capacity < table_p->text_length + length)
+        {
+            capacity *= 2;
+        }
+        table_p->text_p = realloc(table_p->text_p, capacity);
+        table_p->text_capacity = capacity;
+    }
+    if(table_p->count == table_p->capacity)
+    {
+        table_p->capacity = table_p->capacity ? 2 * table_p->capacity : NAME_TABLE_SLOT_COUNT / 2;
+        table_p->offsets_p = realloc(table_p->offsets_p, table_p->capacity * sizeof(uint32_t));
+    }
+    memcpy(table_p->text_p + table_p->text_length, text_p, length);
+    table_p->offsets_p[table_p->count] = table_p->text_length;
+    table_p->text_length += length;
+    *slot_p = ++table_p->count;
+    return table_p->count - 1;
+}
+
+const char* names_get(const NameTable_t* table_p, uint32_t id)
+{
+    return (id < table_p->count) ? table_p->text_p + table_p->offsets_p[id] : NULL;
+}
+
+static uint64_t* names_find_pair(const NameIndex_t* index_p, uint64_t key)
+{
+    uint32_t mask = index_p->pair_slot_count - 1;
+    uint32_t slot = (uint32_t) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while(index_p->pairs_p[slot] != 0 && index_p->pairs_p[slot] != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return index_p->pairs_p + slot;
+}
+
+static void names_rehash_pairs(NameIndex_t* index_p, uint32_t slot_count)
+{
+    free(index_p->pairs_p);
+    index_p->pairs_p = calloc(slot_count, sizeof(uint64_t));
+    index_p->pair_slot_count = slot_count;
+    //les entrées lues d'un index précédent y entrent aussi.
+    for(uint32_t entry = 0; entry < index_p->entry_count; ++entry)
+    {
+        const NameEntry_t* entry_p = index_p->entries_p + entry;
+        uint64_t key = ((uint64_t) entry_p->name_id << 32 | entry_p->source_id) + 1;
+        *names_find_pair(index_p, key) = key;
+    }
+}
+
+void names_add(NameIndex_t* index_p, const char* name_p, const char* source_p)
+{
+    uint32_t name_id = names_intern(&index_p->names, name_p);
+    uint32_t source_id = names_intern(&index_p->sources, source_p);
+    //au plus à moitié plein.
+    if(2 * (index_p->entry_count + 1) > index_p->pair_slot_count)
+    {
+        uint32_t slot_count = index_p->pair_slot_count ? 2 * index_p->pair_slot_count : NAME_TABLE_SLOT_COUNT;
+        while(slot_count < 2 * (index_p->entry_count + 1))
+        {
+            slot_count *= 2;
+        }
+        names_rehash_pairs(index_p, slot_count);
+    }
+    //une exécution refaite sur les mêmes fichiers n'ajoute rien.
+    uint64_t key = ((uint64_t) name_id << 32 | source_id) + 1;
+    uint64_t* pair_p = names_find_pair(index_p, key);
+    if(*pair_p != 0)
+    {
+        return;
+    }
+    *pair_p = key;
+    if(index_p->entry_count == index_p->entry_capacity)
+    {
+        index_p->entry_capacity = index_p->entry_capacity ? 2 * index_p->entry_capacity : NAME_TABLE_SLOT_COUNT;
+        index_p->entries_p = realloc(index_p->entries_p, index_p->entry_capacity * sizeof(NameEntry_t));
+    }
+    NameEntry_t* entry_p = index_p->entries_p + index_p->entry_count++;
+    entry_p->name_id = name_id;
+    entry_p->source_id = source_id;
+}
+
+static int names_compare_key(const void* left_p, const void* right_p)
+{
+    uint64_t left = *(const uint64_t*) left_p;
+    uint64_t right = *(const uint64_t*) right_p;
+    return (left > right) - (left < right);
+}
+
+static int names_compare_trigram(const void* left_p, const void* right_p)
+{
+    uint32_t left = *(const uint32_t*) left_p;
+    uint32_t right = *(const uint32_t*) right_p;
+    return (left > right) - (left < right);
+}
+
+/*
+ * writes the distinct trigrams of a text, sorted, and returns their count.
+ * trigrams_p holds NAME_TEXT_SIZE + NAME_TRIGRAM_SIZE keys.
+ */
+static size_t names_get_trigrams(const char* text_p, int padded, uint32_t* trigrams_p)
+{
+    uint8_t text[NAME_TEXT_SIZE + NAME_TRIGRAM_SIZE + 1];
+    size_t length = 0;
+    if(padded)
+    {
+        text[length++] = ' ';
+        text[length++] = ' ';
+    }
+    for(; *text_p && length < NAME_TEXT_SIZE + 2; ++text_p)
+    {
+        text[length++] = toupper((uint8_t) *text_p) & 0x7F;
+    }
+    if(padded)
+    {
+        text[length++] = ' ';
+    }
+    if(length < NAME_TRIGRAM_SIZE)
+    {
+        return 0;
+    }
+    size_t count = length - NAME_TRIGRAM_SIZE + 1;
+    for(size_t position = 0; position < count; ++position)
+    {
+        trigrams_p[position] = text[position] << (2 * NAME_TRIGRAM_BITS)
+                             | text[position + 1] << NAME_TRIGRAM_BITS
+                             | text[position + 2];
+    }
+    qsort(trigrams_p, count, sizeof(uint32_t), names_compare_trigram);
+    size_t distinct = 1;
+    for(size_t position = 1; position < count; ++position)
+    {
+        if(trigrams_p[position] != trigrams_p[distinct - 1])
+        {
+            trigrams_p[distinct++] = trigrams_p[position];
+        }
+    }
+    return distinct;
+}
+
+static void names_free_index(NameIndex_t* index_p)
+{
+    free(index_p->trigrams_p);
+    free(index_p->trigram_starts_p);
+    free(index_p->postings_p);
+    free(index_p->name_trigram_counts_p);
+    free(index_p->name_starts_p);
+    free(index_p->name_entries_p);
+    index_p->trigrams_p = NULL;
+    index_p->trigram_starts_p = NULL;
+    index_p->postings_p = NULL;
+    index_p->name_trigram_counts_p = NULL;
+    index_p->name_starts_p = NULL;
+    index_p->name_entries_p = NULL;
+    index_p->trigram_count = 0;
+    index_p->indexed_count = 0;
+}
+
+void names_build(NameIndex_t* index_p)
+{
+    names_free_index(index_p);
+    uint32_t name_count = index_p->names.count;
+    uint32_t trigrams[NAME_TEXT_SIZE + NAME_TRIGRAM_SIZE];
+
+    //paires (trigramme, nom) triées: chaque liste sort triée par nom.
+    index_p->name_trigram_counts_p = malloc(name_count + 1);
+    size_t pair_count = 0;
+    for(uint32_t id = 0; id < name_count; ++id)
+    {
+        index_p->name_trigram_counts_p[id] = names_get_trigrams(names_get(&index_p->names, id), 1, trigrams);
+        pair_count += index_p->name_trigram_counts_p[id];
+    }
+    uint64_t* pairs_p = malloc((pair_count + 1) * sizeof(uint64_t));
+    size_t pair = 0;
+    for(uint32_t id = 0; id < name_count; ++id)
+    {
+        size_t count = names_get_trigrams(names_get(&index_p->names, id), 1, trigrams);
+        for(size_t trigram = 0; trigram < count; ++trigram)
+        {
+            pairs_p[pair++] = (uint64_t) trigrams[trigram] << 32 | id;
+        }
+    }
+    qsort(pairs_p, pair_count, sizeof(uint64_t), names_compare_key);
+
+    index_p->trigrams_p = malloc((pair_count + 1) * sizeof(uint32_t));
+    index_p->trigram_starts_p = malloc((pair_count + 1) * sizeof(uint32_t));
+    index_p->postings_p = malloc((pair_count + 1) * sizeof(uint32_t));
+    uint32_t trigram_count = 0;
+    for(pair = 0; pair < pair_count; ++pair)
+    {
+        uint32_t key = pairs_p[pair] >> 32;
+        if(trigram_count == 0 || index_p->trigrams_p[trigram_count - 1] != key)
+        {
+            index_p->trigrams_p[trigram_count] = key;
+            index_p->trigram_starts_p[trigram_count] = pair;
+            ++trigram_count;
+        }
+        index_p->postings_p[pair] = (uint32_t) pairs_p[pair];
+    }
+    index_p->trigram_starts_p[trigram_count] = pair_count;
+    index_p->trigram_count = trigram_count;
+    free(pairs_p);
+
+    //entrées groupées par nom, tri par dénombrement.
+    index_p->name_starts_p = calloc(name_count + 1, sizeof(uint32_t));
+    index_p->name_entries_p = malloc((index_p->entry_count + 1) * sizeof(uint32_t));
+    for(uint32_t entry = 0; entry < index_p->entry_count; ++entry)
+    {
+        ++index_p->name_starts_p[index_p->entries_p[entry].name_id + 1];
+    }
+    for(uint32_t id = 0; id < name_count; ++id)
+    {
+        index_p->name_starts_p[id + 1] += index_p->name_starts_p[id];
+    }
+    uint32_t* next_p = malloc((name_count + 1) * sizeof(uint32_t));
+    memcpy(next_p, index_p->name_starts_p, (name_count + 1) * sizeof(uint32_t));
+    for(uint32_t entry = 0; entry < index_p->entry_count; ++entry)
+    {
+        index_p->name_entries_p[next_p[index_p->entries_p[entry].name_id]++] = entry;
+    }
+    free(next_p);
+    index_p->indexed_count = name_count;
+}
+
+static const uint32_t* names_get_postings(const NameIndex_t* index_p, uint32_t trigram, size_t* count_p)
+{
+    const uint32_t* key_p = bsearch(&trigram,
+                                    index_p->trigrams_p,
+                                    index_p->trigram_count,
+                                    sizeof(uint32_t),
+                                    names_compare_trigram);
+    if(key_p == NULL)
+    {
+        *count_p = 0;
+        return NULL;
+    }
+    size_t key = key_p - index_p->trigrams_p;
+    *count_p = index_p->trigram_starts_p[key + 1] - index_p->trigram_starts_p[key];
+    return index_p->postings_p + index_p->trigram_starts_p[key];
+}
+
+size_t names_find(const NameIndex_t* index_p, const char* query_p, uint32_t* ids_p, size_t capacity)
+{
+    size_t found = 0;
+    uint32_t first_unindexed = 0;
+    uint32_t trigrams[NAME_TEXT_SIZE + NAME_TRIGRAM_SIZE];
+    size_t trigram_count = names_get_trigrams(query_p, 0, trigrams);
+    if(trigram_count > 0 && index_p->indexed_count > 0)
+    {
+        //la plus courte des listes de la requête, vérifiée nom par nom.
+        const uint32_t* postings_p = NULL;
+        size_t posting_count = SIZE_MAX;
+        for(size_t trigram = 0; trigram < trigram_count && posting_count > 0; ++trigram)
+        {
+            size_t count;
+            const uint32_t* candidates_p = names_get_postings(index_p, trigrams[trigram], &count);
+            if(count < posting_count)
+            {
+                postings_p = candidates_p;
+                posting_count = count;
+            }
+        }
+        for(size_t posting = 0; posting < posting_count; ++posting)
+        {
+            if(strcasestr(names_get(&index_p->names, postings_p[posting]), query_p) != NULL)
+            {
+                if(found < capacity)
+                {
+                    ids_p[found] = postings_p[posting];
+                }
+                ++found;
+            }
+        }
+        first_unindexed = index_p->indexed_count;
+    }
+    //requête trop courte, ou noms ajoutés depuis names_build.
+    for(uint32_t id = first_unindexed; id < index_p->names.count; ++id)
+    {
+        if(strcasestr(names_get(&index_p->names, id), query_p) != NULL)
+        {
+            if(found < capacity)
+            {
+                ids_p[found] = id;
+            }
+            ++found;
+        }
+    }
+    return found;
+}
+
+size_t names_find_similar(const NameIndex_t* index_p,
+                          const char* query_p,
+                          float threshold,
+                          NameMatch_t* matches_p,
+                          size_t capacity)
+{
+    uint32_t trigrams[NAME_TEXT_SIZE + NAME_TRIGRAM_SIZE];
+    size_t trigram_count = names_get_trigrams(query_p, 1, trigrams);
+    uint8_t* shared_p = calloc(index_p->indexed_count + 1, sizeof(uint8_t));
+    for(size_t trigram = 0; trigram < trigram_count; ++trigram)
+    {
+        size_t count;
+        const uint32_t* postings_p = names_get_postings(index_p, trigrams[trigram], &count);
+        for(size_t posting = 0; posting < count; ++posting)
+        {
+            ++shared_p[postings_p[posting]];
+        }
+    }
+    size_t found = 0;
+    size_t kept = 0;
+    for(uint32_t id = 0; id < index_p->indexed_count; ++id)
+    {
+        if(shared_p[id] == 0)
+        {
+            continue;
+        }
+        //Jaccard: trigrammes communs sur trigrammes réunis.
+        float score = (float) shared_p[id]
+                    / (trigram_count + index_p->name_trigram_counts_p[id] - shared_p[id]);
+        if(score < threshold)
+        {
+            continue;
+        }
+        ++found;
+        size_t position = (kept < capacity) ? kept++ : capacity;
+        while(position > 0 && matches_p[position - 1].score < score)
+        {
+            if(position < capacity)
+            {
+                matches_p[position] = matches_p[position - 1];
+            }
+            --position;
+        }
+        if(position < capacity)
+        {
+            matches_p[position].name_id = id;
+            matches_p[position].score = score;
+        }
+    }
+    free(shared_p);
+    return found;
+}
+
+void names_print(FILE* file_p, const NameIndex_t* index_p, uint32_t name_id)
+{
+    fprintf(file_p, "%s\n", names_get(&index_p->names, name_id));
+    if(name_id < index_p->indexed_count)
+    {
+        for(uint32_t entry = index_p->name_starts_p[name_id]; entry < index_p->name_starts_p[name_id + 1]; ++entry)
+        {
+            const NameEntry_t* entry_p = index_p->entries_p + index_p->name_entries_p[entry];
+            fprintf(file_p, "    %s\n", names_get(&index_p->sources, entry_p->source_id));
+        }
+        return;
+    }
+    for(uint32_t entry = 0; entry < index_p->entry_count; ++entry)
+    {
+        if(index_p->entries_p[entry].name_id == name_id)
+        {
+            fprintf(file_p, "    %s\n", names_get(&index_p->sources, index_p->entries_p[entry].source_id));
+        }
+    }
+}
+
+static int names_write_array(FILE* file_p, const void* data_p, size_t size, uint32_t count)
+{
+    //un tableau vide peut ne pas être alloué: rien à écrire après son compte.
+    if(fwrite(&count, sizeof(uint32_t), 1, file_p) != 1
+    || (count > 0 && fwrite(data_p, size, count, file_p) != count))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static void* names_read_array(FILE* file_p, size_t size, uint32_t* count_p)
+{
+    uint32_t count;
+    if(fread(&count, sizeof(uint32_t), 1, file_p) != 1)
+    {
+        return NULL;
+    }
+    void* data_p = malloc((size_t) count * size + 1);
+    if(data_p != NULL && fread(data_p, size, count, file_p) != count)
+    {
+        free(data_p);
+        return NULL;
+    }
+    *count_p = count;
+    return data_p;
+}
+
+int names_write(FILE* file_p, const NameIndex_t* index_p)
+{
+    if(index_p->indexed_count != index_p->names.count)
+    {
+        return -1;
+    }
+    uint32_t version = NAME_INDEX_VERSION;
+    uint32_t posting_count = index_p->trigram_starts_p[index_p->trigram_count];
+    if(fwrite(NAME_INDEX_MAGIC, NAME_INDEX_MAGIC_SIZE, 1, file_p) != 1
+    || fwrite(&version, sizeof(uint32_t), 1, file_p) != 1
+    || names_write_array(file_p, index_p->names.text_p, sizeof(char), index_p->names.text_length)
+    || names_write_array(file_p, index_p->names.offsets_p, sizeof(uint32_t), index_p->names.count)
+    || names_write_array(file_p, index_p->sources.text_p, sizeof(char), index_p->sources.text_length)
+    || names_write_array(file_p, index_p->sources.offsets_p, sizeof(uint32_t), index_p->sources.count)
+    || names_write_array(file_p, index_p->entries_p, sizeof(NameEntry_t), index_p->entry_count)
+    || names_write_array(file_p, index_p->trigrams_p, sizeof(uint32_t), index_p->trigram_count)
+    || names_write_array(file_p, index_p->trigram_starts_p, sizeof(uint32_t), index_p->trigram_count + 1)
+    || names_write_array(file_p, index_p->postings_p, sizeof(uint32_t), posting_count)
+    || names_write_array(file_p, index_p->name_trigram_counts_p, sizeof(uint8_t), index_p->indexed_count)
+    || names_write_array(file_p, index_p->name_starts_p, sizeof(uint32_t), index_p->indexed_count + 1)
+    || names_write_array(file_p, index_p->name_entries_p, sizeof(uint32_t), index_p->entry_count))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static int names_read_table(FILE* file_p, NameTable_t* table_p)
+{
+    table_p->text_p = names_read_array(file_p, sizeof(char), &table_p->text_length);
+    table_p->offsets_p = names_read_array(file_p, sizeof(uint32_t), &table_p->count);
+    if(table_p->text_p == NULL || table_p->offsets_p == NULL)
+    {
+        return -1;
+    }
+    for(uint32_t id = 0; id < table_p->count; ++id)
+    {
+        if(table_p->offsets_p[id] >= table_p->text_length)
+        {
+            return -1;
+        }
+    }
+    if(table_p->text_length > 0 && table_p->text_p[table_p->text_length - 1] != 0)
+    {
+        return -1;
+    }
+    table_p->text_capacity = table_p->text_length;
+    table_p->capacity = table_p->count;
+    uint32_t slot_count = NAME_TABLE_SLOT_COUNT;
+    while(slot_count < 2 * (table_p->count + 1))
+    {
+        slot_count *= 2;
+    }
+    names_rehash(table_p, slot_count);
+    return 0;
+}
+
+int names_read(FILE* file_p, NameIndex_t* index_p)
+{
+    *index_p = NAME_INDEX_INITIALISER;
+    char magic[NAME_INDEX_MAGIC_SIZE];
+    uint32_t version;
+    if(fread(magic, NAME_INDEX_MAGIC_SIZE, 1, file_p) != 1
+    || memcmp(magic, NAME_INDEX_MAGIC, NAME_INDEX_MAGIC_SIZE) != 0
+    || fread(&version, sizeof(uint32_t), 1, file_p) != 1
+    || version != NAME_INDEX_VERSION
+    || names_read_table(file_p, &index_p->names)
+    || names_read_table(file_p, &index_p->sources))
+    {
+        names_free(index_p);
+        return -1;
+    }
+    uint32_t starts_count = 0;
+    uint32_t posting_count = 0;
+    uint32_t name_count = 0;
+    uint32_t entry_count = 0;
+    index_p->entries_p = names_read_array(file_p, sizeof(NameEntry_t), &index_p->entry_count);
+    index_p->trigrams_p = names_read_array(file_p, sizeof(uint32_t), &index_p->trigram_count);
+    index_p->trigram_starts_p = names_read_array(file_p, sizeof(uint32_t), &starts_count);
+    index_p->postings_p = names_read_array(file_p, sizeof(uint32_t), &posting_count);
+    index_p->name_trigram_counts_p = names_read_array(file_p, sizeof(uint8_t), &index_p->indexed_count);
+    index_p->name_starts_p = names_read_array(file_p, sizeof(uint32_t), &name_count);
+    index_p->name_entries_p = names_read_array(file_p, sizeof(uint32_t), &entry_count);
+    index_p->entry_capacity = index_p->entry_count;
+    if(index_p->entries_p == NULL
+    || index_p->trigrams_p == NULL
+    || index_p->trigram_starts_p == NULL
+    || index_p->postings_p == NULL
+    || index_p->name_trigram_counts_p == NULL
+    || index_p->name_starts_p == NULL
+    || index_p->name_entries_p == NULL
+    || starts_count != index_p->trigram_count + 1
+    || index_p->indexed_count != index_p->names.count
+    || name_count != index_p->indexed_count + 1
+    || entry_count != index_p->entry_count)
+    {
+        names_free(index_p);
+        return -1;
+    }
+    //un index abîmé ne doit pas faire lire hors des tableaux.
+    for(uint32_t key = 0; key < starts_count; ++key)
+    {
+        if(index_p->trigram_starts_p[key] > posting_count)
+        {
+            names_free(index_p);
+            return -1;
+        }
+    }
+    for(uint32_t posting = 0; posting < posting_count; ++posting)
+    {
+        if(index_p->postings_p[posting] >= index_p->indexed_count)
+        {
+            names_free(index_p);
+            return -1;
+        }
+    }
+    for(uint32_t entry = 0; entry < entry_count; ++entry)
+    {
+        if(index_p->entries_p[entry].name_id >= index_p->names.count
+        || index_p->entries_p[entry].source_id >= index_p->sources.count
+        || index_p->name_entries_p[entry] >= entry_count)
+        {
+            names_free(index_p);
+            return -1;
+        }
+    }
+    for(uint32_t id = 0; id < name_count; ++id)
+    {
+        if(index_p->name_starts_p[id] > entry_count)
+        {
+            names_free(index_p);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void names_free(NameIndex_t* index_p)
+{
+    names_free_index(index_p);
+    free(index_p->names.text_p);
+    free(index_p->names.offsets_p);
+    free(index_p->names.slots_p);
+    free(index_p->sources.text_p);
+    free(index_p->sources.offsets_p);
+    free(index_p->sources.slots_p);
+    free(index_p->entries_p);
+    free(index_p->pairs_p);
+    *index_p = NAME_INDEX_INITIALISER;
+}
@@ -0,0 +1,184 @@
+/*
+ * olidx.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "olidx.h"
+#include "midi.h"
+
+#define OLIDX_INITIAL_CAPACITY 4096U
+
+struct OlidxContext_t
+{
+    OlidxCallback_t callback;
+    void* user_p;
+    uint8_t* buffer_p;
+    size_t capacity;
+    size_t length;
+    int in_message;
+    SysexDispatcher_t dispatcher;
+};
+
+OlidxContext_t* olidx_open(OlidxCallback_t callback, void* user_p)
+{
+    OlidxContext_t* context_p = malloc(sizeof(OlidxContext_t));
+    if(context_p == NULL)
+    {
+        return NULL;
+    }
+    context_p->callback = callback;
+    context_p->user_p = user_p;
+    context_p->buffer_p = malloc(OLIDX_INITIAL_CAPACITY);
+    context_p->capacity = OLIDX_INITIAL_CAPACITY;
+    context_p->length = 0;
+    context_p->in_message = 0;
+    context_p->dispatcher = SYSEX_DISPATCHER_INITIALISER;
+    if(context_p->buffer_p == NULL)
+    {
+        free(context_p);
+        return NULL;
+    }
+    return context_p;
+}
+
+int olidx_subscribe(OlidxContext_t* context_p,
+                    SysexEventHandler_t handler,
+                    void* user_p,
+                    uint32_t mask)
+{
+    return events_subscribe(&context_p->dispatcher, handler, user_p, mask);
+}
+
+static int olidx_append(OlidxContext_t* context_p, const uint8_t* bytes_p, size_t length)
+{
+    if(context_p->length + length > context_p->capacity)
+    {
+        size_t capacity = context_p->capacity;
+        while(capacity < context_p->length + length)
+        {
+            capacity *= 2;
+        }
+        uint8_t* buffer_p = realloc(context_p->buffer_p, capacity);
+        if(buffer_p == NULL)
+        {
+            return -1;
+        }
+        context_p->buffer_p = buffer_p;
+        context_p->capacity = capacity;
+    }
+    memcpy(context_p->buffer_p + context_p->length, bytes_p, length);
+    context_p->length += length;
+    return 0;
+}
+
+static void olidx_deliver(OlidxContext_t* context_p, int terminated)
+{
+    events_dispatch(&context_p->dispatcher, context_p->buffer_p, context_p->length);
+    if(context_p->callback != NULL)
+    {
+        OlidxMessage_t message;
+        SysExData_t* data_p = dx7_get_sysex(context_p->buffer_p, context_p->length);
+        message.payload_p = context_p->buffer_p;
+        message.length = context_p->length;
+        message.terminated = terminated;
+        message.check = dx7_check_sysex(context_p->buffer_p, context_p->length, NULL);
+        message.data_p = data_p;
+        context_p->callback(&message, context_p->user_p);
+        dx7_free_sysex(data_p);
+    }
+    context_p->length = 0;
+    context_p->in_message = 0;
+}
+
+size_t olidx_feed(OlidxContext_t* context_p, const uint8_t* bytes_p, size_t length)
+{
+    size_t message_count = 0;
+    size_t position = 0;
+    while(position < length)
+    {
+        if(!context_p->in_message)
+        {
+            const uint8_t* start_p = memchr(bytes_p + position, MIDI_SYSTEM_EXCLUSIVE, length - position);
+            if(start_p == NULL)
+            {
+                break;
+            }
+            position = start_p - bytes_p + 1;
+            context_p->in_message = 1;
+            context_p->length = 0;
+            continue;
+        }
+        size_t start = position;
+        while(position < length && !(bytes_p[position] & MIDI_STATUS_BIT))
+        {
+            ++position;
+        }
+        if(olidx_append(context_p, bytes_p + start, position - start))
+        {
+            //plus de mémoire: le message est abandonné.
+            context_p->in_message = 0;
+            context_p->length = 0;
+            continue;
+        }
+        if(position == length)
+        {
+            break;
+        }
+        uint8_t byte = bytes_p[position];
+        if(byte >= MIDI_REAL_TIME)
+        {
+            ++position;
+            continue;
+        }
+        olidx_deliver(context_p, byte == MIDI_EOX);
+        ++message_count;
+        //tout autre octet de statut est relu: un F0 ouvre le message suivant.
+        position += (byte == MIDI_EOX);
+    }
+    return message_count;
+}
+
+size_t olidx_finish(OlidxContext_t* context_p)
+{
+    if(!context_p->in_message)
+    {
+        return 0;
+    }
+    olidx_deliver(context_p, 0);
+    return 1;
+}
+
+void olidx_close(OlidxContext_t* context_p)
+{
+    if(context_p != NULL)
+    {
+        free(context_p->buffer_p);
+        free(context_p);
+    }
+}
+
+size_t olidx_encode(const SysExData_t* data_p,
+                    uint8_t device_id,
+                    uint8_t* buffer_p,
+                    size_t capacity)
+{
+    size_t payload_length = 0;
+    uint8_t* payload_p = dx7_format_sysex(data_p, &payload_length, device_id);
+    if(payload_p == NULL)
+    {
+        return 0;
+    }
+    size_t length = payload_length + 2;
+    if(buffer_p != NULL && length <= capacity)
+    {
+        buffer_p[0] = MIDI_SYSTEM_EXCLUSIVE;
+        memcpy(buffer_p + 1, payload_p, payload_length);
+        buffer_p[length - 1] = MIDI_EOX;
+    }
+    free(payload_p);
+    return length;
+}
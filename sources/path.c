@@ -0,0 +1,267 @@
+/*
+ * path.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "path.h"
+#include "utility.h"
+
+#define PATH_HEX_DIGITS "0123456789abcdef"
+
+const char* const PATH_FIELD_NAME_TABLE[PATH_FIELD_COUNT] =
+{
+    "root",
+    "file",
+    "voice",
+    "name",
+    "hash",
+    "shard"
+};
+
+void path_init(PathBuilder_t* path_p, const char* text_p)
+{
+    path_p->length = 0;
+    path_p->overflow = 0;
+    path_p->text[0] = 0;
+    if(text_p != NULL)
+    {
+        path_append(path_p, text_p);
+    }
+}
+
+int path_append_length(PathBuilder_t* path_p, const char* text_p, size_t length)
+{
+    if(length >= PATH_CAPACITY - path_p->length)
+    {
+        path_p->overflow = 1;
+        return -1;
+    }
+    memcpy(path_p->text + path_p->length, text_p, length);
+    path_p->length += length;
+    path_p->text[path_p->length] = 0;
+    return 0;
+}
+
+int path_append(PathBuilder_t* path_p, const char* text_p)
+{
+    return path_append_length(path_p, text_p, strlen(text_p));
+}
+
+int path_append_root(PathBuilder_t* path_p, const char* file_path_p)
+{
+    const char* name_p = path_to_file_name(file_path_p);
+    return path_append_length(path_p, name_p, path_get_root_length(name_p));
+}
+
+size_t path_get_root_length(const char* path_p)
+{
+    const char* extension_p = get_extension(path_to_file_name(path_p));
+    return (extension_p == NULL) ? strlen(path_p) : (size_t) (extension_p - path_p);
+}
+
+int path_append_relative_root(PathBuilder_t* path_p, const char* relative_path_p)
+{
+    return path_append_length(path_p, relative_path_p, path_get_root_length(relative_path_p));
+}
+
+int path_append_counter(PathBuilder_t* path_p, uint64_t counter)
+{
+    char suffix[FORMAT_UNSIGNED_SIZE + 1] = "_";
+    size_t length = format_unsigned(suffix + 1, counter, PATH_COUNTER_DIGITS);
+    return path_append_length(path_p, suffix, length + 1);
+}
+
+int path_append_name(PathBuilder_t* path_p, const char* name_p, size_t length)
+{
+    size_t start = path_p->length;
+    if(path_append_length(path_p, name_p, length))
+    {
+        return -1;
+    }
+    //nettoyé sur place, après la copie.
+    for(char* character_p = path_p->text + start; *character_p != 0; ++character_p)
+    {
+        if(!is_valid_byte(*character_p) || *character_p == '/')
+        {
+            *character_p = '_';
+        }
+    }
+    return 0;
+}
+
+void path_truncate(PathBuilder_t* path_p, size_t length)
+{
+    if(length < path_p->length)
+    {
+        path_p->length = length;
+        path_p->text[length] = 0;
+    }
+}
+
+const char* path_get(const PathBuilder_t* path_p)
+{
+    return path_p->overflow ? NULL : path_p->text;
+}
+
+static int path_add_segment(PathTemplate_t* template_p, PathField_t field, size_t offset, size_t length)
+{
+    if(template_p->segment_count == PATH_TEMPLATE_SEGMENT_COUNT)
+    {
+        return -1;
+    }
+    PathSegment_t* segment_p = template_p->segments + template_p->segment_count++;
+    segment_p->field = field;
+    segment_p->offset = offset;
+    segment_p->length = length;
+    return 0;
+}
+
+int path_compile_template(PathTemplate_t* template_p, const char* text_p)
+{
+    template_p->segment_count = 0;
+    size_t length = strlen(text_p);
+    if(length >= PATH_CAPACITY)
+    {
+        return -1;
+    }
+    memcpy(template_p->text, text_p, length + 1);
+    size_t position = 0;
+    while(position < length)
+    {
+        const char* open_p = strchr(template_p->text + position, '{');
+        size_t literal_end = (open_p == NULL) ? length : (size_t) (open_p - template_p->text);
+        if(literal_end > position && path_add_segment(template_p, PATH_FIELD_COUNT, position, literal_end - position))
+        {
+            return -1;
+        }
+        if(open_p == NULL)
+        {
+            break;
+        }
+        const char* close_p = strchr(open_p, '}');
+        if(close_p == NULL)
+        {
+            return -1;
+        }
+        size_t name_length = close_p - open_p - 1;
+        PathField_t field;
+        for(field = 0; field < PATH_FIELD_COUNT; ++field)
+        {
+            if(strlen(PATH_FIELD_NAME_TABLE[field]) == name_length
+               && strncmp(open_p + 1, PATH_FIELD_NAME_TABLE[field], name_length) == 0)
+            {
+                break;
+            }
+        }
+        if(field == PATH_FIELD_COUNT || path_add_segment(template_p, field, 0, 0))
+        {
+            return -1;
+        }
+        position = close_p - template_p->text + 1;
+    }
+    return 0;
+}
+
+static int path_append_hex(PathBuilder_t* path_p, uint64_t value, int digit_count)
+{
+    char digits[PATH_HASH_DIGITS];
+    for(int digit = digit_count - 1; digit >= 0; --digit, value >>= 4)
+    {
+        digits[digit] = PATH_HEX_DIGITS[value & 0xF];
+    }
+    return path_append_length(path_p, digits, digit_count);
+}
+
+int path_append_template(PathBuilder_t* path_p, const PathTemplate_t* template_p, const PathValues_t* values_p)
+{
+    char digits[FORMAT_UNSIGNED_SIZE];
+    for(size_t segment = 0; segment < template_p->segment_count; ++segment)
+    {
+        const PathSegment_t* segment_p = template_p->segments + segment;
+        switch(segment_p->field)
+        {
+            case PATH_FIELD_ROOT:
+                path_append_relative_root(path_p, values_p->root_p);
+            break;
+            case PATH_FIELD_FILE:
+            case PATH_FIELD_VOICE:
+            {
+                uint64_t value = (segment_p->field == PATH_FIELD_FILE) ? values_p->file : values_p->voice;
+                size_t length = format_unsigned(digits, value, PATH_COUNTER_DIGITS);
+                path_append_length(path_p, digits, length);
+            }
+            break;
+            case PATH_FIELD_NAME:
+                path_append_name(path_p, values_p->name_p, values_p->name_length);
+            break;
+            case PATH_FIELD_HASH:
+                path_append_hex(path_p, values_p->hash, PATH_HASH_DIGITS);
+            break;
+            case PATH_FIELD_SHARD:
+                for(int level = 0; level < PATH_SHARD_LEVELS; ++level)
+                {
+                    path_append_hex(path_p, values_p->hash >> (56 - 8 * level), 2);
+                    path_append(path_p, "/");
+                }
+                //le séparateur suivant est celui du gabarit.
+                path_truncate(path_p, path_p->length - 1);
+            break;
+            case PATH_FIELD_COUNT:
+            default:
+                path_append_length(path_p, template_p->text + segment_p->offset, segment_p->length);
+            break;
+        }
+    }
+    return path_p->overflow ? -1 : 0;
+}
+
+uint64_t path_hash(const void* data_p, size_t length)
+{
+    return path_hash_continue(PATH_HASH_SEED, data_p, length);
+}
+
+uint64_t path_hash_continue(uint64_t hash, const void* data_p, size_t length)
+{
+    const uint8_t* bytes_p = data_p;
+    for(size_t byte = 0; byte < length; ++byte)
+    {
+        hash = (hash ^ bytes_p[byte]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * folders are only created when the first open fails, so a file in an
+ * existing folder costs no more than fopen.
+ */
+FILE* path_open(const char* path_p, const char* mode_p)
+{
+    FILE* file_p = fopen(path_p, mode_p);
+    if(file_p != NULL || errno != ENOENT)
+    {
+        return file_p;
+    }
+    char folder[PATH_CAPACITY];
+    size_t length = strlen(path_p);
+    if(length >= PATH_CAPACITY)
+    {
+        return NULL;
+    }
+    memcpy(folder, path_p, length + 1);
+    for(char* separator_p = strchr(folder + 1, '/'); separator_p != NULL; separator_p = strchr(separator_p + 1, '/'))
+    {
+        *separator_p = 0;
+        if(mkdir(folder, 0777) && errno != EEXIST)
+        {
+            return NULL;
+        }
+        *separator_p = '/';
+    }
+    return fopen(path_p, mode_p);
+}
@@ -0,0 +1,197 @@
+/*
+ * pipeline.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "pipeline.h"
+#include "midi.h"
+#include "path.h"
+
+//les travaux sont numérotés à partir de 1.
+const PipelineReorder_t PIPELINE_REORDER_INITIALISER = {{NULL}, 1};
+
+void pipeline_queue_init(PipelineQueue_t* queue_p)
+{
+    queue_p->head = 0;
+    queue_p->count = 0;
+    queue_p->closed = 0;
+    pthread_mutex_init(&queue_p->mutex, NULL);
+    pthread_cond_init(&queue_p->not_empty, NULL);
+    pthread_cond_init(&queue_p->not_full, NULL);
+}
+
+void pipeline_queue_destroy(PipelineQueue_t* queue_p)
+{
+    pthread_mutex_destroy(&queue_p->mutex);
+    pthread_cond_destroy(&queue_p->not_empty);
+    pthread_cond_destroy(&queue_p->not_full);
+}
+
+void pipeline_queue_push(PipelineQueue_t* queue_p, void* item_p)
+{
+    pthread_mutex_lock(&queue_p->mutex);
+    while(queue_p->count == PIPELINE_QUEUE_CAPACITY)
+    {
+        pthread_cond_wait(&queue_p->not_full, &queue_p->mutex);
+    }
+    queue_p->items[(queue_p->head + queue_p->count) % PIPELINE_QUEUE_CAPACITY] = item_p;
+    ++queue_p->count;
+    pthread_cond_signal(&queue_p->not_empty);
+    pthread_mutex_unlock(&queue_p->mutex);
+}
+
+void* pipeline_queue_pop(PipelineQueue_t* queue_p)
+{
+    pthread_mutex_lock(&queue_p->mutex);
+    while(queue_p->count == 0 && !queue_p->closed)
+    {
+        pthread_cond_wait(&queue_p->not_empty, &queue_p->mutex);
+    }
+    void* item_p = NULL;
+    if(queue_p->count > 0)
+    {
+        item_p = queue_p->items[queue_p->head];
+        queue_p->head = (queue_p->head + 1) % PIPELINE_QUEUE_CAPACITY;
+        --queue_p->count;
+        pthread_cond_signal(&queue_p->not_full);
+    }
+    pthread_mutex_unlock(&queue_p->mutex);
+    return item_p;
+}
+
+void pipeline_queue_close(PipelineQueue_t* queue_p)
+{
+    pthread_mutex_lock(&queue_p->mutex);
+    queue_p->closed = 1;
+    pthread_cond_broadcast(&queue_p->not_empty);
+    pthread_mutex_unlock(&queue_p->mutex);
+}
+
+PipelineJob_t* pipeline_new_job(uint32_t number, const ScannedMessage_t* message_p, uint8_t* payload_p)
+{
+    PipelineJob_t* job_p = calloc(1, sizeof(PipelineJob_t));
+    job_p->number = number;
+    job_p->message = *message_p;
+    job_p->message.payload_p = payload_p;
+    return job_p;
+}
+
+void pipeline_add_file(PipelineJob_t* job_p,
+                       const ManifestSequence_t* sequence_p,
+                       const char* name_p,
+                       const uint8_t* payload_p,
+                       size_t length,
+                       int sysex,
+                       const char* voice_name_p)
+{
+    if(job_p->file_count == job_p->file_capacity)
+    {
+        job_p->file_capacity = job_p->file_capacity ? 2 * job_p->file_capacity : VOICE_COUNT + 1;
+        job_p->files_p = realloc(job_p->files_p, job_p->file_capacity * sizeof(PipelineFile_t));
+    }
+    PipelineFile_t* file_p = job_p->files_p + job_p->file_count++;
+    file_p->sequence = *sequence_p;
+    file_p->name_p = strdup(name_p);
+    file_p->payload_p = malloc(length);
+    memcpy(file_p->payload_p, payload_p, length);
+    file_p->length = length;
+    file_p->sysex = sysex;
+    file_p->written = 0;
+    file_p->voice_name[0] = 0;
+    if(voice_name_p != NULL)
+    {
+        strncat(file_p->voice_name, voice_name_p, VOICE_NAME_SIZE);
+    }
+}
+
+static int pipeline_compare_files(const void* left_p, const void* right_p)
+{
+    return manifest_compare_sequences(&((const PipelineFile_t*) left_p)->sequence,
+                                      &((const PipelineFile_t*) right_p)->sequence);
+}
+
+void pipeline_write_job(FILE* log_p, PipelineJob_t* job_p, Manifest_t* manifest_p)
+{
+    fwrite(job_p->log_p, sizeof(char), job_p->log_length, log_p);
+    //déjà dans l'ordre de décodage: le tri ne fait que le garantir.
+    qsort(job_p->files_p, job_p->file_count, sizeof(PipelineFile_t), pipeline_compare_files);
+    for(size_t file = 0; file < job_p->file_count; ++file)
+    {
+        PipelineFile_t* output_p = job_p->files_p + file;
+        FILE* file_p = path_open(output_p->name_p, "w+");
+        if(file_p == NULL)
+        {
+            fprintf(log_p, "can't write file: %s\n", output_p->name_p);
+            continue;
+        }
+        if(output_p->sysex)
+        {
+            midi_write_sysex_payload(file_p, output_p->payload_p, output_p->length);
+        }
+        else
+        {
+            fwrite(output_p->payload_p, sizeof(uint8_t), output_p->length, file_p);
+        }
+        fclose(file_p);
+        output_p->written = 1;
+        if(manifest_p != NULL)
+        {
+            manifest_add(manifest_p,
+                         &output_p->sequence,
+                         output_p->name_p,
+                         output_p->payload_p,
+                         output_p->length,
+                         output_p->sysex);
+        }
+    }
+}
+
+void pipeline_add_voice(PipelineJob_t* job_p, const VoiceParameters_t* voice_p)
+{
+    if(job_p->voice_count == job_p->voice_capacity)
+    {
+        job_p->voice_capacity = job_p->voice_capacity ? 2 * job_p->voice_capacity : VOICE_COUNT;
+        job_p->voices_p = realloc(job_p->voices_p, job_p->voice_capacity * sizeof(VoiceParameters_t));
+    }
+    job_p->voices_p[job_p->voice_count++] = *voice_p;
+}
+
+void pipeline_free_job(PipelineJob_t* job_p)
+{
+    for(size_t file = 0; file < job_p->file_count; ++file)
+    {
+        free(job_p->files_p[file].name_p);
+        free(job_p->files_p[file].payload_p);
+    }
+    free(job_p->files_p);
+    free(job_p->voices_p);
+    free(job_p->log_p);
+    free((void*) job_p->message.payload_p);
+    free(job_p);
+}
+
+int pipeline_reorder_put(PipelineReorder_t* reorder_p, PipelineJob_t* job_p)
+{
+    if(job_p->number - reorder_p->next_number >= PIPELINE_WINDOW)
+    {
+        return -1;
+    }
+    reorder_p->jobs[job_p->number % PIPELINE_WINDOW] = job_p;
+    return 0;
+}
+
+PipelineJob_t* pipeline_reorder_take(PipelineReorder_t* reorder_p)
+{
+    PipelineJob_t** slot_pp = reorder_p->jobs + reorder_p->next_number % PIPELINE_WINDOW;
+    PipelineJob_t* job_p = *slot_pp;
+    if(job_p != NULL)
+    {
+        *slot_pp = NULL;
+        ++reorder_p->next_number;
+    }
+    return job_p;
+}
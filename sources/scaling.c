@@ -0,0 +1,99 @@
+/*
+ * scaling.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include "scaling.h"
+
+#define SCALING_VALUE_BITS 14
+
+_Static_assert(SCALING_LANE_COUNT >= OPERATOR_COUNT, "one lane per operator");
+_Static_assert(sizeof(FractionalScalingParameters_t) + sizeof(UniversalBulkDataHeader_t) == BYTE_COUNT_FRACTIONAL_SCALING,
+               "FKSY blocks hold the six operators");
+
+static float scaling_get_value(TwoByte_t value)
+{
+    int32_t raw = (value.msb & MIDI_DATA_MASK) << 7 | (value.lsb & MIDI_DATA_MASK);
+    //complément à deux sur 14 bits.
+    return (raw & (1 << (SCALING_VALUE_BITS - 1))) ? raw - (1 << SCALING_VALUE_BITS) : raw;
+}
+
+void scaling_decode(const FractionalScalingParameters_t parameters, ScalingTable_t* table_p)
+{
+    ScalingVector_t zero = {0};
+    table_p->offset = zero;
+    for(int level = 0; level < FRACTIONAL_SCALING_COUNT; ++level)
+    {
+        table_p->level[level] = zero;
+    }
+    for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+    {
+        table_p->offset[operator] = scaling_get_value(parameters[operator].offset);
+        for(int level = 0; level < FRACTIONAL_SCALING_COUNT; ++level)
+        {
+            table_p->level[level][operator] = scaling_get_value(parameters[operator].level[level]);
+        }
+    }
+}
+
+int scaling_decode_universal(const UniversalBulkDataPayload_t* universal_p, ScalingTable_t* tables_p)
+{
+    int count;
+    switch(universal_p->type)
+    {
+        case UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER:
+        case UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_CARTRIDGE:
+            count = UNIVERSAL_BULK_DATA_REPEAT_TABLE[universal_p->type];
+        break;
+        default:
+            return 0;
+    }
+    const FractionalScalingParameters_t* parameters_p = universal_p->fractional_scaling_parameters_p;
+    for(int table = 0; table < count; ++table)
+    {
+        scaling_decode(parameters_p[table], tables_p + table);
+    }
+    return count;
+}
+
+void scaling_evaluate(const ScalingTable_t* tables_p, size_t count, ScalingCurve_t* curves_p)
+{
+    //les points qui encadrent chaque note ne dépendent pas des tables.
+    uint8_t lower[MIDI_NOTE_COUNT];
+    uint8_t upper[MIDI_NOTE_COUNT];
+    float weight[MIDI_NOTE_COUNT];
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        int position = note - FRACTIONAL_SCALING_FIRST_NOTE;
+        if(position <= 0)
+        {
+            lower[note] = upper[note] = 0;
+            weight[note] = 0.0f;
+        }
+        else if(position >= (FRACTIONAL_SCALING_COUNT - 1) * FRACTIONAL_SCALING_NOTE_STEP)
+        {
+            lower[note] = upper[note] = FRACTIONAL_SCALING_COUNT - 1;
+            weight[note] = 0.0f;
+        }
+        else
+        {
+            lower[note] = position / FRACTIONAL_SCALING_NOTE_STEP;
+            upper[note] = lower[note] + 1;
+            weight[note] = (float) (position % FRACTIONAL_SCALING_NOTE_STEP) / FRACTIONAL_SCALING_NOTE_STEP;
+        }
+    }
+    //une note = deux chargements et trois opérations sur les six opérateurs.
+    for(size_t table = 0; table < count; ++table)
+    {
+        const ScalingTable_t* table_p = tables_p + table;
+        ScalingVector_t* note_p = curves_p[table].note;
+        for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+        {
+            ScalingVector_t low = table_p->level[lower[note]];
+            ScalingVector_t high = table_p->level[upper[note]];
+            note_p[note] = table_p->offset + low + (high - low) * weight[note];
+        }
+    }
+}
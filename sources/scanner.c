@@ -0,0 +1,302 @@
+/*
+ * scanner.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "scanner.h"
+#include "midi.h"
+
+const SysexScanner_t SYSEX_SCANNER_INITIALISER =
+{
+    NULL,
+    0,
+    0,
+    0,
+    0,
+    0,
+    {0},
+    NULL,
+    {0}
+};
+
+/*
+ * reads the input through its SysEx events if it is a Standard MIDI File.
+ */
+static void scanner_detect_smf(SysexScanner_t* scanner_p)
+{
+    scanner_p->smf = smf_open(&scanner_p->smf_reader, scanner_p->data_p, scanner_p->length) == 0;
+}
+
+int scanner_open_file(SysexScanner_t* scanner_p, const char* path_p, int recover)
+{
+    *scanner_p = SYSEX_SCANNER_INITIALISER;
+    scanner_p->recover = recover;
+    int file_descriptor = open(path_p, O_RDONLY);
+    if(file_descriptor < 0)
+    {
+        return -1;
+    }
+    struct stat file_stat;
+    if(fstat(file_descriptor, &file_stat) < 0)
+    {
+        close(file_descriptor);
+        return -1;
+    }
+    if(file_stat.st_size > 0)
+    {
+        void* data_p = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if(data_p == MAP_FAILED)
+        {
+            close(file_descriptor);
+            return -1;
+        }
+        madvise(data_p, file_stat.st_size, MADV_SEQUENTIAL);
+        scanner_p->data_p = data_p;
+        scanner_p->length = file_stat.st_size;
+        scanner_p->mapped = 1;
+    }
+    close(file_descriptor);
+    scanner_detect_smf(scanner_p);
+    return 0;
+}
+
+void scanner_open_buffer(SysexScanner_t* scanner_p,
+                         const uint8_t* data_p,
+                         size_t length,
+                         int recover)
+{
+    *scanner_p = SYSEX_SCANNER_INITIALISER;
+    scanner_p->data_p = data_p;
+    scanner_p->length = length;
+    scanner_p->recover = recover;
+    scanner_detect_smf(scanner_p);
+}
+
+void scanner_close(SysexScanner_t* scanner_p)
+{
+    if(scanner_p->smf)
+    {
+        smf_close(&scanner_p->smf_reader);
+        scanner_p->smf = 0;
+    }
+    if(scanner_p->mapped)
+    {
+        munmap((void*) scanner_p->data_p, scanner_p->length);
+    }
+    free(scanner_p->owned_p);
+    scanner_p->owned_p = NULL;
+    scanner_p->data_p = NULL;
+    scanner_p->length = 0;
+    scanner_p->mapped = 0;
+}
+
+/*
+ * copies the message without its real time bytes.
+ */
+static const uint8_t* scanner_strip_real_time(SysexScanner_t* scanner_p,
+                                              const uint8_t* payload_p,
+                                              size_t* length_p)
+{
+    uint8_t* stripped_p = malloc(*length_p + 1);
+    size_t length = 0;
+    for(size_t position = 0; position < *length_p; ++position)
+    {
+        stripped_p[length] = payload_p[position];
+        length += payload_p[position] < MIDI_REAL_TIME;
+    }
+    scanner_p->owned_p = stripped_p;
+    *length_p = length;
+    return stripped_p;
+}
+
+/*
+ * a Yamaha bulk dump header: F0 43 0n ff, with a known format byte.
+ */
+static int scanner_is_resync_point(const uint8_t* payload_p, size_t length)
+{
+    if(length < SYSEX_HEADER_SIZE + BULK_HEADER_SIZE)
+    {
+        return 0;
+    }
+    SysexHeader_t header = dx7_decode_sysex_header(payload_p);
+    return header.id == MIDI_ID_YAMAHA
+        && payload_p[1] < MIDI_STATUS_BIT
+        && dx7_get_header(&header) == SYSEX_TYPE_BULK
+        && dx7_get_bulk_data_header((const BulkDataHeader_t*) (payload_p + SYSEX_HEADER_SIZE)) != BULK_DATA_MALFORMED;
+}
+
+/*
+ * locates the next message of raw SysEx data.
+ * its end is EOX or any other status byte, except real time bytes in recovery.
+ * in recovery, after skipped bytes or a cut message, an F0 starts a message
+ * only if a Yamaha bulk dump header or an EOX follows it.
+ */
+static int scanner_next_raw(SysexScanner_t* scanner_p, ScannedMessage_t* message_p, size_t* real_time_count_p)
+{
+    const uint8_t* data_p = scanner_p->data_p;
+    size_t length = scanner_p->length;
+    size_t position = scanner_p->position;
+    if(position >= length)
+    {
+        return 0;
+    }
+    //après des octets ignorés ou un message coupé, un F0 ne sert de reprise que
+    //devant un en-tête de dump Yamaha ou s'il ouvre un message complet.
+    int resync = scanner_p->recover && position > 0 && data_p[position - 1] != MIDI_EOX;
+    size_t start = position;
+    size_t real_time_count;
+    size_t end;
+    int terminated;
+    for(;;)
+    {
+        const uint8_t* start_p = memchr(data_p + start, MIDI_SYSTEM_EXCLUSIVE, length - start);
+        if(start_p == NULL)
+        {
+            scanner_p->statistics.skipped_byte_count += length - position;
+            scanner_p->position = length;
+            return 0;
+        }
+        start = start_p - data_p;
+        real_time_count = 0;
+        for(end = start + 1; end < length; ++end)
+        {
+            uint8_t byte = data_p[end];
+            if(byte & MIDI_STATUS_BIT)
+            {
+                if(scanner_p->recover && byte >= MIDI_REAL_TIME)
+                {
+                    ++real_time_count;
+                    continue;
+                }
+                break;
+            }
+        }
+        terminated = (end < length) && (data_p[end] == MIDI_EOX);
+        if(terminated
+        || !scanner_p->recover
+        || (!resync && start == position)
+        || scanner_is_resync_point(start_p + 1, end - start - 1))
+        {
+            break;
+        }
+        ++start;
+    }
+    scanner_p->statistics.skipped_byte_count += start - position;
+
+    scanner_p->position = end + terminated;
+
+    message_p->payload_p = data_p + start + 1;
+    message_p->length = end - start - 1;
+    message_p->offset = start;
+    message_p->terminated = terminated;
+    *real_time_count_p = real_time_count;
+    return 1;
+}
+
+/*
+ * takes the next SysEx event of a Standard MIDI File, without copying it
+ * unless it was split in several packets.
+ */
+static int scanner_next_smf(SysexScanner_t* scanner_p, ScannedMessage_t* message_p, size_t* real_time_count_p)
+{
+    SmfSysex_t sysex;
+    if(!smf_next_sysex(&scanner_p->smf_reader, &sysex))
+    {
+        return 0;
+    }
+    size_t real_time_count = 0;
+    if(scanner_p->recover)
+    {
+        for(size_t position = 0; position < sysex.length; ++position)
+        {
+            real_time_count += sysex.payload_p[position] >= MIDI_REAL_TIME;
+        }
+    }
+    message_p->payload_p = sysex.payload_p;
+    message_p->length = sysex.length;
+    message_p->offset = sysex.offset;
+    message_p->terminated = sysex.terminated;
+    *real_time_count_p = real_time_count;
+    return 1;
+}
+
+int scanner_next(SysexScanner_t* scanner_p, ScannedMessage_t* message_p)
+{
+    free(scanner_p->owned_p);
+    scanner_p->owned_p = NULL;
+
+    size_t real_time_count;
+    int found = scanner_p->smf ? scanner_next_smf(scanner_p, message_p, &real_time_count)
+                               : scanner_next_raw(scanner_p, message_p, &real_time_count);
+    if(!found)
+    {
+        return 0;
+    }
+    const uint8_t* payload_p = message_p->payload_p;
+    size_t payload_length = message_p->length;
+    int terminated = message_p->terminated;
+    if(real_time_count > 0)
+    {
+        payload_p = scanner_strip_real_time(scanner_p, payload_p, &payload_length);
+    }
+
+    size_t valid_length;
+    SysexCheck_t check = dx7_check_sysex(payload_p, payload_length, &valid_length);
+    int salvaged_voice_count = 0;
+    if(scanner_p->recover)
+    {
+        if(check == SYSEX_CHECK_TOO_LONG)
+        {
+            payload_length = valid_length;
+        }
+        else if(check == SYSEX_CHECK_TRUNCATED || check == SYSEX_CHECK_CHECKSUM)
+        {
+            size_t salvaged_length;
+            uint8_t* salvaged_p = dx7_salvage_packed32_voice(payload_p,
+                                                             payload_length,
+                                                             &salvaged_length,
+                                                             &salvaged_voice_count);
+            if(salvaged_p != NULL)
+            {
+                free(scanner_p->owned_p);
+                scanner_p->owned_p = salvaged_p;
+                payload_p = salvaged_p;
+                payload_length = salvaged_length;
+                ++scanner_p->statistics.salvaged_count;
+                scanner_p->statistics.salvaged_voice_count += salvaged_voice_count;
+            }
+        }
+    }
+
+    ++scanner_p->statistics.message_count;
+    ++scanner_p->statistics.check_count[check];
+    scanner_p->statistics.unterminated_count += !terminated;
+
+    message_p->payload_p = payload_p;
+    message_p->length = payload_length;
+    message_p->check = check;
+    message_p->salvaged_voice_count = salvaged_voice_count;
+    return 1;
+}
+
+void scanner_print_statistics(FILE* file_p, const ScanStatistics_t* statistics_p)
+{
+    fprintf(file_p, "Messages:        %u\n", statistics_p->message_count);
+    for(int check = 0; check < SYSEX_CHECK_COUNT; ++check)
+    {
+        fprintf(file_p, "  %-15s %u\n", SYSEX_CHECK_NAME_TABLE[check], statistics_p->check_count[check]);
+    }
+    fprintf(file_p, "Unterminated:    %u\n", statistics_p->unterminated_count);
+    fprintf(file_p, "Salvaged banks:  %u (%u voices)\n",
+            statistics_p->salvaged_count,
+            statistics_p->salvaged_voice_count);
+    fprintf(file_p, "Skipped bytes:   %zu\n", statistics_p->skipped_byte_count);
+}
@@ -0,0 +1,151 @@
+/*
+ * send.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "send.h"
+#include "dx7.h"
+#include "help.h"
+#include "scanner.h"
+
+static int send_options(int argc, char* argv[], SendOptions_t* options_p)
+{
+    int opt;
+    optind = 1;
+    while(-1 != (opt = getopt(argc, argv, ":c:d:g:hi:p:r:")))
+    {
+        switch(opt)
+        {
+            case 'c':
+                options_p->pacing.chunk_size = atoi(optarg);
+            break;
+            case 'd':
+                options_p->kind = transport_get_kind(optarg);
+                if(options_p->kind == TRANSPORT_KIND_COUNT)
+                {
+                    printf("unknown transport: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'g':
+                options_p->pacing.gap_ms = atoi(optarg);
+            break;
+            case 'h':
+                printf("%s", get_help());
+            break;
+            case 'i':
+                options_p->device = atoi(optarg);
+                if(options_p->device < 1 || options_p->device > 16)
+                {
+                    printf("invalid device number: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'p':
+                if(options_p->port_count == TRANSPORT_PORT_COUNT)
+                {
+                    printf("can't have more than %u ports\n", TRANSPORT_PORT_COUNT);
+                    return -1;
+                }
+                options_p->ports[options_p->port_count++] = optarg;
+            break;
+            case 'r':
+                options_p->pacing.bytes_per_ms = atof(optarg);
+            break;
+            case ':':
+                printf("error %c\n", optopt);
+                return -1;
+            default:
+                printf("unknown option %c\n", optopt);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * queues the messages of a file, formatted again for the device when
+ * one is given.
+ */
+static int send_file(TransportScheduler_t* scheduler_p, const SendOptions_t* options_p, const char* file_name_p)
+{
+    SysexScanner_t scanner;
+    if(scanner_open_file(&scanner, file_name_p, 0))
+    {
+        printf("can't open file: %s\n", file_name_p);
+        return -1;
+    }
+    ScannedMessage_t message;
+    uint32_t message_count = 0;
+    while(scanner_next(&scanner, &message))
+    {
+        const uint8_t* payload_p = message.payload_p;
+        size_t length = message.length;
+        uint8_t* formatted_p = NULL;
+        //seuls les dumps sont reformatés, les autres messages partent tels quels.
+        if(options_p->device != 0 && dx7_classify_sysex(message.payload_p, message.length).type == SYSEX_TYPE_BULK)
+        {
+            SysExData_t* sysex_p = dx7_get_sysex(message.payload_p, message.length);
+            if(sysex_p->type == SYSEX_TYPE_BULK && sysex_p->bulk_data.type != BULK_DATA_MALFORMED)
+            {
+                formatted_p = dx7_format_sysex(sysex_p, &length, options_p->device - 1);
+            }
+            dx7_free_sysex(sysex_p);
+            payload_p = (formatted_p != NULL) ? formatted_p : message.payload_p;
+            length = (formatted_p != NULL) ? length : message.length;
+        }
+        for(size_t port = 0; port < scheduler_p->port_count; ++port)
+        {
+            transport_scheduler_queue(scheduler_p, port, payload_p, length);
+        }
+        free(formatted_p);
+        ++message_count;
+    }
+    scanner_close(&scanner);
+    printf("%s: %u messages\n", file_name_p, message_count);
+    return 0;
+}
+
+int run_sender(int argc, char* argv[])
+{
+    SendOptions_t options = {TRANSPORT_FILE, TRANSPORT_PACING_INITIALISER, {NULL}, 0, 0};
+    if(send_options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    if(options.port_count == 0 || optind == argc)
+    {
+        printf("send needs -p <port> and files\n");
+        return EXIT_FAILURE;
+    }
+    TransportScheduler_t scheduler = TRANSPORT_SCHEDULER_INITIALISER;
+    int result = EXIT_SUCCESS;
+    for(size_t port = 0; port < options.port_count; ++port)
+    {
+        if(transport_scheduler_add_port(&scheduler, options.kind, options.ports[port], &options.pacing) < 0)
+        {
+            printf("can't open port: %s\n", options.ports[port]);
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+    for(int file = optind; file < argc && result == EXIT_SUCCESS; ++file)
+    {
+        if(send_file(&scheduler, &options, argv[file]))
+        {
+            result = EXIT_FAILURE;
+        }
+    }
+    if(transport_scheduler_finish(&scheduler, stdout))
+    {
+        result = EXIT_FAILURE;
+    }
+    return result;
+}
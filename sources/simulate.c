@@ -0,0 +1,219 @@
+/*
+ * simulate.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "simulate.h"
+#include "help.h"
+#include "scanner.h"
+
+#define SIMULATE_NS_PER_MS 1000000L
+
+static int simulate_options(int argc, char* argv[], SimulateOptions_t* options_p)
+{
+    int opt;
+    optind = 1;
+    while(-1 != (opt = getopt(argc, argv, ":c:d:f:g:hi:l:p:r:")))
+    {
+        switch(opt)
+        {
+            case 'c':
+                options_p->pacing.chunk_size = atoi(optarg);
+            break;
+            case 'd':
+                options_p->kind = transport_get_kind(optarg);
+                if(options_p->kind == TRANSPORT_KIND_COUNT)
+                {
+                    printf("unknown transport: %s\n", optarg);
+                    return -1;
+                }
+            break;
+            case 'f':
+                options_p->file_p = optarg;
+            break;
+            case 'g':
+                options_p->pacing.gap_ms = atoi(optarg);
+            break;
+            case 'h':
+                printf("%s", get_help());
+            break;
+            case 'i':
+            {
+                int device = atoi(optarg);
+                if(device < 1 || device > 16)
+                {
+                    printf("invalid device number: %s\n", optarg);
+                    return -1;
+                }
+                options_p->device = device - 1;
+            }
+            break;
+            case 'l':
+                options_p->latency_ms = atoi(optarg);
+            break;
+            case 'p':
+                if(options_p->port_count == TRANSPORT_PORT_COUNT)
+                {
+                    printf("can't have more than %u ports\n", TRANSPORT_PORT_COUNT);
+                    return -1;
+                }
+                options_p->ports[options_p->port_count++] = optarg;
+            break;
+            case 'r':
+                options_p->pacing.bytes_per_ms = atof(optarg);
+            break;
+            case ':':
+                printf("error %c\n", optopt);
+                return -1;
+            default:
+                printf("unknown option %c\n", optopt);
+                return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * loads every dump of a file into the memory of a device.
+ */
+static int simulate_load_file(DeviceSimulator_t* simulator_p, const char* file_name_p)
+{
+    SysexScanner_t scanner;
+    if(scanner_open_file(&scanner, file_name_p, 0))
+    {
+        printf("can't open file: %s\n", file_name_p);
+        return -1;
+    }
+    ScannedMessage_t message;
+    uint32_t dump_count = 0;
+    while(scanner_next(&scanner, &message))
+    {
+        if(dx7_classify_sysex(message.payload_p, message.length).type != SYSEX_TYPE_BULK)
+        {
+            continue;
+        }
+        SysExData_t* sysex_p = dx7_get_sysex(message.payload_p, message.length);
+        if(sysex_p->type == SYSEX_TYPE_BULK && simulator_load(simulator_p, &sysex_p->bulk_data) == 0)
+        {
+            ++dump_count;
+        }
+        dx7_free_sysex(sysex_p);
+    }
+    scanner_close(&scanner);
+    printf("%s: %u dumps loaded\n", file_name_p, dump_count);
+    return 0;
+}
+
+static void* simulate_unit_thread(void* argument_p)
+{
+    SimulateUnit_t* unit_p = argument_p;
+    const SimulateOptions_t* options_p = unit_p->options_p;
+    unit_p->result = -1;
+    //l'entrée d'abord: l'autre bout d'une paire de FIFO ouvre d'abord sa sortie.
+    Transport_t input;
+    if(transport_open(&input, options_p->kind, NULL, unit_p->input_p, NULL))
+    {
+        return NULL;
+    }
+    Transport_t output;
+    if(transport_open(&output, options_p->kind, unit_p->output_p, NULL, &options_p->pacing))
+    {
+        transport_close(&input);
+        return NULL;
+    }
+    const struct timespec latency =
+    {
+        options_p->latency_ms / 1000,
+        (options_p->latency_ms % 1000) * SIMULATE_NS_PER_MS
+    };
+    uint8_t* payload_p;
+    size_t length;
+    int result;
+    while((result = transport_receive_sysex(&input, &payload_p, &length, -1)) > 0)
+    {
+        size_t reply_length;
+        uint8_t* reply_p = simulator_receive(&unit_p->simulator, payload_p, length, &reply_length);
+        free(payload_p);
+        if(reply_p == NULL)
+        {
+            continue;
+        }
+        if(options_p->latency_ms > 0)
+        {
+            nanosleep(&latency, NULL);
+        }
+        result = transport_send_sysex(&output, reply_p, reply_length);
+        free(reply_p);
+        if(result)
+        {
+            result = -1;
+            break;
+        }
+    }
+    unit_p->result = (result < 0) ? -1 : 0;
+    transport_close(&output);
+    transport_close(&input);
+    return NULL;
+}
+
+int run_simulator(int argc, char* argv[])
+{
+    SimulateOptions_t options = {TRANSPORT_FILE, TRANSPORT_PACING_INITIALISER, {NULL}, 0, 0, 0, NULL};
+    if(simulate_options(argc, argv, &options))
+    {
+        return EXIT_FAILURE;
+    }
+    if(options.port_count == 0)
+    {
+        printf("simulate needs -p <port>\n");
+        return EXIT_FAILURE;
+    }
+    //toutes les unités partent de la même mémoire.
+    DeviceSimulator_t* initial_p = malloc(sizeof(DeviceSimulator_t));
+    simulator_init(initial_p, options.device);
+    if(options.file_p != NULL && simulate_load_file(initial_p, options.file_p))
+    {
+        free(initial_p);
+        return EXIT_FAILURE;
+    }
+    SimulateUnit_t* units_p = calloc(options.port_count, sizeof(SimulateUnit_t));
+    for(size_t unit = 0; unit < options.port_count; ++unit)
+    {
+        SimulateUnit_t* unit_p = units_p + unit;
+        unit_p->options_p = &options;
+        unit_p->output_p = strdup(options.ports[unit]);
+        unit_p->input_p = transport_split_port(unit_p->output_p);
+        unit_p->simulator = *initial_p;
+        unit_p->result = -1;
+        unit_p->started = (pthread_create(&unit_p->thread, NULL, simulate_unit_thread, unit_p) == 0);
+    }
+    free(initial_p);
+
+    int result = EXIT_SUCCESS;
+    for(size_t unit = 0; unit < options.port_count; ++unit)
+    {
+        SimulateUnit_t* unit_p = units_p + unit;
+        if(unit_p->started)
+        {
+            pthread_join(unit_p->thread, NULL);
+        }
+        printf("--------------\n");
+        printf("%s%s\n", unit_p->output_p, unit_p->result ? ": failed" : "");
+        simulator_print_statistics(stdout, &unit_p->simulator.statistics);
+        if(unit_p->result)
+        {
+            result = EXIT_FAILURE;
+        }
+        free(unit_p->output_p);
+    }
+    free(units_p);
+    return result;
+}
@@ -0,0 +1,277 @@
+/*
+ * simulator.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "simulator.h"
+#include "tuning.h"
+
+#define SIMULATOR_REGION(FIELD) {offsetof(SimulatorMemory_t, FIELD), SIZE_OF_FIELD(SimulatorMemory_t, FIELD)}
+
+const SimulatorRegion_t SIMULATOR_BULK_REGION_TABLE[BULK_DATA_FORMAT_COUNT] =
+{
+    SIMULATOR_REGION(voice_edit_buffer),       //BULK_DATA_VOICE_EDIT_BUFFER
+    SIMULATOR_REGION(supplement_edit_buffer),  //BULK_DATA_SUPPLEMENT_EDIT_BUFFER
+    SIMULATOR_REGION(packed32_supplement),     //BULK_DATA_PACKED_32_SUPPLEMENT
+    SIMULATOR_REGION(packed32_voice),          //BULK_DATA_PACKED_32_VOICE
+    {0, 0},
+    {0, 0}
+};
+
+const SimulatorRegion_t SIMULATOR_UNIVERSAL_REGION_TABLE[UNIVERSAL_BULK_DATA_COUNT] =
+{
+    SIMULATOR_REGION(performance_edit_buffer),
+    SIMULATOR_REGION(packed32_performance),
+    SIMULATOR_REGION(system_setup),
+    SIMULATOR_REGION(micro_tuning_edit_buffer),
+    SIMULATOR_REGION(micro_tuning_memory[0]),
+    SIMULATOR_REGION(micro_tuning_memory[1]),
+    SIMULATOR_REGION(micro_tuning_cartridge),
+    SIMULATOR_REGION(fractional_scaling_edit_buffer),
+    SIMULATOR_REGION(fractional_scaling_cartridge)
+};
+
+//chaque région doit avoir la taille des données de son dump.
+_Static_assert(sizeof(MicroTuningParameters_t) == SIMULATOR_UNIVERSAL_DATA_SIZE(BYTE_COUNT_MICRO_TUNING),
+               "micro tunings must match their dump");
+_Static_assert(sizeof(FractionalScalingParameters_t) == SIMULATOR_UNIVERSAL_DATA_SIZE(BYTE_COUNT_FRACTIONAL_SCALING),
+               "fractional scalings must match their dump");
+
+const SimulatorStatistics_t SIMULATOR_STATISTICS_INITIALISER = {0, 0, 0, 0, 0, 0, 0};
+
+void simulator_init(DeviceSimulator_t* simulator_p, uint8_t device)
+{
+    memset(simulator_p, 0, sizeof(DeviceSimulator_t));
+    simulator_p->device = device & 0x0F;
+    SimulatorMemory_t* memory_p = &simulator_p->memory;
+    memory_p->voice_edit_buffer = VOICE_PARAMETERS_INITIALISER;
+    memory_p->supplement_edit_buffer = SUPPLEMENT_PARAMETERS_INITIALISER;
+    PackedVoiceParameters_t initial_voice = dx7_pack_voice_parameters(VOICE_PARAMETERS_INITIALISER);
+    PackedSupplementVoiceParameters_t initial_supplement = dx7_pack_supplement_parameters(SUPPLEMENT_PARAMETERS_INITIALISER);
+    for(int voice = 0; voice < VOICE_COUNT; ++voice)
+    {
+        memory_p->packed32_voice[voice] = initial_voice;
+        memory_p->packed32_supplement[voice] = initial_supplement;
+    }
+    TuningTable_t equal_temperament;
+    tuning_set_equal_temperament(&equal_temperament);
+    tuning_encode(&equal_temperament, memory_p->micro_tuning_edit_buffer);
+    memcpy(memory_p->micro_tuning_memory[0], memory_p->micro_tuning_edit_buffer, sizeof(MicroTuningParameters_t));
+    memcpy(memory_p->micro_tuning_memory[1], memory_p->micro_tuning_edit_buffer, sizeof(MicroTuningParameters_t));
+    for(int tuning = 0; tuning < MICRO_TUNING_CARTRIDGE_COUNT; ++tuning)
+    {
+        memcpy(memory_p->micro_tuning_cartridge[tuning],
+               memory_p->micro_tuning_edit_buffer,
+               sizeof(MicroTuningParameters_t));
+    }
+}
+
+uint8_t* simulator_format_dump(const DeviceSimulator_t* simulator_p,
+                               const DumpRequest_t* request_p,
+                               size_t* length_p)
+{
+    const uint8_t* memory_p = (const uint8_t*) &simulator_p->memory;
+    SysExData_t sysex_data;
+    sysex_data.type = SYSEX_TYPE_BULK;
+    sysex_data.bulk_data.type = request_p->format;
+    switch(request_p->format)
+    {
+        case BULK_DATA_UNIVERSAL_BULK_DUMP:
+            if(request_p->universal < 0 || request_p->universal >= UNIVERSAL_BULK_DATA_COUNT)
+            {
+                return NULL;
+            }
+            sysex_data.bulk_data.universal.type = request_p->universal;
+            sysex_data.bulk_data.universal.payload_p =
+                (void*) (memory_p + SIMULATOR_UNIVERSAL_REGION_TABLE[request_p->universal].offset);
+        break;
+        case BULK_DATA_MALFORMED:
+        case BULK_DATA_FORMAT_COUNT:
+            return NULL;
+        default:
+            sysex_data.bulk_data.payload_p = (void*) (memory_p + SIMULATOR_BULK_REGION_TABLE[request_p->format].offset);
+        break;
+    }
+    //dx7_format_sysex lit la mémoire en place, sans copie.
+    return dx7_format_sysex(&sysex_data, length_p, simulator_p->device);
+}
+
+int simulator_load(DeviceSimulator_t* simulator_p, const BulkDataPayload_t* bulk_data_p)
+{
+    uint8_t* memory_p = (uint8_t*) &simulator_p->memory;
+    const SimulatorRegion_t* region_p;
+    const void* data_p;
+    switch(bulk_data_p->type)
+    {
+        case BULK_DATA_UNIVERSAL_BULK_DUMP:
+            if(bulk_data_p->universal.type == UNIVERSAL_BULK_DATA_ERROR)
+            {
+                return -1;
+            }
+            region_p = SIMULATOR_UNIVERSAL_REGION_TABLE + bulk_data_p->universal.type;
+            data_p = bulk_data_p->universal.payload_p;
+        break;
+        case BULK_DATA_MALFORMED:
+        case BULK_DATA_FORMAT_COUNT:
+            return -1;
+        default:
+            region_p = SIMULATOR_BULK_REGION_TABLE + bulk_data_p->type;
+            data_p = bulk_data_p->payload_p;
+        break;
+    }
+    memcpy(memory_p + region_p->offset, data_p, region_p->size);
+    return 0;
+}
+
+/*
+ * stores a data byte in an edit buffer kept as bytes.
+ */
+static int simulator_store_byte(uint8_t* buffer_p, size_t size, size_t position, uint8_t value)
+{
+    if(position >= size || (value & ~MIDI_DATA_MASK))
+    {
+        return -1;
+    }
+    buffer_p[position] = value;
+    return 0;
+}
+
+int simulator_apply_parameter(DeviceSimulator_t* simulator_p, const ParameterPayload_t* parameter_p)
+{
+    SimulatorMemory_t* memory_p = &simulator_p->memory;
+    uint16_t parameter = parameter_p->number & MIDI_DATA_MASK;
+    switch(parameter_p->parameter)
+    {
+        case PARAMETER_CHANGE_VOICE:
+            return dx7_apply_voice_parameter(&memory_p->voice_edit_buffer, parameter_p);
+        case PARAMETER_CHANGE_SUPPLEMENT:
+        {
+            if(parameter_p->number >= SUPPLEMENT_FIELD_COUNT)
+            {
+                return -1;
+            }
+            const SchemaField_t* field_p = SUPPLEMENT_SCHEMA_TABLE + parameter_p->number;
+            if(parameter_p->data < field_p->minimum || parameter_p->data > field_p->maximum)
+            {
+                return -1;
+            }
+            ((uint8_t*) &memory_p->supplement_edit_buffer)[field_p->offset] = parameter_p->data;
+            return 0;
+        }
+        case PARAMETER_CHANGE_PERFORMANCE:
+            return simulator_store_byte(memory_p->performance_edit_buffer.data,
+                                        sizeof(memory_p->performance_edit_buffer),
+                                        parameter,
+                                        parameter_p->data);
+        case PARAMETER_CHANGE_SYSTEM_SET_UP:
+            if(parameter < SIMULATOR_SYSTEM_SET_UP_FIRST_PARAMETER)
+            {
+                return -1;
+            }
+            return simulator_store_byte(memory_p->system_setup,
+                                        sizeof(memory_p->system_setup),
+                                        parameter - SIMULATOR_SYSTEM_SET_UP_FIRST_PARAMETER,
+                                        parameter_p->data);
+        case PARAMETER_CHANGE_MICRO_TUNING:
+        {
+            const uint8_t* data_p = parameter_p->micro_tuning;
+            if((data_p[0] | data_p[1] | data_p[2]) & ~MIDI_DATA_MASK)
+            {
+                return -1;
+            }
+            TwoByte_t value = {data_p[1], data_p[2]};
+            memory_p->micro_tuning_edit_buffer[data_p[0]] = value;
+            return 0;
+        }
+        case PARAMETER_CHANGE_FRACTIONAL_SCALING:
+        {
+            const uint8_t* data_p = parameter_p->fractional_scaling_data;
+            //décalage puis niveaux: 1 + FRACTIONAL_SCALING_COUNT valeurs par opérateur.
+            if(data_p[0] >= OPERATOR_COUNT
+            || data_p[1] > FRACTIONAL_SCALING_COUNT
+            || ((data_p[2] | data_p[3]) & ~MIDI_DATA_MASK))
+            {
+                return -1;
+            }
+            TwoByte_t* values_p = &memory_p->fractional_scaling_edit_buffer[data_p[0]].offset;
+            TwoByte_t value = {data_p[2], data_p[3]};
+            values_p[data_p[1]] = value;
+            return 0;
+        }
+        default:
+            return -1;
+    }
+}
+
+uint8_t* simulator_receive(DeviceSimulator_t* simulator_p,
+                           const uint8_t* payload_p,
+                           size_t length,
+                           size_t* reply_length_p)
+{
+    SimulatorStatistics_t* statistics_p = &simulator_p->statistics;
+    ++statistics_p->message_count;
+    if(length < SYSEX_HEADER_SIZE)
+    {
+        ++statistics_p->rejected_count;
+        return NULL;
+    }
+    SysexHeader_t header = dx7_decode_sysex_header(payload_p);
+    if(header.id != MIDI_ID_YAMAHA || header.device != simulator_p->device)
+    {
+        ++statistics_p->ignored_count;
+        return NULL;
+    }
+    uint8_t* reply_p = NULL;
+    SysExData_t* sysex_p = dx7_get_sysex(payload_p, length);
+    switch(sysex_p->type)
+    {
+        case SYSEX_TYPE_BULK:
+            if(simulator_load(simulator_p, &sysex_p->bulk_data))
+            {
+                ++statistics_p->rejected_count;
+                break;
+            }
+            ++statistics_p->dump_count;
+        break;
+        case SYSEX_TYPE_PARAMETER:
+            if(simulator_apply_parameter(simulator_p, &sysex_p->parameter_change))
+            {
+                ++statistics_p->rejected_count;
+                break;
+            }
+            ++statistics_p->parameter_count;
+        break;
+        case SYSEX_TYPE_DUMP_REQUEST:
+            reply_p = simulator_format_dump(simulator_p, &sysex_p->dump_request, reply_length_p);
+            if(reply_p == NULL)
+            {
+                ++statistics_p->rejected_count;
+                break;
+            }
+            ++statistics_p->request_count;
+            statistics_p->reply_byte_count += *reply_length_p;
+        break;
+        default:
+            ++statistics_p->rejected_count;
+        break;
+    }
+    dx7_free_sysex(sysex_p);
+    return reply_p;
+}
+
+void simulator_print_statistics(FILE* file_p, const SimulatorStatistics_t* statistics_p)
+{
+    fprintf(file_p, "Messages:        %u\n", statistics_p->message_count);
+    fprintf(file_p, "Requests:        %u (%lluB answered)\n",
+            statistics_p->request_count,
+            (unsigned long long) statistics_p->reply_byte_count);
+    fprintf(file_p, "Dumps loaded:    %u\n", statistics_p->dump_count);
+    fprintf(file_p, "Parameters:      %u\n", statistics_p->parameter_count);
+    fprintf(file_p, "Rejected:        %u\n", statistics_p->rejected_count);
+    fprintf(file_p, "Ignored:         %u\n", statistics_p->ignored_count);
+}
@@ -0,0 +1,419 @@
+/*
+ * smf.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+
+#include "smf.h"
+#include "midi.h"
+
+#define SMF_PACKET_CAPACITY 4096U
+
+typedef struct SmfEvent_t
+{
+    uint8_t status;
+    uint32_t delta;
+    const uint8_t* data_p;     //données des évènements SysEx.
+    size_t length;
+    size_t position;           //de l'octet de statut, dans la piste.
+    size_t next;               //évènement suivant, dans la piste.
+} SmfEvent_t;
+
+const SmfReader_t SMF_READER_INITIALISER =
+{
+    NULL, 0, 0,
+    0, 0, 0,
+    NULL, 0, 0, 0, 0,
+    0,
+    0,
+    NULL, 0, 0, 0, 0
+};
+
+static uint32_t smf_read_u32(const uint8_t* bytes_p)
+{
+    return ((uint32_t) bytes_p[0] << 24) | ((uint32_t) bytes_p[1] << 16) | (bytes_p[2] << 8) | bytes_p[3];
+}
+
+static uint16_t smf_read_u16(const uint8_t* bytes_p)
+{
+    return (bytes_p[0] << 8) | bytes_p[1];
+}
+
+static void smf_write_u32(uint32_t value, uint8_t* bytes_p)
+{
+    bytes_p[0] = value >> 24;
+    bytes_p[1] = value >> 16;
+    bytes_p[2] = value >> 8;
+    bytes_p[3] = value;
+}
+
+size_t smf_read_vlq(const uint8_t* bytes_p, size_t length, uint32_t* value_p)
+{
+    uint32_t value = 0;
+    for(size_t position = 0; position < length && position < SMF_VLQ_MAX_SIZE; ++position)
+    {
+        value = (value << MIDI_DATA_BITS) | (bytes_p[position] & MIDI_DATA_MASK);
+        if(!(bytes_p[position] & MIDI_STATUS_BIT))
+        {
+            *value_p = value;
+            return position + 1;
+        }
+    }
+    return 0;
+}
+
+size_t smf_write_vlq(uint32_t value, uint8_t* bytes_p)
+{
+    //7 bits par octet, poids fort en tête, bit 7 sur tous sauf le dernier.
+    size_t length = 1;
+    for(uint32_t rest = value >> MIDI_DATA_BITS; rest != 0; rest >>= MIDI_DATA_BITS)
+    {
+        ++length;
+    }
+    for(size_t position = length; position-- > 0; value >>= MIDI_DATA_BITS)
+    {
+        bytes_p[position] = (value & MIDI_DATA_MASK) | ((position + 1 < length) ? MIDI_STATUS_BIT : 0);
+    }
+    return length;
+}
+
+int smf_is_smf(const uint8_t* data_p, size_t length)
+{
+    return length >= SMF_CHUNK_ID_SIZE && memcmp(data_p, SMF_HEADER_ID, SMF_CHUNK_ID_SIZE) == 0;
+}
+
+int smf_is_file(const char* path_p)
+{
+    uint8_t id[SMF_CHUNK_ID_SIZE];
+    FILE* file_p = fopen(path_p, "rb");
+    if(file_p == NULL)
+    {
+        return 0;
+    }
+    size_t length = fread(id, 1, sizeof(id), file_p);
+    fclose(file_p);
+    return smf_is_smf(id, length);
+}
+
+int smf_open(SmfReader_t* reader_p, const uint8_t* data_p, size_t length)
+{
+    *reader_p = SMF_READER_INITIALISER;
+    if(length < SMF_CHUNK_HEADER_SIZE + SMF_HEADER_SIZE || !smf_is_smf(data_p, length))
+    {
+        return -1;
+    }
+    uint32_t header_length = smf_read_u32(data_p + SMF_CHUNK_ID_SIZE);
+    if(header_length < SMF_HEADER_SIZE || header_length > length - SMF_CHUNK_HEADER_SIZE)
+    {
+        return -1;
+    }
+    const uint8_t* header_p = data_p + SMF_CHUNK_HEADER_SIZE;
+    reader_p->format = smf_read_u16(header_p);
+    reader_p->track_count = smf_read_u16(header_p + 2);
+    reader_p->division = smf_read_u16(header_p + 4);
+    reader_p->data_p = data_p;
+    reader_p->length = length;
+    reader_p->position = SMF_CHUNK_HEADER_SIZE + header_length;
+    return 0;
+}
+
+/*
+ * moves to the next MTrk chunk, skipping the chunks of other types.
+ * a truncated track is read up to the end of the file.
+ */
+static int smf_next_track(SmfReader_t* reader_p)
+{
+    while(reader_p->length - reader_p->position >= SMF_CHUNK_HEADER_SIZE)
+    {
+        const uint8_t* chunk_p = reader_p->data_p + reader_p->position;
+        size_t chunk_length = smf_read_u32(chunk_p + SMF_CHUNK_ID_SIZE);
+        size_t available = reader_p->length - reader_p->position - SMF_CHUNK_HEADER_SIZE;
+        if(chunk_length > available)
+        {
+            chunk_length = available;
+        }
+        reader_p->position += SMF_CHUNK_HEADER_SIZE + chunk_length;
+        if(memcmp(chunk_p, SMF_TRACK_ID, SMF_CHUNK_ID_SIZE) == 0)
+        {
+            reader_p->track_p = chunk_p + SMF_CHUNK_HEADER_SIZE;
+            reader_p->track_length = chunk_length;
+            reader_p->track_position = 0;
+            reader_p->running_status = 0;
+            reader_p->tick = 0;
+            ++reader_p->track;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * reads the event at the track position without consuming it.
+ * returns 0 at the end of the track, or if the rest of it is unreadable.
+ */
+static int smf_read_event(SmfReader_t* reader_p, SmfEvent_t* event_p)
+{
+    const uint8_t* track_p = reader_p->track_p;
+    size_t length = reader_p->track_length;
+    size_t position = reader_p->track_position;
+    if(track_p == NULL || position >= length)
+    {
+        return 0;
+    }
+    size_t vlq_length = smf_read_vlq(track_p + position, length - position, &event_p->delta);
+    position += vlq_length;
+    if(vlq_length == 0 || position >= length)
+    {
+        return 0;
+    }
+    event_p->position = position;
+    event_p->data_p = NULL;
+    event_p->length = 0;
+    uint8_t status = track_p[position];
+    if(!(status & MIDI_STATUS_BIT))
+    {
+        //statut courant: l'octet est déjà une donnée.
+        if(reader_p->running_status == 0)
+        {
+            return 0;
+        }
+        status = reader_p->running_status;
+        --position;
+    }
+    event_p->status = status;
+    ++position;
+    switch(status)
+    {
+        case SMF_STATUS_META:
+            if(position >= length || track_p[position] == SMF_META_END_OF_TRACK)
+            {
+                return 0;
+            }
+            ++position;
+            __attribute__((fallthrough));
+        case SMF_STATUS_SYSEX:
+        case SMF_STATUS_ESCAPE:
+        {
+            uint32_t data_length;
+            vlq_length = smf_read_vlq(track_p + position, length - position, &data_length);
+            if(vlq_length == 0)
+            {
+                return 0;
+            }
+            position += vlq_length;
+            //un évènement tronqué garde ce qui reste de la piste.
+            event_p->length = (data_length < length - position) ? data_length : length - position;
+            event_p->data_p = track_p + position;
+            position += event_p->length;
+        }
+        break;
+        default:
+            if(status >= MIDI_SYSTEM)
+            {
+                //aucun autre message système n'a sa place dans une piste.
+                return 0;
+            }
+            position += ((status & 0xF0) == MIDI_PROGRAM_CHANGE || (status & 0xF0) == MIDI_CHANEL_PRESSURE) ? 1 : 2;
+            if(position > length)
+            {
+                return 0;
+            }
+        break;
+    }
+    event_p->next = position;
+    return 1;
+}
+
+static void smf_append_packet(SmfReader_t* reader_p, const uint8_t* data_p, size_t length)
+{
+    if(reader_p->packet_length + length > reader_p->packet_capacity)
+    {
+        size_t capacity = reader_p->packet_capacity ? reader_p->packet_capacity : SMF_PACKET_CAPACITY;
+        while(capacity < reader_p->packet_length + length)
+        {
+            capacity *= 2;
+        }
+        reader_p->packet_p = realloc(reader_p->packet_p, capacity);
+        reader_p->packet_capacity = capacity;
+    }
+    memcpy(reader_p->packet_p + reader_p->packet_length, data_p, length);
+    reader_p->packet_length += length;
+}
+
+static int smf_deliver_packet(SmfReader_t* reader_p, SmfSysex_t* sysex_p, int terminated)
+{
+    sysex_p->payload_p = reader_p->packet_p;
+    sysex_p->length = reader_p->packet_length - terminated;
+    sysex_p->offset = reader_p->packet_offset;
+    sysex_p->terminated = terminated;
+    sysex_p->track = reader_p->track;
+    sysex_p->tick = reader_p->packet_tick;
+    reader_p->in_packet = 0;
+    return 1;
+}
+
+static int smf_ends_message(const uint8_t* data_p, size_t length)
+{
+    return length > 0 && data_p[length - 1] == MIDI_EOX;
+}
+
+int smf_next_sysex(SmfReader_t* reader_p, SmfSysex_t* sysex_p)
+{
+    if(!reader_p->in_packet)
+    {
+        reader_p->packet_length = 0;
+    }
+    for(;;)
+    {
+        SmfEvent_t event;
+        if(!smf_read_event(reader_p, &event))
+        {
+            //fin de piste: un message commencé s'arrête là.
+            if(reader_p->in_packet)
+            {
+                return smf_deliver_packet(reader_p, sysex_p, 0);
+            }
+            if(!smf_next_track(reader_p))
+            {
+                return 0;
+            }
+            continue;
+        }
+        if(event.status == SMF_STATUS_SYSEX && reader_p->in_packet)
+        {
+            //le F0 sera relu à l'appel suivant.
+            return smf_deliver_packet(reader_p, sysex_p, 0);
+        }
+        reader_p->track_position = event.next;
+        reader_p->tick += event.delta;
+        size_t offset = (reader_p->track_p - reader_p->data_p) + event.position;
+        switch(event.status)
+        {
+            case SMF_STATUS_SYSEX:
+                reader_p->running_status = 0;
+                if(smf_ends_message(event.data_p, event.length))
+                {
+                    sysex_p->payload_p = event.data_p;
+                    sysex_p->length = event.length - 1;
+                    sysex_p->offset = offset;
+                    sysex_p->terminated = 1;
+                    sysex_p->track = reader_p->track;
+                    sysex_p->tick = reader_p->tick;
+                    return 1;
+                }
+                reader_p->in_packet = 1;
+                reader_p->packet_offset = offset;
+                reader_p->packet_tick = reader_p->tick;
+                smf_append_packet(reader_p, event.data_p, event.length);
+            break;
+            case SMF_STATUS_ESCAPE:
+                reader_p->running_status = 0;
+                if(reader_p->in_packet)
+                {
+                    smf_append_packet(reader_p, event.data_p, event.length);
+                    if(smf_ends_message(event.data_p, event.length))
+                    {
+                        return smf_deliver_packet(reader_p, sysex_p, 1);
+                    }
+                }
+                else if(event.length > 0 && event.data_p[0] == MIDI_SYSTEM_EXCLUSIVE)
+                {
+                    //message entier passé en octets bruts.
+                    int terminated = smf_ends_message(event.data_p, event.length);
+                    sysex_p->payload_p = event.data_p + 1;
+                    sysex_p->length = event.length - 1 - terminated;
+                    sysex_p->offset = offset;
+                    sysex_p->terminated = terminated;
+                    sysex_p->track = reader_p->track;
+                    sysex_p->tick = reader_p->tick;
+                    return 1;
+                }
+            break;
+            case SMF_STATUS_META:
+                reader_p->running_status = 0;
+            break;
+            default:
+                reader_p->running_status = event.status;
+            break;
+        }
+    }
+}
+
+void smf_close(SmfReader_t* reader_p)
+{
+    free(reader_p->packet_p);
+    *reader_p = SMF_READER_INITIALISER;
+}
+
+static int smf_write_bytes(SmfWriter_t* writer_p, const void* bytes_p, size_t length)
+{
+    writer_p->track_length += length;
+    return fwrite(bytes_p, 1, length, writer_p->file_p) == length ? 0 : -1;
+}
+
+int smf_writer_open(SmfWriter_t* writer_p, FILE* file_p, uint32_t gap_ms)
+{
+    writer_p->file_p = file_p;
+    writer_p->track_length = 0;
+    writer_p->gap_ticks = gap_ms * ((uint64_t) SMF_DIVISION * 1000U) / SMF_TEMPO;
+    writer_p->message_count = 0;
+    uint8_t header[SMF_CHUNK_HEADER_SIZE + SMF_HEADER_SIZE + SMF_CHUNK_HEADER_SIZE] = SMF_HEADER_ID;
+    smf_write_u32(SMF_HEADER_SIZE, header + SMF_CHUNK_ID_SIZE);
+    uint8_t* format_p = header + SMF_CHUNK_HEADER_SIZE;
+    format_p[0] = 0;           //format 0: une seule piste.
+    format_p[1] = 0;
+    format_p[2] = 0;
+    format_p[3] = 1;
+    format_p[4] = SMF_DIVISION >> 8;
+    format_p[5] = SMF_DIVISION & 0xFF;
+    memcpy(format_p + SMF_HEADER_SIZE, SMF_TRACK_ID, SMF_CHUNK_ID_SIZE);
+    if(fwrite(header, sizeof(header), 1, file_p) != 1)
+    {
+        return -1;
+    }
+    writer_p->track_length_position = ftell(file_p) - SMF_CHUNK_ID_SIZE;
+    const uint8_t tempo[] = {0, SMF_STATUS_META, SMF_META_TEMPO, 3,
+                             (SMF_TEMPO >> 16) & 0xFF, (SMF_TEMPO >> 8) & 0xFF, SMF_TEMPO & 0xFF};
+    return smf_write_bytes(writer_p, tempo, sizeof(tempo));
+}
+
+int smf_write_sysex(SmfWriter_t* writer_p, const uint8_t* message_p, size_t length)
+{
+    if(length < 2 || message_p[0] != MIDI_SYSTEM_EXCLUSIVE)
+    {
+        return -1;
+    }
+    //[delta] F0 [longueur] [données F7 compris]
+    uint8_t head[2 * SMF_VLQ_MAX_SIZE + 1];
+    size_t head_length = smf_write_vlq(writer_p->message_count ? writer_p->gap_ticks : 0, head);
+    head[head_length++] = SMF_STATUS_SYSEX;
+    head_length += smf_write_vlq(length - 1, head + head_length);
+    ++writer_p->message_count;
+    if(smf_write_bytes(writer_p, head, head_length) || smf_write_bytes(writer_p, message_p + 1, length - 1))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int smf_writer_close(SmfWriter_t* writer_p)
+{
+    const uint8_t end[] = {0, SMF_STATUS_META, SMF_META_END_OF_TRACK, 0};
+    if(smf_write_bytes(writer_p, end, sizeof(end)))
+    {
+        return -1;
+    }
+    uint8_t track_length[sizeof(uint32_t)];
+    smf_write_u32(writer_p->track_length, track_length);
+    long end_position = ftell(writer_p->file_p);
+    if(fseek(writer_p->file_p, writer_p->track_length_position, SEEK_SET)
+    || fwrite(track_length, sizeof(track_length), 1, writer_p->file_p) != 1
+    || fseek(writer_p->file_p, end_position, SEEK_SET))
+    {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,475 @@
+/*
+ * transport.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "transport.h"
+#include "midi.h"
+
+#define TRANSPORT_NS_PER_MS 1000000ULL
+
+const char* const TRANSPORT_KIND_NAME_TABLE[TRANSPORT_KIND_COUNT] =
+{
+    "file",
+    "raw"
+};
+
+const TransportPacing_t TRANSPORT_PACING_INITIALISER =
+{
+    TRANSPORT_MIDI_RATE,
+    TRANSPORT_CHUNK_SIZE,
+    TRANSPORT_GAP_MS
+};
+
+const TransportScheduler_t TRANSPORT_SCHEDULER_INITIALISER =
+{
+    {NULL},
+    0
+};
+
+static uint64_t transport_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void transport_sleep_until(uint64_t time_ns)
+{
+    struct timespec deadline = {time_ns / 1000000000ULL, time_ns % 1000000000ULL};
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+    {
+    }
+}
+
+/*
+ * the output of a FIFO blocks until a reader opens it, as a MIDI cable
+ * waits for its synthesiser.
+ */
+static int transport_file_open(Transport_t* transport_p, const char* output_p, const char* input_p)
+{
+    if(output_p != NULL)
+    {
+        transport_p->output_fd = open(output_p, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if(transport_p->output_fd < 0)
+        {
+            return -1;
+        }
+    }
+    if(input_p != NULL)
+    {
+        transport_p->input_fd = open(input_p, O_RDONLY);
+        if(transport_p->input_fd < 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * a MIDI device is read and written through one descriptor.
+ */
+static int transport_raw_open(Transport_t* transport_p, const char* output_p, const char* input_p)
+{
+    const char* device_p = (output_p != NULL) ? output_p : input_p;
+    int flags = (output_p != NULL && input_p != NULL) ? O_RDWR : (output_p != NULL) ? O_WRONLY : O_RDONLY;
+    int descriptor = open(device_p, flags | O_NOCTTY);
+    if(descriptor < 0)
+    {
+        return -1;
+    }
+    if(output_p != NULL)
+    {
+        transport_p->output_fd = descriptor;
+    }
+    if(input_p != NULL)
+    {
+        transport_p->input_fd = descriptor;
+    }
+    return 0;
+}
+
+static ssize_t transport_fd_write(Transport_t* transport_p, const uint8_t* data_p, size_t length)
+{
+    size_t written = 0;
+    while(written < length)
+    {
+        ssize_t count = write(transport_p->output_fd, data_p + written, length - written);
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            if(errno == EAGAIN)
+            {
+                struct pollfd output = {transport_p->output_fd, POLLOUT, 0};
+                poll(&output, 1, -1);
+                continue;
+            }
+            return -1;
+        }
+        written += count;
+    }
+    return written;
+}
+
+static ssize_t transport_fd_read(Transport_t* transport_p, uint8_t* data_p, size_t capacity, int timeout_ms)
+{
+    struct pollfd input = {transport_p->input_fd, POLLIN, 0};
+    int ready;
+    while((ready = poll(&input, 1, timeout_ms)) < 0 && errno == EINTR)
+    {
+    }
+    if(ready <= 0)
+    {
+        return ready;
+    }
+    ssize_t count;
+    while((count = read(transport_p->input_fd, data_p, capacity)) < 0 && errno == EINTR)
+    {
+    }
+    return count;
+}
+
+static void transport_fd_close(Transport_t* transport_p)
+{
+    if(transport_p->output_fd >= 0)
+    {
+        close(transport_p->output_fd);
+    }
+    if(transport_p->input_fd >= 0 && transport_p->input_fd != transport_p->output_fd)
+    {
+        close(transport_p->input_fd);
+    }
+    transport_p->output_fd = -1;
+    transport_p->input_fd = -1;
+}
+
+const TransportBackend_t TRANSPORT_BACKEND_TABLE[TRANSPORT_KIND_COUNT] =
+{
+    {transport_file_open, transport_fd_write, transport_fd_read, transport_fd_close},
+    {transport_raw_open, transport_fd_write, transport_fd_read, transport_fd_close}
+};
+
+TransportKind_t transport_get_kind(const char* name_p)
+{
+    TransportKind_t kind;
+    for(kind = 0; kind < TRANSPORT_KIND_COUNT; ++kind)
+    {
+        if(strcmp(name_p, TRANSPORT_KIND_NAME_TABLE[kind]) == 0)
+        {
+            break;
+        }
+    }
+    return kind;
+}
+
+const char* transport_split_port(char* port_p)
+{
+    char* separator_p = strchr(port_p, TRANSPORT_PORT_SEPARATOR);
+    if(separator_p == NULL)
+    {
+        return port_p;
+    }
+    *separator_p = 0;
+    return separator_p + 1;
+}
+
+int transport_open(Transport_t* transport_p,
+                   TransportKind_t kind,
+                   const char* output_p,
+                   const char* input_p,
+                   const TransportPacing_t* pacing_p)
+{
+    memset(transport_p, 0, sizeof(Transport_t));
+    transport_p->backend_p = TRANSPORT_BACKEND_TABLE + kind;
+    transport_p->output_fd = -1;
+    transport_p->input_fd = -1;
+    transport_p->pacing = (pacing_p != NULL) ? *pacing_p : TRANSPORT_PACING_INITIALISER;
+    if(transport_p->pacing.chunk_size == 0)
+    {
+        transport_p->pacing.chunk_size = TRANSPORT_CHUNK_SIZE;
+    }
+    if(transport_p->backend_p->open(transport_p, output_p, input_p))
+    {
+        transport_p->backend_p->close(transport_p);
+        return -1;
+    }
+    transport_p->next_time_ns = transport_now();
+    return 0;
+}
+
+void transport_close(Transport_t* transport_p)
+{
+    transport_p->backend_p->close(transport_p);
+    free(transport_p->receive_p);
+    transport_p->receive_p = NULL;
+    transport_p->receive_length = 0;
+}
+
+int transport_send(Transport_t* transport_p, const uint8_t* data_p, size_t length)
+{
+    const TransportPacing_t* pacing_p = &transport_p->pacing;
+    if(pacing_p->bytes_per_ms <= 0)
+    {
+        if(transport_p->backend_p->write(transport_p, data_p, length) < 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        //échéances absolues: le débit moyen ne dérive pas avec les retards du système.
+        uint64_t now = transport_now();
+        if(transport_p->next_time_ns < now)
+        {
+            transport_p->next_time_ns = now;
+        }
+        for(size_t position = 0; position < length; position += pacing_p->chunk_size)
+        {
+            size_t count = (length - position < pacing_p->chunk_size) ? length - position : pacing_p->chunk_size;
+            transport_sleep_until(transport_p->next_time_ns);
+            if(transport_p->backend_p->write(transport_p, data_p + position, count) < 0)
+            {
+                return -1;
+            }
+            //en nanosecondes entières: un float ne garde pas une échéance après quelques heures.
+            transport_p->next_time_ns += (uint64_t) llround(count * (double) TRANSPORT_NS_PER_MS
+                                                            / pacing_p->bytes_per_ms);
+        }
+    }
+    transport_p->next_time_ns += pacing_p->gap_ms * TRANSPORT_NS_PER_MS;
+    transport_p->sent_byte_count += length;
+    ++transport_p->sent_message_count;
+    return 0;
+}
+
+int transport_send_sysex(Transport_t* transport_p, const uint8_t* payload_p, size_t length)
+{
+    uint8_t* message_p = NULL;
+    size_t message_length = 0;
+    FILE* message_file_p = open_memstream((char**) &message_p, &message_length);
+    midi_write_sysex_payload(message_file_p, payload_p, length);
+    fclose(message_file_p);
+    int result = transport_send(transport_p, message_p, message_length);
+    free(message_p);
+    return result;
+}
+
+/*
+ * returns the message found in the received bytes, and drops the bytes
+ * before its end.
+ */
+static int transport_take_sysex(Transport_t* transport_p, uint8_t** payload_pp, size_t* length_p)
+{
+    uint8_t* data_p = transport_p->receive_p;
+    uint8_t* start_p;
+    while((start_p = memchr(data_p, MIDI_SYSTEM_EXCLUSIVE, transport_p->receive_length)) != NULL)
+    {
+        uint8_t* end_p = data_p + transport_p->receive_length;
+        uint8_t* byte_p;
+        for(byte_p = start_p + 1; byte_p < end_p; ++byte_p)
+        {
+            if((*byte_p & MIDI_STATUS_BIT) && *byte_p < MIDI_REAL_TIME)
+            {
+                break;
+            }
+        }
+        if(byte_p == end_p)
+        {
+            //message incomplet: gardé à partir de son F0.
+            transport_p->receive_length = end_p - start_p;
+            memmove(data_p, start_p, transport_p->receive_length);
+            return 0;
+        }
+        int terminated = (*byte_p == MIDI_EOX);
+        if(terminated)
+        {
+            uint8_t* payload_p = malloc(byte_p - start_p);
+            size_t length = 0;
+            for(uint8_t* data_byte_p = start_p + 1; data_byte_p < byte_p; ++data_byte_p)
+            {
+                payload_p[length] = *data_byte_p;
+                length += (*data_byte_p < MIDI_REAL_TIME);
+            }
+            *payload_pp = payload_p;
+            *length_p = length;
+        }
+        //un autre statut que EOX interrompt le message: il est abandonné.
+        size_t consumed = byte_p + terminated - data_p;
+        transport_p->receive_length -= consumed;
+        memmove(data_p, data_p + consumed, transport_p->receive_length);
+        if(terminated)
+        {
+            return 1;
+        }
+    }
+    transport_p->receive_length = 0;
+    return 0;
+}
+
+int transport_receive_sysex(Transport_t* transport_p, uint8_t** payload_pp, size_t* length_p, int timeout_ms)
+{
+    if(transport_p->receive_p == NULL)
+    {
+        transport_p->receive_p = malloc(TRANSPORT_RECEIVE_CAPACITY);
+    }
+    uint64_t deadline = transport_now() + (uint64_t) timeout_ms * TRANSPORT_NS_PER_MS;
+    for(;;)
+    {
+        if(transport_p->receive_length > 0 && transport_take_sysex(transport_p, payload_pp, length_p))
+        {
+            return 1;
+        }
+        if(transport_p->receive_length == TRANSPORT_RECEIVE_CAPACITY)
+        {
+            //message trop long pour le tampon: abandonné.
+            transport_p->receive_length = 0;
+        }
+        uint64_t now = transport_now();
+        int remaining_ms = (timeout_ms < 0) ? -1 : (now >= deadline) ? 0 : (int) ((deadline - now) / TRANSPORT_NS_PER_MS);
+        ssize_t count = transport_p->backend_p->read(transport_p,
+                                                     transport_p->receive_p + transport_p->receive_length,
+                                                     TRANSPORT_RECEIVE_CAPACITY - transport_p->receive_length,
+                                                     remaining_ms);
+        if(count <= 0)
+        {
+            return count;
+        }
+        transport_p->receive_length += count;
+        deadline = transport_now() + (uint64_t) timeout_ms * TRANSPORT_NS_PER_MS;
+    }
+}
+
+static void* transport_port_thread(void* argument_p)
+{
+    TransportPort_t* port_p = argument_p;
+    for(;;)
+    {
+        pthread_mutex_lock(&port_p->mutex);
+        while(port_p->head_p == NULL && !port_p->closed)
+        {
+            pthread_cond_wait(&port_p->not_empty, &port_p->mutex);
+        }
+        TransportMessage_t* message_p = port_p->head_p;
+        if(message_p != NULL)
+        {
+            port_p->head_p = message_p->next_p;
+            if(port_p->head_p == NULL)
+            {
+                port_p->tail_p = NULL;
+            }
+        }
+        pthread_mutex_unlock(&port_p->mutex);
+        if(message_p == NULL)
+        {
+            break;
+        }
+        //après une erreur, la file est vidée sans envoi.
+        if(port_p->result == 0 && transport_send(&port_p->transport, message_p->data, message_p->length))
+        {
+            port_p->result = -1;
+        }
+        free(message_p);
+    }
+    return NULL;
+}
+
+int transport_scheduler_add_port(TransportScheduler_t* scheduler_p,
+                                 TransportKind_t kind,
+                                 const char* output_p,
+                                 const TransportPacing_t* pacing_p)
+{
+    if(scheduler_p->port_count == TRANSPORT_PORT_COUNT)
+    {
+        return -1;
+    }
+    TransportPort_t* port_p = calloc(1, sizeof(TransportPort_t));
+    if(transport_open(&port_p->transport, kind, output_p, NULL, pacing_p))
+    {
+        free(port_p);
+        return -1;
+    }
+    pthread_mutex_init(&port_p->mutex, NULL);
+    pthread_cond_init(&port_p->not_empty, NULL);
+    if(pthread_create(&port_p->thread, NULL, transport_port_thread, port_p))
+    {
+        transport_close(&port_p->transport);
+        pthread_mutex_destroy(&port_p->mutex);
+        pthread_cond_destroy(&port_p->not_empty);
+        free(port_p);
+        return -1;
+    }
+    scheduler_p->ports[scheduler_p->port_count] = port_p;
+    return scheduler_p->port_count++;
+}
+
+void transport_scheduler_queue(TransportScheduler_t* scheduler_p, size_t port, const uint8_t* payload_p, size_t length)
+{
+    TransportPort_t* port_p = scheduler_p->ports[port];
+    TransportMessage_t* message_p = malloc(sizeof(TransportMessage_t) + length + 2);
+    message_p->next_p = NULL;
+    message_p->length = length + 2;
+    message_p->data[0] = MIDI_SYSTEM_EXCLUSIVE;
+    memcpy(message_p->data + 1, payload_p, length);
+    message_p->data[length + 1] = MIDI_EOX;
+    pthread_mutex_lock(&port_p->mutex);
+    if(port_p->tail_p != NULL)
+    {
+        port_p->tail_p->next_p = message_p;
+    }
+    else
+    {
+        port_p->head_p = message_p;
+    }
+    port_p->tail_p = message_p;
+    pthread_cond_signal(&port_p->not_empty);
+    pthread_mutex_unlock(&port_p->mutex);
+}
+
+int transport_scheduler_finish(TransportScheduler_t* scheduler_p, FILE* log_p)
+{
+    int failed_count = 0;
+    for(size_t port = 0; port < scheduler_p->port_count; ++port)
+    {
+        TransportPort_t* port_p = scheduler_p->ports[port];
+        pthread_mutex_lock(&port_p->mutex);
+        port_p->closed = 1;
+        pthread_cond_signal(&port_p->not_empty);
+        pthread_mutex_unlock(&port_p->mutex);
+    }
+    for(size_t port = 0; port < scheduler_p->port_count; ++port)
+    {
+        TransportPort_t* port_p = scheduler_p->ports[port];
+        pthread_join(port_p->thread, NULL);
+        failed_count += (port_p->result != 0);
+        if(log_p != NULL)
+        {
+            fprintf(log_p, "port %zu: %u messages, %llu bytes%s\n",
+                    port,
+                    port_p->transport.sent_message_count,
+                    (unsigned long long) port_p->transport.sent_byte_count,
+                    port_p->result ? ", failed" : "");
+        }
+        transport_close(&port_p->transport);
+        pthread_mutex_destroy(&port_p->mutex);
+        pthread_cond_destroy(&port_p->not_empty);
+        free(port_p);
+        scheduler_p->ports[port] = NULL;
+    }
+    scheduler_p->port_count = 0;
+    return failed_count;
+}
@@ -0,0 +1,309 @@
+/*
+ * tuning.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+#include "tuning.h"
+#include "utility.h"
+
+#define TUNING_LINE_SIZE 256
+
+const char* const TUNING_FILE_EXTENSION_TABLE[TUNING_FILE_COUNT] =
+{
+    ".tun",
+    ".scl"
+};
+
+//2^(demi-ton/12) et 2^(pas/12288): une fréquence coûte deux lectures et un ldexp.
+static double TUNING_SEMITONE_TABLE[12];
+static double TUNING_STEP_TABLE[TUNING_STEPS_PER_SEMITONE];
+
+__attribute__((constructor))
+static void tuning_build_tables(void)
+{
+    for(int semitone = 0; semitone < 12; ++semitone)
+    {
+        TUNING_SEMITONE_TABLE[semitone] = exp2(semitone / 12.0);
+    }
+    for(unsigned step = 0; step < TUNING_STEPS_PER_SEMITONE; ++step)
+    {
+        TUNING_STEP_TABLE[step] = exp2((double) step / TUNING_STEPS_PER_OCTAVE);
+    }
+}
+
+double tuning_get_frequency(uint32_t pitch)
+{
+    uint32_t octave = pitch / TUNING_STEPS_PER_OCTAVE;
+    uint32_t rest = pitch % TUNING_STEPS_PER_OCTAVE;
+    return ldexp(TUNING_NOTE_0_FREQUENCY
+                 * TUNING_SEMITONE_TABLE[rest / TUNING_STEPS_PER_SEMITONE]
+                 * TUNING_STEP_TABLE[rest % TUNING_STEPS_PER_SEMITONE],
+                 octave);
+}
+
+void tuning_update_frequencies(TuningTable_t* table_p)
+{
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        table_p->frequency[note] = tuning_get_frequency(table_p->pitch[note]);
+    }
+}
+
+void tuning_set_equal_temperament(TuningTable_t* table_p)
+{
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        table_p->pitch[note] = note * TUNING_STEPS_PER_SEMITONE;
+    }
+    tuning_update_frequencies(table_p);
+}
+
+int tuning_decode(const MicroTuningParameters_t parameters, TuningTable_t* table_p)
+{
+    int invalid_count = 0;
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        uint32_t coarse = parameters[note].msb & MIDI_DATA_MASK;
+        uint32_t fine = parameters[note].lsb & MIDI_DATA_MASK;
+        if(fine > TUNING_FINE_MAXIMUM)
+        {
+            fine = TUNING_FINE_MAXIMUM;
+            ++invalid_count;
+        }
+        table_p->pitch[note] = coarse * TUNING_STEPS_PER_SEMITONE + fine * TUNING_FINE_STEP;
+    }
+    tuning_update_frequencies(table_p);
+    return invalid_count;
+}
+
+void tuning_encode(const TuningTable_t* table_p, MicroTuningParameters_t parameters)
+{
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        uint32_t pitch = table_p->pitch[note];
+        uint32_t coarse = pitch / TUNING_STEPS_PER_SEMITONE;
+        uint32_t fine = (pitch % TUNING_STEPS_PER_SEMITONE + TUNING_FINE_STEP / 2) / TUNING_FINE_STEP;
+        if(fine > TUNING_FINE_MAXIMUM)
+        {
+            ++coarse;
+            fine = 0;
+        }
+        if(coarse >= MIDI_NOTE_COUNT)
+        {
+            coarse = MIDI_NOTE_COUNT - 1;
+            fine = TUNING_FINE_MAXIMUM;
+        }
+        parameters[note].msb = coarse;
+        parameters[note].lsb = fine;
+    }
+}
+
+int tuning_decode_universal(const UniversalBulkDataPayload_t* universal_p, TuningTable_t* tables_p)
+{
+    int count;
+    switch(universal_p->type)
+    {
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_0:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_1:
+        case UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE:
+            count = UNIVERSAL_BULK_DATA_REPEAT_TABLE[universal_p->type];
+        break;
+        default:
+            return 0;
+    }
+    const MicroTuningParameters_t* parameters_p = universal_p->micro_tuning_edit_parameters_p;
+    for(int tuning = 0; tuning < count; ++tuning)
+    {
+        tuning_decode(parameters_p[tuning], tables_p + tuning);
+    }
+    return count;
+}
+
+uint8_t* tuning_format_sysex(const TuningTable_t* tables_p,
+                             int count,
+                             uint8_t device_id,
+                             size_t* length_p)
+{
+    if(count < 1 || count > MICRO_TUNING_CARTRIDGE_COUNT)
+    {
+        return NULL;
+    }
+    MicroTuningCartridge_t cartridge;
+    TuningTable_t equal_temperament;
+    tuning_set_equal_temperament(&equal_temperament);
+    for(int tuning = 0; tuning < MICRO_TUNING_CARTRIDGE_COUNT; ++tuning)
+    {
+        tuning_encode((tuning < count) ? tables_p + tuning : &equal_temperament, cartridge[tuning]);
+    }
+    SysExData_t sysex_data;
+    sysex_data.type = SYSEX_TYPE_BULK;
+    sysex_data.bulk_data.type = BULK_DATA_UNIVERSAL_BULK_DUMP;
+    sysex_data.bulk_data.universal.type = (count == 1) ? UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER
+                                                       : UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE;
+    sysex_data.bulk_data.universal.micro_tuning_cartridge_p = &cartridge;
+    return dx7_format_sysex(&sysex_data, length_p, device_id);
+}
+
+TuningFileFormat_t tuning_get_file_format(const char* path_p)
+{
+    const char* extension_p = get_extension(path_p);
+    for(int format = 0; extension_p != NULL && format < TUNING_FILE_COUNT; ++format)
+    {
+        if(strcasecmp(extension_p, TUNING_FILE_EXTENSION_TABLE[format]) == 0)
+        {
+            return format;
+        }
+    }
+    return TUNING_FILE_COUNT;
+}
+
+static double tuning_get_cents(uint32_t pitch)
+{
+    return pitch * TUNING_CENTS_PER_SEMITONE / TUNING_STEPS_PER_SEMITONE;
+}
+
+static uint32_t tuning_get_pitch(double cents)
+{
+    double pitch = round(cents * TUNING_STEPS_PER_SEMITONE / TUNING_CENTS_PER_SEMITONE);
+    return (pitch < 0.0) ? 0 : (uint32_t) pitch;
+}
+
+void tuning_write_file(FILE* file_p,
+                       const TuningTable_t* table_p,
+                       TuningFileFormat_t format,
+                       const char* name_p)
+{
+    switch(format)
+    {
+        case TUNING_FILE_TUN:
+            fprintf(file_p, "; %s\n", name_p);
+            fprintf(file_p, "[Exact Tuning]\n");
+            fprintf(file_p, "BaseFreq=%.10f\n", TUNING_NOTE_0_FREQUENCY);
+            for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+            {
+                fprintf(file_p, "note %d=%.6f\n", note, tuning_get_cents(table_p->pitch[note]));
+            }
+        break;
+        case TUNING_FILE_SCL:
+            fprintf(file_p, "! %s\n", name_p);
+            fprintf(file_p, "! note 0: %.6f Hz\n", table_p->frequency[0]);
+            fprintf(file_p, "%s\n", name_p);
+            fprintf(file_p, " %d\n", MIDI_NOTE_COUNT - 1);
+            fprintf(file_p, "!\n");
+            for(int note = 1; note < MIDI_NOTE_COUNT; ++note)
+            {
+                fprintf(file_p, " %.6f\n", tuning_get_cents(table_p->pitch[note])
+                                         - tuning_get_cents(table_p->pitch[0]));
+            }
+        break;
+        default:
+        break;
+    }
+}
+
+static int tuning_read_tun(FILE* file_p, TuningTable_t* table_p)
+{
+    char line[TUNING_LINE_SIZE];
+    double base_cents = 0.0;
+    int note_count = 0;
+    tuning_set_equal_temperament(table_p);
+    while(fgets(line, sizeof(line), file_p) != NULL)
+    {
+        int note;
+        double value;
+        if(sscanf(line, " BaseFreq = %lf", &value) == 1 && value > 0.0)
+        {
+            base_cents = 1200.0 * log2(value / TUNING_NOTE_0_FREQUENCY);
+        }
+        else if(sscanf(line, " note %d = %lf", &note, &value) == 2
+             && note >= 0 && note < MIDI_NOTE_COUNT)
+        {
+            table_p->pitch[note] = tuning_get_pitch(base_cents + value);
+            ++note_count;
+        }
+    }
+    tuning_update_frequencies(table_p);
+    return (note_count > 0) ? 0 : -1;
+}
+
+static int tuning_read_scl(FILE* file_p, TuningTable_t* table_p)
+{
+    char line[TUNING_LINE_SIZE];
+    double cents[MIDI_NOTE_COUNT];
+    int line_count = 0;
+    int degree_count = 0;
+    int degree = 0;
+    //description, nombre de degrés, puis un intervalle par ligne: cents si '.', rapport sinon.
+    while(fgets(line, sizeof(line), file_p) != NULL && (line_count < 2 || degree < degree_count))
+    {
+        if(line[0] == '!')
+        {
+            continue;
+        }
+        if(line_count++ == 0)
+        {
+            continue;
+        }
+        if(line_count == 2)
+        {
+            if(sscanf(line, "%d", &degree_count) != 1 || degree_count < 1 || degree_count >= MIDI_NOTE_COUNT)
+            {
+                return -1;
+            }
+            continue;
+        }
+        long numerator;
+        long denominator = 1;
+        if(strchr(line, '.') != NULL)
+        {
+            if(sscanf(line, "%lf", cents + degree) != 1)
+            {
+                return -1;
+            }
+        }
+        else if(sscanf(line, "%ld/%ld", &numerator, &denominator) >= 1 && numerator > 0 && denominator > 0)
+        {
+            cents[degree] = 1200.0 * log2((double) numerator / denominator);
+        }
+        else
+        {
+            return -1;
+        }
+        ++degree;
+    }
+    if(degree_count == 0 || degree < degree_count)
+    {
+        return -1;
+    }
+    //le dernier degré est la période.
+    double period = cents[degree_count - 1];
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        int repeat = note / degree_count;
+        int step = note % degree_count;
+        double note_cents = repeat * period + ((step > 0) ? cents[step - 1] : 0.0);
+        table_p->pitch[note] = tuning_get_pitch(note_cents);
+    }
+    tuning_update_frequencies(table_p);
+    return 0;
+}
+
+int tuning_read_file(FILE* file_p, TuningTable_t* table_p, TuningFileFormat_t format)
+{
+    switch(format)
+    {
+        case TUNING_FILE_TUN:
+            return tuning_read_tun(file_p, table_p);
+        case TUNING_FILE_SCL:
+            return tuning_read_scl(file_p, table_p);
+        default:
+            return -1;
+    }
+}
@@ -24,7 +24,12 @@ int get_checksum(const void* buffer, size_t buffer_size)
 uint8_t generate_checksum(const void* buffer, size_t buffze_size)
 {
     uint8_t checksum = get_checksum(buffer, buffze_size);
-    return (0x7F & ~checksum) + 1;
+    return (uint8_t) -checksum & MIDI_DATA_MASK;
+}
+
+int is_checksum_valid(const void* buffer, size_t buffer_size, uint8_t checksum)
+{
+    return ((get_checksum(buffer, buffer_size) + checksum) & MIDI_DATA_MASK) == 0;
 }
 
 uint16_t get_payload_size(TwoByte_t byte_count)
@@ -40,26 +45,25 @@ TwoByte_t format_payload_size(size_t size)
     return byte_count;
 }
 
-char* append_str(char** text_pp, const char* appendage_p)
+size_t format_unsigned(char* text_p, uint64_t value, size_t digit_count)
 {
-    if(strlen(appendage_p) > 0)
+    char digits[FORMAT_UNSIGNED_SIZE];
+    size_t length = 0;
+    do
     {
-        size_t length = strlen(*text_pp) + strlen(appendage_p);
-        char* new_text_p = malloc(length + 1);
-        strcpy(new_text_p, *text_pp);
-        strcat(new_text_p, appendage_p);
-        free(*text_pp);
-        *text_pp = new_text_p;
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while(value > 0);
+    while(length < digit_count && length < FORMAT_UNSIGNED_SIZE - 1)
+    {
+        digits[length++] = '0';
     }
-    return *text_pp;
-}
-
-char* append_counter(char** text_pp, uint8_t counter)
-{
-
-    char suffix[5] = {0};
-    sprintf(suffix, "_%03hhu", counter);
-    return append_str(text_pp, suffix);
+    for(size_t digit = 0; digit < length; ++digit)
+    {
+        text_p[digit] = digits[length - 1 - digit];
+    }
+    text_p[length] = 0;
+    return length;
 }
 
 const char* path_to_file_name(const char* path_p)
@@ -72,7 +76,7 @@ const char* get_extension(const char* path_p)
 {
 
     char* extension_start_p = strrchr(path_p, '.');
-    if(strchr(extension_start_p, '/') != NULL)
+    if(extension_start_p == NULL || strchr(extension_start_p, '/') != NULL)
     {
         return NULL;
     }
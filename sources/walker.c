@@ -0,0 +1,401 @@
+/*
+ * walker.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "walker.h"
+#include "path.h"
+#include "utility.h"
+
+/*
+ * entry of getdents64, declared by glibc only from 2.30.
+ */
+typedef struct WalkEntry_t
+{
+    uint64_t inode;
+    int64_t offset;
+    unsigned short length;
+    unsigned char type;
+    char name[];
+} WalkEntry_t;
+
+static void walker_deque_push(WalkDeque_t* deque_p, const WalkFolder_t* folder_p)
+{
+    pthread_mutex_lock(&deque_p->mutex);
+    if(deque_p->count == deque_p->capacity)
+    {
+        //agrandi en remettant la tête au début.
+        size_t capacity = deque_p->capacity ? 2 * deque_p->capacity : WALKER_DEQUE_CAPACITY;
+        WalkFolder_t* folders_p = malloc(capacity * sizeof(WalkFolder_t));
+        for(size_t folder = 0; folder < deque_p->count; ++folder)
+        {
+            folders_p[folder] = deque_p->folders_p[(deque_p->head + folder) % deque_p->capacity];
+        }
+        free(deque_p->folders_p);
+        deque_p->folders_p = folders_p;
+        deque_p->capacity = capacity;
+        deque_p->head = 0;
+    }
+    deque_p->folders_p[(deque_p->head + deque_p->count++) % deque_p->capacity] = *folder_p;
+    pthread_mutex_unlock(&deque_p->mutex);
+}
+
+static int walker_deque_pop(WalkDeque_t* deque_p, WalkFolder_t* folder_p)
+{
+    int found = 0;
+    pthread_mutex_lock(&deque_p->mutex);
+    if(deque_p->count > 0)
+    {
+        *folder_p = deque_p->folders_p[(deque_p->head + --deque_p->count) % deque_p->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque_p->mutex);
+    return found;
+}
+
+static int walker_deque_steal(WalkDeque_t* deque_p, WalkFolder_t* folder_p)
+{
+    int found = 0;
+    pthread_mutex_lock(&deque_p->mutex);
+    if(deque_p->count > 0)
+    {
+        *folder_p = deque_p->folders_p[deque_p->head];
+        deque_p->head = (deque_p->head + 1) % deque_p->capacity;
+        --deque_p->count;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque_p->mutex);
+    return found;
+}
+
+static void walker_add_folder(WalkWorker_t* worker_p,
+                              char* path_p,
+                              int descriptor,
+                              WalkIdentity_t* parents_p,
+                              size_t depth)
+{
+    Walker_t* walker_p = worker_p->walker_p;
+    WalkFolder_t folder = {path_p, descriptor, parents_p, depth};
+    __atomic_add_fetch(&walker_p->pending_count, 1, __ATOMIC_ACQ_REL);
+    walker_deque_push(&worker_p->deque, &folder);
+    pthread_mutex_lock(&walker_p->idle_mutex);
+    ++walker_p->push_count;
+    pthread_cond_signal(&walker_p->idle_condition);
+    pthread_mutex_unlock(&walker_p->idle_mutex);
+}
+
+static void walker_add_file(WalkWorker_t* worker_p, const char* path_p)
+{
+    if(worker_p->path_count == worker_p->path_capacity)
+    {
+        worker_p->path_capacity = worker_p->path_capacity ? 2 * worker_p->path_capacity : WALKER_FILE_CAPACITY;
+        worker_p->paths_pp = realloc(worker_p->paths_pp, worker_p->path_capacity * sizeof(char*));
+    }
+    worker_p->paths_pp[worker_p->path_count++] = strdup(path_p);
+}
+
+static int walker_accepts(const Walker_t* walker_p, const char* name_p)
+{
+    if(walker_p->extensions_pp == NULL)
+    {
+        return 1;
+    }
+    const char* extension_p = get_extension(name_p);
+    if(extension_p == NULL)
+    {
+        return 0;
+    }
+    for(const char* const* accepted_pp = walker_p->extensions_pp; *accepted_pp != NULL; ++accepted_pp)
+    {
+        if(strcasecmp(extension_p, *accepted_pp) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * opens a sub folder relative to its parent while few are open.
+ */
+static int walker_open_child(Walker_t* walker_p, int parent, const char* name_p)
+{
+    if(__atomic_add_fetch(&walker_p->open_count, 1, __ATOMIC_ACQ_REL) <= WALKER_OPEN_LIMIT)
+    {
+        int descriptor = openat(parent, name_p, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if(descriptor >= 0)
+        {
+            return descriptor;
+        }
+    }
+    __atomic_sub_fetch(&walker_p->open_count, 1, __ATOMIC_ACQ_REL);
+    return -1;
+}
+
+/*
+ * returns 1 if a link leads to the folder being read or to one of its parents.
+ */
+static int walker_is_loop(const WalkIdentity_t* parents_p, size_t depth, const struct stat* target_p)
+{
+    for(size_t parent = 0; parent < depth; ++parent)
+    {
+        if(parents_p[parent].device == target_p->st_dev && parents_p[parent].inode == target_p->st_ino)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void walker_read_folder(WalkWorker_t* worker_p, WalkFolder_t* folder_p)
+{
+    Walker_t* walker_p = worker_p->walker_p;
+    int descriptor = folder_p->descriptor;
+    if(descriptor >= 0)
+    {
+        __atomic_sub_fetch(&walker_p->open_count, 1, __ATOMIC_ACQ_REL);
+    }
+    else
+    {
+        descriptor = open(folder_p->path_p, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+    if(descriptor < 0)
+    {
+        ++worker_p->error_count;
+        return;
+    }
+    ++worker_p->folder_count;
+    //les parents de ses sous-dossiers: les siens, puis lui-même.
+    size_t depth = folder_p->depth + 1;
+    WalkIdentity_t* parents_p = malloc(depth * sizeof(WalkIdentity_t));
+    if(folder_p->depth > 0)
+    {
+        memcpy(parents_p, folder_p->parents_p, folder_p->depth * sizeof(WalkIdentity_t));
+    }
+    struct stat folder_stat;
+    if(fstat(descriptor, &folder_stat) == 0)
+    {
+        parents_p[depth - 1].device = folder_stat.st_dev;
+        parents_p[depth - 1].inode = folder_stat.st_ino;
+    }
+    else
+    {
+        memset(parents_p + depth - 1, 0, sizeof(WalkIdentity_t));
+    }
+    uint8_t buffer[WALKER_BUFFER_SIZE] __attribute__((aligned(8)));
+    long length;
+    while((length = syscall(SYS_getdents64, descriptor, buffer, sizeof(buffer))) > 0)
+    {
+        for(long position = 0; position < length; position += ((WalkEntry_t*) (buffer + position))->length)
+        {
+            const WalkEntry_t* entry_p = (const WalkEntry_t*) (buffer + position);
+            if(entry_p->name[0] == '.')
+            {
+                continue;
+            }
+            unsigned char type = entry_p->type;
+            if(type == DT_UNKNOWN || type == DT_LNK)
+            {
+                //un lien est suivi jusqu'à sa cible; cassé ou en boucle, il est ignoré.
+                struct stat path_stat;
+                if(fstatat(descriptor, entry_p->name, &path_stat, 0) != 0
+                || (S_ISDIR(path_stat.st_mode) && walker_is_loop(parents_p, depth, &path_stat)))
+                {
+                    continue;
+                }
+                type = S_ISDIR(path_stat.st_mode) ? DT_DIR : S_ISREG(path_stat.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+            if(type != DT_DIR && (type != DT_REG || !walker_accepts(walker_p, entry_p->name)))
+            {
+                continue;
+            }
+            PathBuilder_t path;
+            path_init(&path, folder_p->path_p);
+            path_append(&path, "/");
+            path_append(&path, entry_p->name);
+            const char* path_p = path_get(&path);
+            if(path_p == NULL)
+            {
+                continue;
+            }
+            if(type == DT_DIR)
+            {
+                WalkIdentity_t* child_parents_p = malloc(depth * sizeof(WalkIdentity_t));
+                memcpy(child_parents_p, parents_p, depth * sizeof(WalkIdentity_t));
+                walker_add_folder(worker_p,
+                                  strdup(path_p),
+                                  walker_open_child(walker_p, descriptor, entry_p->name),
+                                  child_parents_p,
+                                  depth);
+            }
+            else
+            {
+                walker_add_file(worker_p, path_p);
+            }
+        }
+    }
+    if(length < 0)
+    {
+        ++worker_p->error_count;
+    }
+    free(parents_p);
+    close(descriptor);
+}
+
+/*
+ * takes a folder from the other threads, starting with the next one.
+ */
+static int walker_steal(WalkWorker_t* worker_p, WalkFolder_t* folder_p)
+{
+    Walker_t* walker_p = worker_p->walker_p;
+    for(size_t victim = 1; victim < walker_p->worker_count; ++victim)
+    {
+        WalkWorker_t* victim_p = walker_p->workers_p + (worker_p->index + victim) % walker_p->worker_count;
+        if(walker_deque_steal(&victim_p->deque, folder_p))
+        {
+            ++worker_p->steal_count;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void* walker_thread(void* argument_p)
+{
+    WalkWorker_t* worker_p = argument_p;
+    Walker_t* walker_p = worker_p->walker_p;
+    WalkFolder_t folder;
+    for(;;)
+    {
+        //lu avant de chercher: un ajout pendant la recherche réveille aussitôt.
+        pthread_mutex_lock(&walker_p->idle_mutex);
+        uint64_t push_count = walker_p->push_count;
+        pthread_mutex_unlock(&walker_p->idle_mutex);
+        if(walker_deque_pop(&worker_p->deque, &folder) || walker_steal(worker_p, &folder))
+        {
+            walker_read_folder(worker_p, &folder);
+            free(folder.path_p);
+            free(folder.parents_p);
+            //ses sous-dossiers sont déjà comptés: le total ne tombe à 0 qu'à la fin.
+            if(__atomic_sub_fetch(&walker_p->pending_count, 1, __ATOMIC_ACQ_REL) == 0)
+            {
+                pthread_mutex_lock(&walker_p->idle_mutex);
+                pthread_cond_broadcast(&walker_p->idle_condition);
+                pthread_mutex_unlock(&walker_p->idle_mutex);
+            }
+            continue;
+        }
+        pthread_mutex_lock(&walker_p->idle_mutex);
+        while(__atomic_load_n(&walker_p->pending_count, __ATOMIC_ACQUIRE) != 0
+           && walker_p->push_count == push_count)
+        {
+            pthread_cond_wait(&walker_p->idle_condition, &walker_p->idle_mutex);
+        }
+        pthread_mutex_unlock(&walker_p->idle_mutex);
+        if(__atomic_load_n(&walker_p->pending_count, __ATOMIC_ACQUIRE) == 0)
+        {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static int walker_compare_paths(const void* left_p, const void* right_p)
+{
+    return strcmp(*(char* const*) left_p, *(char* const*) right_p);
+}
+
+int walker_walk(Walker_t* walker_p,
+                const char* root_p,
+                size_t thread_count,
+                const char* const* extensions_pp)
+{
+    memset(walker_p, 0, sizeof(Walker_t));
+    walker_p->extensions_pp = extensions_pp;
+    int descriptor = open(root_p, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(descriptor < 0)
+    {
+        return -1;
+    }
+    walker_p->worker_count = thread_count ? thread_count : 1;
+    walker_p->workers_p = calloc(walker_p->worker_count, sizeof(WalkWorker_t));
+    pthread_mutex_init(&walker_p->idle_mutex, NULL);
+    pthread_cond_init(&walker_p->idle_condition, NULL);
+    for(size_t worker = 0; worker < walker_p->worker_count; ++worker)
+    {
+        WalkWorker_t* worker_p = walker_p->workers_p + worker;
+        worker_p->walker_p = walker_p;
+        worker_p->index = worker;
+        pthread_mutex_init(&worker_p->deque.mutex, NULL);
+    }
+    ++walker_p->open_count;
+    walker_add_folder(walker_p->workers_p, strdup(root_p), descriptor, NULL, 0);
+
+    //le fil appelant est le premier marcheur.
+    size_t started_count = 1;
+    for(size_t worker = 1; worker < walker_p->worker_count; ++worker)
+    {
+        WalkWorker_t* worker_p = walker_p->workers_p + worker;
+        if(pthread_create(&worker_p->thread, NULL, walker_thread, worker_p) != 0)
+        {
+            break;
+        }
+        ++started_count;
+    }
+    walker_thread(walker_p->workers_p);
+
+    size_t path_count = 0;
+    for(size_t worker = 0; worker < walker_p->worker_count; ++worker)
+    {
+        WalkWorker_t* worker_p = walker_p->workers_p + worker;
+        if(worker > 0 && worker < started_count)
+        {
+            pthread_join(worker_p->thread, NULL);
+        }
+        path_count += worker_p->path_count;
+    }
+    //fusion puis tri: le résultat ne dépend pas du partage entre les fils.
+    walker_p->paths_pp = malloc((path_count + 1) * sizeof(char*));
+    for(size_t worker = 0; worker < walker_p->worker_count; ++worker)
+    {
+        WalkWorker_t* worker_p = walker_p->workers_p + worker;
+        if(worker_p->path_count > 0)
+        {
+            memcpy(walker_p->paths_pp + walker_p->path_count, worker_p->paths_pp, worker_p->path_count * sizeof(char*));
+            walker_p->path_count += worker_p->path_count;
+        }
+        walker_p->folder_count += worker_p->folder_count;
+        walker_p->steal_count += worker_p->steal_count;
+        walker_p->error_count += worker_p->error_count;
+        free(worker_p->paths_pp);
+        free(worker_p->deque.folders_p);
+        pthread_mutex_destroy(&worker_p->deque.mutex);
+    }
+    free(walker_p->workers_p);
+    walker_p->workers_p = NULL;
+    pthread_cond_destroy(&walker_p->idle_condition);
+    pthread_mutex_destroy(&walker_p->idle_mutex);
+    qsort(walker_p->paths_pp, walker_p->path_count, sizeof(char*), walker_compare_paths);
+    return 0;
+}
+
+void walker_free(Walker_t* walker_p)
+{
+    for(size_t path = 0; path < walker_p->path_count; ++path)
+    {
+        free(walker_p->paths_pp[path]);
+    }
+    free(walker_p->paths_pp);
+    walker_p->paths_pp = NULL;
+    walker_p->path_count = 0;
+}
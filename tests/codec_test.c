@@ -0,0 +1,883 @@
+/*
+ * codec_test.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: moliver
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dx7.h"
+#include "generator.h"
+#include "midi.h"
+#include "scaling.h"
+#include "smf.h"
+#include "tuning.h"
+
+#define CODEC_TEST_BANK_COUNT 64U
+#define CODEC_TEST_SEED       0xD7D7D7D7U
+
+/*
+ * l'ancien format VMEM, placé par les champs de bits du compilateur (gcc,
+ * bits de poids faible d'abord), gardé comme référence du schéma.
+ */
+typedef struct LegacyPackedOperator_t
+{
+    uint8_t eg_rate_1;
+    uint8_t eg_rate_2;
+    uint8_t eg_rate_3;
+    uint8_t eg_rate_4;
+    uint8_t eg_level_1;
+    uint8_t eg_level_2;
+    uint8_t eg_level_3;
+    uint8_t eg_level_4;
+    uint8_t break_point;
+    uint8_t left_depth;
+    uint8_t right_depth;
+    uint8_t left_curve             : 2;
+    uint8_t right_curve            : 2;
+    uint8_t                        : 4;
+
+    uint8_t rate_scaling           : 3;
+    uint8_t detune                 : 4;
+    uint8_t                        : 1;
+
+    uint8_t modulation_sensitivity : 2;
+    uint8_t touch_sensitivity      : 3;
+    uint8_t                        : 3;
+    uint8_t total_level;
+    uint8_t frequency_mode         : 1;
+    uint8_t frequency_coarse       : 5;
+    uint8_t                        : 2;
+
+    uint8_t frequency_fine;
+} LegacyPackedOperator_t;
+
+typedef struct LegacyPackedVoice_t
+{
+    LegacyPackedOperator_t Operator[OPERATOR_COUNT];
+    uint8_t peg_rate_1;
+    uint8_t peg_rate_2;
+    uint8_t peg_rate_3;
+    uint8_t peg_rate_4;
+    uint8_t peg_level_1;
+    uint8_t peg_level_2;
+    uint8_t peg_level_3;
+    uint8_t peg_level_4;
+
+    uint8_t algorithm                        : 5;
+    uint8_t                                  : 3;
+
+    uint8_t feedback_level                   : 3;
+    uint8_t oscillator_phase_init            : 1;
+    uint8_t                                  : 4;
+
+    uint8_t lfo_speed;
+    uint8_t lfo_delay_time;
+    uint8_t pitch_modulation_depth;
+    uint8_t amplitude_modulation_depth;
+
+    uint8_t lfo_key_sync                     : 1;
+    uint8_t lfo_wave                         : 3;
+    uint8_t lfo_pitch_modulation_sensitivity : 3;
+    uint8_t                                  : 1;
+
+    uint8_t transpose;
+    char    voice_name[VOICE_NAME_SIZE];
+} LegacyPackedVoice_t;
+
+_Static_assert(sizeof(LegacyPackedVoice_t) == PACKED_VOICE_SIZE, "legacy VMEM record size");
+
+/*
+ * les anciens en-têtes, lus et écrits tels quels dans le message.
+ */
+typedef struct LegacySysexHeader_t
+{
+    uint8_t id;
+    uint8_t device    : 4;
+    uint8_t substatus : 4;
+} LegacySysexHeader_t;
+
+typedef struct LegacyParameterChangeHeader_t
+{
+    uint8_t group_h   : 2;
+    uint8_t group_g   : 5;
+    uint8_t           : 1;
+    uint8_t parameter;
+} LegacyParameterChangeHeader_t;
+
+_Static_assert(sizeof(LegacySysexHeader_t) == SYSEX_HEADER_SIZE, "legacy SysEx header size");
+_Static_assert(sizeof(LegacyParameterChangeHeader_t) == PARAMETER_HEADER_SIZE, "legacy parameter header size");
+
+#define LEGACY_CONVERT(SOURCE, DESTINATION, FIELD) (DESTINATION).FIELD = (SOURCE).FIELD
+#define LEGACY_CONVERT_OPERATOR(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    LEGACY_CONVERT(*source_p, *destination_p, FIELD);
+#define LEGACY_CONVERT_VOICE(FIELD, PACKED_OFFSET, SHIFT, WIDTH, MINIMUM, MAXIMUM)\
+    LEGACY_CONVERT(*voice_source_p, *voice_destination_p, FIELD);
+
+static LegacyPackedVoice_t legacy_pack(const VoiceParameters_t* voice_p)
+{
+    LegacyPackedVoice_t packed;
+    memset(&packed, 0, sizeof(packed));
+    for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+    {
+        const OperatorParameters_t* source_p = voice_p->Operator + operator;
+        LegacyPackedOperator_t* destination_p = packed.Operator + operator;
+        DX7_OPERATOR_SCHEMA(LEGACY_CONVERT_OPERATOR)
+    }
+    const VoiceParameters_t* voice_source_p = voice_p;
+    LegacyPackedVoice_t* voice_destination_p = &packed;
+    DX7_VOICE_SCHEMA(LEGACY_CONVERT_VOICE)
+    memcpy(packed.voice_name, voice_p->voice_name, VOICE_NAME_SIZE);
+    return packed;
+}
+
+static VoiceParameters_t legacy_unpack(const LegacyPackedVoice_t* packed_p)
+{
+    VoiceParameters_t voice;
+    memset(&voice, 0, sizeof(voice));
+    for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+    {
+        const LegacyPackedOperator_t* source_p = packed_p->Operator + operator;
+        OperatorParameters_t* destination_p = voice.Operator + operator;
+        DX7_OPERATOR_SCHEMA(LEGACY_CONVERT_OPERATOR)
+    }
+    const LegacyPackedVoice_t* voice_source_p = packed_p;
+    VoiceParameters_t* voice_destination_p = &voice;
+    DX7_VOICE_SCHEMA(LEGACY_CONVERT_VOICE)
+    memcpy(voice.voice_name, packed_p->voice_name, VOICE_NAME_SIZE);
+    return voice;
+}
+
+/*
+ * VCED -> VMEM -> VCED, through both codecs.
+ * returns the number of differences.
+ */
+static int codec_compare(const VoiceParameters_t* voice_p, const char* label_p)
+{
+    int error_count = 0;
+    PackedVoiceParameters_t packed = dx7_pack_voice_parameters(*voice_p);
+    LegacyPackedVoice_t legacy_packed = legacy_pack(voice_p);
+    if(memcmp(packed.data, &legacy_packed, PACKED_VOICE_SIZE) != 0)
+    {
+        printf("%s: VMEM bytes differ\n", label_p);
+        ++error_count;
+    }
+    VoiceParameters_t unpacked = dx7_unpack_voice_parameters(packed);
+    VoiceParameters_t decoded = dx7_decode_packed_voice(packed.data);
+    VoiceParameters_t legacy_unpacked = legacy_unpack(&legacy_packed);
+    if(memcmp(&unpacked, &legacy_unpacked, sizeof(VoiceParameters_t)) != 0
+    || memcmp(&decoded, &legacy_unpacked, sizeof(VoiceParameters_t)) != 0)
+    {
+        printf("%s: VCED bytes differ from the legacy codec\n", label_p);
+        ++error_count;
+    }
+    if(memcmp(&unpacked, voice_p, sizeof(VoiceParameters_t)) != 0)
+    {
+        printf("%s: VCED -> VMEM -> VCED is not the identity\n", label_p);
+        ++error_count;
+    }
+    PackedVoiceParameters_t repacked = dx7_pack_voice_parameters(unpacked);
+    if(memcmp(repacked.data, packed.data, PACKED_VOICE_SIZE) != 0)
+    {
+        printf("%s: VMEM -> VCED -> VMEM is not the identity\n", label_p);
+        ++error_count;
+    }
+    return error_count;
+}
+
+/*
+ * every field of the schema at its minimum, then at its maximum.
+ */
+static int codec_compare_edges(const VoiceParameters_t* base_p)
+{
+    int error_count = 0;
+    char label[64];
+    for(int edge = 0; edge < 2; ++edge)
+    {
+        for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+        {
+            for(int field = 0; field < OPERATOR_FIELD_COUNT; ++field)
+            {
+                const SchemaField_t* field_p = OPERATOR_SCHEMA_TABLE + field;
+                VoiceParameters_t voice = *base_p;
+                ((uint8_t*) (voice.Operator + operator))[field_p->offset] = edge ? field_p->maximum : field_p->minimum;
+                snprintf(label, sizeof(label), "operator %d %s %s", operator, field_p->name, edge ? "max" : "min");
+                error_count += codec_compare(&voice, label);
+            }
+        }
+        for(int field = 0; field < VOICE_FIELD_COUNT; ++field)
+        {
+            const SchemaField_t* field_p = VOICE_SCHEMA_TABLE + field;
+            VoiceParameters_t voice = *base_p;
+            ((uint8_t*) &voice)[field_p->offset] = edge ? field_p->maximum : field_p->minimum;
+            snprintf(label, sizeof(label), "%s %s", field_p->name, edge ? "max" : "min");
+            error_count += codec_compare(&voice, label);
+        }
+    }
+    return error_count;
+}
+
+/*
+ * every pair of 7 bit header bytes through both header codecs: decoded
+ * fields, encoded bytes and the round trip.
+ */
+static int codec_compare_headers(void)
+{
+    int error_count = 0;
+    for(uint32_t first = 0; first <= MIDI_DATA_MASK; ++first)
+    {
+        for(uint32_t second = 0; second <= MIDI_DATA_MASK; ++second)
+        {
+            uint8_t bytes[SYSEX_HEADER_SIZE] = {first, second};
+            uint8_t encoded[SYSEX_HEADER_SIZE];
+            LegacySysexHeader_t legacy_sysex;
+            memcpy(&legacy_sysex, bytes, SYSEX_HEADER_SIZE);
+            SysexHeader_t sysex = dx7_decode_sysex_header(bytes);
+            if(sysex.id != legacy_sysex.id
+            || sysex.device != legacy_sysex.device
+            || sysex.substatus != legacy_sysex.substatus
+            || dx7_encode_sysex_header(&sysex, encoded) != SYSEX_HEADER_SIZE
+            || memcmp(encoded, bytes, SYSEX_HEADER_SIZE) != 0)
+            {
+                printf("SysEx header %02x %02x differs from the legacy header\n", first, second);
+                ++error_count;
+            }
+            //l'ancien encodage: les champs rangés dans la structure, puis copiés.
+            LegacySysexHeader_t legacy_sysex_encoded;
+            memset(&legacy_sysex_encoded, 0, sizeof(legacy_sysex_encoded));
+            legacy_sysex_encoded.id = sysex.id;
+            legacy_sysex_encoded.device = sysex.device;
+            legacy_sysex_encoded.substatus = sysex.substatus;
+            if(memcmp(encoded, &legacy_sysex_encoded, SYSEX_HEADER_SIZE) != 0)
+            {
+                printf("SysEx header %02x %02x encodes unlike the legacy header\n", first, second);
+                ++error_count;
+            }
+            LegacyParameterChangeHeader_t legacy_parameter;
+            memcpy(&legacy_parameter, bytes, PARAMETER_HEADER_SIZE);
+            ParameterChangeHeader_t parameter = dx7_decode_parameter_header(bytes);
+            if(parameter.group_h != legacy_parameter.group_h
+            || parameter.group_g != legacy_parameter.group_g
+            || parameter.parameter != legacy_parameter.parameter
+            || dx7_encode_parameter_header(&parameter, encoded) != PARAMETER_HEADER_SIZE
+            || memcmp(encoded, bytes, PARAMETER_HEADER_SIZE) != 0)
+            {
+                printf("parameter header %02x %02x differs from the legacy header\n", first, second);
+                ++error_count;
+            }
+            LegacyParameterChangeHeader_t legacy_encoded;
+            memset(&legacy_encoded, 0, sizeof(legacy_encoded));
+            legacy_encoded.group_h = parameter.group_h;
+            legacy_encoded.group_g = parameter.group_g;
+            legacy_encoded.parameter = parameter.parameter;
+            if(memcmp(encoded, &legacy_encoded, PARAMETER_HEADER_SIZE) != 0)
+            {
+                printf("parameter header %02x %02x encodes unlike the legacy header\n", first, second);
+                ++error_count;
+            }
+        }
+    }
+    return error_count;
+}
+
+typedef struct VlqCase_t
+{
+    uint32_t value;
+    size_t length;
+    uint8_t bytes[SMF_VLQ_MAX_SIZE];
+} VlqCase_t;
+
+//exemples de la norme SMF 1.0.
+static const VlqCase_t VLQ_CASE_TABLE[] =
+{
+    {0x00000000, 1, {0x00}},
+    {0x00000040, 1, {0x40}},
+    {0x0000007F, 1, {0x7F}},
+    {0x00000080, 2, {0x81, 0x00}},
+    {0x00002000, 2, {0xC0, 0x00}},
+    {0x00003FFF, 2, {0xFF, 0x7F}},
+    {0x00004000, 3, {0x81, 0x80, 0x00}},
+    {0x001FFFFF, 3, {0xFF, 0xFF, 0x7F}},
+    {0x00200000, 4, {0x81, 0x80, 0x80, 0x00}},
+    {0x0FFFFFFF, 4, {0xFF, 0xFF, 0xFF, 0x7F}}
+};
+
+#define VLQ_CASE_COUNT (sizeof(VLQ_CASE_TABLE) / sizeof(VlqCase_t))
+
+/*
+ * une piste: note on puis note off en statut courant, tempo, un message
+ * entier, un message en trois paquets, program change en statut courant.
+ */
+static const uint8_t SMF_TEST_FILE[] =
+{
+    'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xF4,
+    'M', 'T', 'r', 'k', 0, 0, 0, 51,
+    0x00, 0x90, 0x3C, 0x40,
+    0x81, 0x00, 0x3C, 0x00,
+    0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+    0x00, 0xF0, 0x04, 0x43, 0x20, 0x00, 0xF7,
+    0x83, 0x60, 0xF0, 0x03, 0x43, 0x00, 0x09,
+    0x10, 0xF7, 0x03, 0x01, 0x02, 0x03,
+    0x81, 0x80, 0x00, 0xF7, 0x02, 0x04, 0xF7,
+    0x00, 0xC0, 0x05,
+    0x00, 0x06,
+    0x00, 0xFF, 0x2F, 0x00
+};
+
+typedef struct SmfCase_t
+{
+    size_t length;
+    uint8_t payload[8];
+    uint64_t tick;
+    size_t offset;
+} SmfCase_t;
+
+static const SmfCase_t SMF_CASE_TABLE[] =
+{
+    {3, {0x43, 0x20, 0x00}, 128, 38},
+    {7, {0x43, 0x00, 0x09, 0x01, 0x02, 0x03, 0x04}, 608, 46}
+};
+
+#define SMF_CASE_COUNT (sizeof(SMF_CASE_TABLE) / sizeof(SmfCase_t))
+
+/*
+ * reads the messages of data_p and compares them with SMF_CASE_TABLE,
+ * ticks included if gap_ticks is 0, spaced by gap_ticks otherwise.
+ */
+static int codec_check_smf_messages(const uint8_t* data_p, size_t length, uint32_t gap_ticks, const char* label_p)
+{
+    int error_count = 0;
+    SmfReader_t reader;
+    if(smf_open(&reader, data_p, length))
+    {
+        printf("%s: not an SMF\n", label_p);
+        return 1;
+    }
+    SmfSysex_t sysex;
+    size_t message = 0;
+    for(; smf_next_sysex(&reader, &sysex); ++message)
+    {
+        if(message >= SMF_CASE_COUNT)
+        {
+            ++message;
+            break;
+        }
+        const SmfCase_t* case_p = SMF_CASE_TABLE + message;
+        uint64_t tick = gap_ticks ? message * gap_ticks : case_p->tick;
+        if(sysex.length != case_p->length
+        || memcmp(sysex.payload_p, case_p->payload, case_p->length) != 0
+        || !sysex.terminated
+        || sysex.track != 1
+        || sysex.tick != tick
+        || (gap_ticks == 0 && sysex.offset != case_p->offset))
+        {
+            printf("%s: message %zu differs\n", label_p, message);
+            ++error_count;
+            break;
+        }
+    }
+    if(message != SMF_CASE_COUNT)
+    {
+        printf("%s: %zu messages, %zu expected\n", label_p, message, SMF_CASE_COUNT);
+        ++error_count;
+    }
+    smf_close(&reader);
+    return error_count;
+}
+
+/*
+ * VLQ of the SMF standard both ways, a hand-built .mid, then the same
+ * messages written by smf_write_sysex and read back.
+ */
+static int codec_check_smf(void)
+{
+    int error_count = 0;
+    for(size_t index = 0; index < VLQ_CASE_COUNT; ++index)
+    {
+        const VlqCase_t* case_p = VLQ_CASE_TABLE + index;
+        uint8_t bytes[SMF_VLQ_MAX_SIZE];
+        uint32_t value = 0;
+        if(smf_write_vlq(case_p->value, bytes) != case_p->length
+        || memcmp(bytes, case_p->bytes, case_p->length) != 0
+        || smf_read_vlq(case_p->bytes, case_p->length, &value) != case_p->length
+        || value != case_p->value
+        || (case_p->length > 1 && smf_read_vlq(case_p->bytes, case_p->length - 1, &value) != 0))
+        {
+            printf("VLQ %#x differs\n", case_p->value);
+            ++error_count;
+        }
+    }
+    const uint8_t too_long[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x7F};
+    uint32_t value;
+    if(smf_read_vlq(too_long, sizeof(too_long), &value) != 0)
+    {
+        printf("VLQ of 5 bytes read\n");
+        ++error_count;
+    }
+    error_count += codec_check_smf_messages(SMF_TEST_FILE, sizeof(SMF_TEST_FILE), 0, "hand-built SMF");
+
+    FILE* file_p = tmpfile();
+    SmfWriter_t writer;
+    int result = (file_p == NULL) || smf_writer_open(&writer, file_p, 100);
+    for(size_t message = 0; message < SMF_CASE_COUNT && result == 0; ++message)
+    {
+        const SmfCase_t* case_p = SMF_CASE_TABLE + message;
+        uint8_t bytes[sizeof(case_p->payload) + 2] = {MIDI_SYSTEM_EXCLUSIVE};
+        memcpy(bytes + 1, case_p->payload, case_p->length);
+        bytes[case_p->length + 1] = MIDI_EOX;
+        result = smf_write_sysex(&writer, bytes, case_p->length + 2);
+    }
+    uint8_t written[256];
+    size_t length = 0;
+    if(result == 0 && smf_writer_close(&writer) == 0)
+    {
+        rewind(file_p);
+        length = fread(written, 1, sizeof(written), file_p);
+    }
+    if(file_p != NULL)
+    {
+        fclose(file_p);
+    }
+    if(length == 0)
+    {
+        printf("SMF round trip: not written\n");
+        return error_count + 1;
+    }
+    return error_count + codec_check_smf_messages(written, length, writer.gap_ticks, "SMF round trip");
+}
+
+typedef struct TuningCase_t
+{
+    uint8_t note;
+    MicroTuningParameter_t parameter;  //[grossier][fin]
+    uint32_t pitch;
+    double frequency;
+    int invalid_count;
+} TuningCase_t;
+
+//fréquences au tempérament égal depuis la note 0, La 440 Hz.
+static const TuningCase_t TUNING_CASE_TABLE[] =
+{
+    {  0, {  0,   0},      0,     8.1758, 0},
+    { 60, { 60,   0},  61440,   261.6256, 0},
+    { 69, { 69,   0},  70656,   440.0000, 0},
+    { 69, { 69,  85},  71676,   466.0586, 0},
+    { 64, { 64,  43},  66052,   339.3629, 0},
+    {127, {127,  85}, 131068, 13286.7520, 0},
+    { 69, { 69, 100},  71676,   466.0586, 1}   //fin ramené à 85
+};
+
+#define TUNING_CASE_COUNT (sizeof(TUNING_CASE_TABLE) / sizeof(TuningCase_t))
+#define TUNING_FREQUENCY_TOLERANCE 1e-4    //relative
+
+/*
+ * compares the pitches of two tables, returns 0 if they are equal.
+ */
+static int codec_compare_tunings(const TuningTable_t* left_p, const TuningTable_t* right_p, const char* label_p)
+{
+    for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+    {
+        if(left_p->pitch[note] != right_p->pitch[note])
+        {
+            printf("%s: note %d at %u, %u expected\n", label_p, note, left_p->pitch[note], right_p->pitch[note]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * MCRY pairs of known pitch and frequency, every pair through
+ * tuning_encode and back, a MCRY dump and the .tun and .scl files.
+ */
+static int codec_check_tuning(void)
+{
+    int error_count = 0;
+    MicroTuningParameters_t parameters;
+    TuningTable_t table;
+    for(size_t index = 0; index < TUNING_CASE_COUNT; ++index)
+    {
+        const TuningCase_t* case_p = TUNING_CASE_TABLE + index;
+        memset(parameters, 0, sizeof(parameters));
+        parameters[case_p->note] = case_p->parameter;
+        int invalid_count = tuning_decode(parameters, &table);
+        double frequency = table.frequency[case_p->note];
+        if(invalid_count != case_p->invalid_count
+        || table.pitch[case_p->note] != case_p->pitch
+        || fabs(frequency - case_p->frequency) > TUNING_FREQUENCY_TOLERANCE * case_p->frequency)
+        {
+            printf("MCRY note %u %u/%u: pitch %u, %.4f Hz, %d invalid\n",
+                   case_p->note,
+                   case_p->parameter.msb,
+                   case_p->parameter.lsb,
+                   table.pitch[case_p->note],
+                   frequency,
+                   invalid_count);
+            ++error_count;
+        }
+    }
+    //chaque note grossière à chaque pas fin, la note 0 juste.
+    MicroTuningParameters_t encoded;
+    for(uint8_t fine = 0; fine <= TUNING_FINE_MAXIMUM; ++fine)
+    {
+        for(int note = 0; note < MIDI_NOTE_COUNT; ++note)
+        {
+            parameters[note].msb = note;
+            parameters[note].lsb = (note == 0) ? 0 : fine;
+        }
+        tuning_decode(parameters, &table);
+        tuning_encode(&table, encoded);
+        if(memcmp(encoded, parameters, sizeof(parameters)) != 0)
+        {
+            printf("MCRY fine %u: encode(decode) differs\n", fine);
+            ++error_count;
+        }
+    }
+    //la dernière table: notes décalées d'un pas fin variable.
+    size_t length;
+    uint8_t* payload_p = tuning_format_sysex(&table, 1, 0, &length);
+    SysExData_t* sysex_p = (payload_p != NULL) ? dx7_get_sysex(payload_p, length) : NULL;
+    TuningTable_t decoded;
+    if(sysex_p == NULL
+    || sysex_p->type != SYSEX_TYPE_BULK
+    || sysex_p->bulk_data.type != BULK_DATA_UNIVERSAL_BULK_DUMP
+    || tuning_decode_universal(&sysex_p->bulk_data.universal, &decoded) != 1)
+    {
+        printf("MCRY dump: not decoded\n");
+        ++error_count;
+    }
+    else
+    {
+        error_count += codec_compare_tunings(&decoded, &table, "MCRY dump");
+    }
+    dx7_free_sysex(sysex_p);
+    free(payload_p);
+    for(int format = 0; format < TUNING_FILE_COUNT; ++format)
+    {
+        FILE* file_p = tmpfile();
+        if(file_p == NULL)
+        {
+            printf("%s file: not written\n", TUNING_FILE_EXTENSION_TABLE[format]);
+            ++error_count;
+            continue;
+        }
+        tuning_write_file(file_p, &table, format, "codec test");
+        rewind(file_p);
+        if(tuning_read_file(file_p, &decoded, format))
+        {
+            printf("%s file: not read\n", TUNING_FILE_EXTENSION_TABLE[format]);
+            ++error_count;
+        }
+        else
+        {
+            error_count += codec_compare_tunings(&decoded, &table, TUNING_FILE_EXTENSION_TABLE[format]);
+        }
+        fclose(file_p);
+    }
+    return error_count;
+}
+
+typedef struct ScalingValueCase_t
+{
+    FractionalScalingParameter_t parameter;    //[poids fort][poids faible]
+    float value;
+} ScalingValueCase_t;
+
+//complément à deux sur 14 bits.
+static const ScalingValueCase_t SCALING_VALUE_CASE_TABLE[] =
+{
+    {{0x00, 0x00},     0},
+    {{0x00, 0x01},     1},
+    {{0x01, 0x00},   128},
+    {{0x3F, 0x7F},  8191},
+    {{0x40, 0x00}, -8192},
+    {{0x7F, 0x7F},    -1},
+    {{0x7E, 0x00},  -256}
+};
+
+#define SCALING_VALUE_CASE_COUNT (sizeof(SCALING_VALUE_CASE_TABLE) / sizeof(ScalingValueCase_t))
+
+typedef struct ScalingNoteCase_t
+{
+    uint8_t note;
+    float first;       //opérateur 6: 10 + 30 par point.
+    float last;        //opérateur 1: -100 - 6 par point.
+} ScalingNoteCase_t;
+
+//un point toutes les 3 notes depuis la note 5, le dernier à la note 122.
+static const ScalingNoteCase_t SCALING_NOTE_CASE_TABLE[] =
+{
+    {  0,   10, -100},
+    {  5,   10, -100},
+    {  6,   20, -102},
+    {  7,   30, -104},
+    {  8,   40, -106},
+    { 64,  600, -218},
+    {121, 1170, -332},
+    {122, 1180, -334},
+    {127, 1180, -334}
+};
+
+#define SCALING_NOTE_CASE_COUNT (sizeof(SCALING_NOTE_CASE_TABLE) / sizeof(ScalingNoteCase_t))
+#define SCALING_TOLERANCE 1e-3f
+
+static TwoByte_t codec_encode_scaling(int value)
+{
+    uint32_t raw = (uint32_t) value & 0x3FFF;
+    TwoByte_t parameter = {raw >> MIDI_DATA_BITS, raw & MIDI_DATA_MASK};
+    return parameter;
+}
+
+/*
+ * FKSY values of known sign, then the curves of two operators with known
+ * breakpoints, on and between them.
+ */
+static int codec_check_scaling(void)
+{
+    int error_count = 0;
+    FractionalScalingParameters_t parameters;
+    ScalingTable_t table;
+    for(size_t index = 0; index < SCALING_VALUE_CASE_COUNT; ++index)
+    {
+        const ScalingValueCase_t* case_p = SCALING_VALUE_CASE_TABLE + index;
+        memset(parameters, 0, sizeof(parameters));
+        for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+        {
+            parameters[operator].offset = case_p->parameter;
+            parameters[operator].level[index] = case_p->parameter;
+        }
+        scaling_decode(parameters, &table);
+        for(int operator = 0; operator < OPERATOR_COUNT; ++operator)
+        {
+            if(table.offset[operator] != case_p->value || table.level[index][operator] != case_p->value)
+            {
+                printf("FKSY %02x %02x: %.0f, %.0f expected\n",
+                       case_p->parameter.msb,
+                       case_p->parameter.lsb,
+                       table.offset[operator],
+                       case_p->value);
+                ++error_count;
+                break;
+            }
+        }
+    }
+    memset(parameters, 0, sizeof(parameters));
+    parameters[OPERATOR_6].offset = codec_encode_scaling(10);
+    parameters[OPERATOR_1].offset = codec_encode_scaling(-100);
+    for(int level = 0; level < FRACTIONAL_SCALING_COUNT; ++level)
+    {
+        parameters[OPERATOR_6].level[level] = codec_encode_scaling(30 * level);
+        parameters[OPERATOR_1].level[level] = codec_encode_scaling(-6 * level);
+    }
+    UniversalBulkDataPayload_t universal;
+    universal.type = UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER;
+    universal.fractional_scaling_parameters_p = &parameters;
+    if(scaling_decode_universal(&universal, &table) != 1)
+    {
+        printf("FKSY edit buffer: not decoded\n");
+        return error_count + 1;
+    }
+    ScalingCurve_t curve;
+    scaling_evaluate(&table, 1, &curve);
+    for(size_t index = 0; index < SCALING_NOTE_CASE_COUNT; ++index)
+    {
+        const ScalingNoteCase_t* case_p = SCALING_NOTE_CASE_TABLE + index;
+        const ScalingVector_t* note_p = curve.note + case_p->note;
+        int others = 0;
+        for(int operator = OPERATOR_5; operator < SCALING_LANE_COUNT; ++operator)
+        {
+            others |= (operator != OPERATOR_1 && (*note_p)[operator] != 0.0f);
+        }
+        if(fabsf((*note_p)[OPERATOR_6] - case_p->first) > SCALING_TOLERANCE
+        || fabsf((*note_p)[OPERATOR_1] - case_p->last) > SCALING_TOLERANCE
+        || others)
+        {
+            printf("scaling note %u: %.3f %.3f, %.3f %.3f expected\n",
+                   case_p->note,
+                   (*note_p)[OPERATOR_6],
+                   (*note_p)[OPERATOR_1],
+                   case_p->first,
+                   case_p->last);
+            ++error_count;
+        }
+    }
+    return error_count;
+}
+
+/*
+ * longueurs attendues entre F0 et F7, d'après la documentation du DX7II.
+ */
+typedef struct ClassifierCase_t
+{
+    BulkData_t format;
+    UniversalBulkData_t universal;
+    size_t dump_length;
+    size_t request_length;
+} ClassifierCase_t;
+
+static const ClassifierCase_t CLASSIFIER_CASE_TABLE[] =
+{
+    {BULK_DATA_VOICE_EDIT_BUFFER,      UNIVERSAL_BULK_DATA_ERROR,                          161,  3},
+    {BULK_DATA_SUPPLEMENT_EDIT_BUFFER, UNIVERSAL_BULK_DATA_ERROR,                           55,  3},
+    {BULK_DATA_PACKED_32_SUPPLEMENT,   UNIVERSAL_BULK_DATA_ERROR,                         1126,  3},
+    {BULK_DATA_PACKED_32_VOICE,        UNIVERSAL_BULK_DATA_ERROR,                         4102,  3},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PERFORMANCE_EDIT_BUFFER,         67, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_PACKED_32_PERFORMANCE,         1648, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_SYSTEM_SET_UP,                  118, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_EDIT_BUFFER,       272, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_0,          272, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_MEMORY_1,          272, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_MICRO_TUNING_CARTRIDGE,       17219, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_EDIT_BUFFER, 508, 13},
+    {BULK_DATA_UNIVERSAL_BULK_DUMP,    UNIVERSAL_BULK_DATA_FRACTIONAL_SCALING_CARTRIDGE, 16163, 13}
+};
+
+#define CLASSIFIER_CASE_COUNT (sizeof(CLASSIFIER_CASE_TABLE) / sizeof(ClassifierCase_t))
+
+/*
+ * every universal tag through the hash table, then the class of a dump and
+ * of a request of every format, from their headers alone.
+ */
+static int codec_check_classifier(void)
+{
+    int error_count = 0;
+    UniversalBulkDataHeader_t header;
+    memcpy(header.classification, UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME, UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
+    for(int type = 0; type < UNIVERSAL_BULK_DATA_COUNT; ++type)
+    {
+        memcpy(header.format, UNIVERSAL_BULK_DATA_FORMAT_TABLE[type], UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+        if(dx7_get_universal_bulk_data_header(&header) != (UniversalBulkData_t) type)
+        {
+            printf("universal tag %.6s: type %d, %d expected\n",
+                   UNIVERSAL_BULK_DATA_FORMAT_TABLE[type],
+                   dx7_get_universal_bulk_data_header(&header),
+                   type);
+            ++error_count;
+        }
+        //une étiquette voisine, en minuscule, tombe peut-être dans la même case: elle reste inconnue.
+        header.format[0] ^= 0x20;
+        if(dx7_get_universal_bulk_data_header(&header) != UNIVERSAL_BULK_DATA_ERROR)
+        {
+            printf("universal tag %.6s: known\n", header.format);
+            ++error_count;
+        }
+    }
+    for(size_t index = 0; index < CLASSIFIER_CASE_COUNT; ++index)
+    {
+        const ClassifierCase_t* case_p = CLASSIFIER_CASE_TABLE + index;
+        for(int type = SYSEX_TYPE_BULK; type < SYSEX_TYPE_COUNT; type += SYSEX_TYPE_DUMP_REQUEST)
+        {
+            //[43][sous-statut, appareil][format]([compte])[LM  xxxxxx]
+            uint8_t payload[SYSEX_HEADER_SIZE + BULK_HEADER_SIZE + sizeof(TwoByte_t) + sizeof(UniversalBulkDataHeader_t)];
+            memset(payload, 0, sizeof(payload));
+            SysexHeader_t sysex_header = SYSEX_HEADER_INITIALISER_YAMAHA;
+            sysex_header.substatus = type;
+            sysex_header.device = 5;
+            size_t length = dx7_encode_sysex_header(&sysex_header, payload);
+            payload[length++] = BULK_DATA_FORMAT_TABLE[case_p->format];
+            if(type == SYSEX_TYPE_BULK)
+            {
+                length += sizeof(TwoByte_t);
+            }
+            if(case_p->format == BULK_DATA_UNIVERSAL_BULK_DUMP)
+            {
+                memcpy(payload + length, UNIVERSAL_BULK_DATA_CLASSIFICATION_NAME, UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE);
+                memcpy(payload + length + UNIVERSAL_BULK_DATA_CLASSIFICATION_SIZE,
+                       UNIVERSAL_BULK_DATA_FORMAT_TABLE[case_p->universal],
+                       UNIVERSAL_BULK_DATA_FORMAT_SIZE);
+                length += sizeof(UniversalBulkDataHeader_t);
+            }
+            SysexClass_t sysex_class = dx7_classify_sysex(payload, length);
+            size_t expected_length = (type == SYSEX_TYPE_BULK) ? case_p->dump_length : case_p->request_length;
+            if(sysex_class.type != (SysexType_t) type
+            || sysex_class.device != 5
+            || sysex_class.format != case_p->format
+            || sysex_class.universal != case_p->universal
+            || sysex_class.expected_length != expected_length)
+            {
+                printf("%s %s: class %d %d %d, expected length %zu, %zu expected\n",
+                       SYSEX_TYPE_NAME_TABLE[type],
+                       (case_p->format == BULK_DATA_UNIVERSAL_BULK_DUMP) ? UNIVERSAL_BULK_DATA_FORMAT_TABLE[case_p->universal]
+                                                                          : BULK_DATA_FORMAT_NAME_TABLE[case_p->format],
+                       sysex_class.type,
+                       sysex_class.format,
+                       sysex_class.universal,
+                       sysex_class.expected_length,
+                       expected_length);
+                ++error_count;
+            }
+        }
+    }
+    return error_count;
+}
+
+/*
+ * random VMEM bytes through the packed validator and through the VCED one
+ * on their decoding: same reports, same repaired voices, for every mode.
+ */
+static int codec_check_validation(GeneratorRandom_t* random_p)
+{
+    int error_count = 0;
+    for(uint32_t index = 0; index < CODEC_TEST_BANK_COUNT * VOICE_COUNT; ++index)
+    {
+        PackedVoiceParameters_t original;
+        for(int byte = 0; byte < PACKED_VOICE_SIZE; ++byte)
+        {
+            original.data[byte] = generator_next(random_p) & MIDI_DATA_MASK;
+        }
+        for(ValidationMode_t mode = VALIDATION_CHECK; mode < VALIDATION_MODE_COUNT; ++mode)
+        {
+            PackedVoiceParameters_t packed = original;
+            VoiceParameters_t voice = dx7_decode_packed_voice(original.data);
+            ValidationReport_t packed_report = VALIDATION_REPORT_INITIALISER;
+            ValidationReport_t voice_report = VALIDATION_REPORT_INITIALISER;
+            dx7_validate_packed_voices(&packed, 1, mode, &packed_report);
+            dx7_validate_voices(&voice, 1, mode, &voice_report);
+            VoiceParameters_t repaired = dx7_decode_packed_voice(packed.data);
+            if(memcmp(&packed_report, &voice_report, sizeof(ValidationReport_t)) != 0
+            || memcmp(&repaired, &voice, sizeof(VoiceParameters_t)) != 0)
+            {
+                printf("voice %u: %s differs between VMEM and VCED validation\n",
+                       index,
+                       VALIDATION_MODE_NAME_TABLE[mode]);
+                ++error_count;
+            }
+        }
+    }
+    return error_count;
+}
+
+int main(void)
+{
+    GeneratorRandom_t random;
+    generator_seed(&random, CODEC_TEST_SEED, 0);
+    int error_count = 0;
+    char label[64];
+    VoiceParameters_t voice;
+    for(uint32_t bank = 0; bank < CODEC_TEST_BANK_COUNT; ++bank)
+    {
+        for(uint32_t index = 0; index < VOICE_COUNT; ++index)
+        {
+            generator_random_voice(&random, &voice);
+            generator_name_voice(&voice, bank * VOICE_COUNT + index);
+            snprintf(label, sizeof(label), "bank %u voice %u", bank, index);
+            error_count += codec_compare(&voice, label);
+        }
+        error_count += codec_compare_edges(&voice);
+    }
+    error_count += codec_compare_headers();
+    error_count += codec_check_classifier();
+    error_count += codec_check_smf();
+    error_count += codec_check_tuning();
+    error_count += codec_check_scaling();
+    error_count += codec_check_validation(&random);
+    printf("codec: %u banks, %zu formats, %d differences\n",
+           CODEC_TEST_BANK_COUNT,
+           CLASSIFIER_CASE_COUNT,
+           error_count);
+    return error_count ? EXIT_FAILURE : EXIT_SUCCESS;
+}
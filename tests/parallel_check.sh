@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# parallel_check.sh
+#
+#  Created on: 19 oct. 2026
+#      Author: moliver
+#
+# decodes the same input sequentially and with -j 2 and -j 4, with and
+# without recovery: the logs and the unpacked trees must be identical.
+# walks a folder through links to a bank and to a folder, and through a link
+# looping to the folder itself, with 1, 2 and 4 threads.
+# usage: parallel_check.sh <olidx>
+
+PROGRAM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+WORK=$(mktemp -d)
+trap 'rm -fr "$WORK"' EXIT
+
+"$PROGRAM" generate -n 320 -s 3 -u "$WORK/" > /dev/null || exit 1
+# un F0 isolé en tête et un message vide au milieu ne doivent pas arrêter la lecture.
+{
+    printf '\360'
+    head -c 20520 "$WORK/generated_000.syx"
+    printf '\360\367'
+    tail -c +20521 "$WORK/generated_000.syx"
+} > "$WORK/input.syx"
+
+status=0
+for recover in "" "-s"; do
+    for threads in "" "-j 2" "-j 4"; do
+        run="$WORK/run${recover}${threads}"
+        run=$(echo "$run" | tr -d ' ')
+        mkdir -p "$run"
+        (cd "$run" && "$PROGRAM" -f ../input.syx -u out $recover $threads > log.txt) || status=1
+        reference="$WORK/run${recover}"
+        if [ "$run" != "$reference" ] && ! diff -r "$reference" "$run" > /dev/null; then
+            echo "parallel: '$recover $threads' differs from the sequential decoding"
+            status=1
+        fi
+    done
+done
+count=$(grep -c "^Payload no" "$WORK/run/log.txt")
+if [ "$count" -ne 10 ]; then
+    echo "parallel: $count messages decoded, 10 expected"
+    status=1
+fi
+# une banque réelle, puis la même par un lien de fichier et par un lien de dossier;
+# la boucle vers un parent et le lien cassé sont ignorés.
+mkdir -p "$WORK/walk/banks/sub" "$WORK/outside"
+cp "$WORK/generated_000.syx" "$WORK/outside/bank.syx"
+head -c 4104 "$WORK/generated_000.syx" > "$WORK/walk/banks/sub/first.syx"
+ln -s ../outside/bank.syx "$WORK/walk/linked.syx"
+ln -s ../outside "$WORK/walk/linked"
+ln -s .. "$WORK/walk/banks/sub/loop"
+ln -s missing.syx "$WORK/walk/broken.syx"
+for threads in "" "-j 2" "-j 4"; do
+    run="$WORK/links$(echo "$threads" | tr -d ' ')"
+    mkdir -p "$run"
+    (cd "$run" && "$PROGRAM" -f ../walk -u out $threads > log.txt) || status=1
+    if ! grep -q "^name index: 672 voices" "$run/log.txt"; then
+        echo "parallel: '$threads' walk through links: $(grep "^name index" "$run/log.txt"), 672 voices expected"
+        status=1
+    fi
+    if [ "$run" != "$WORK/links" ] && ! diff -r "$WORK/links/out" "$run/out" > /dev/null; then
+        echo "parallel: '$threads' walk through links differs from the sequential one"
+        status=1
+    fi
+done
+echo "parallel: sequential, -j 2 and -j 4 compared, $count messages, folder walked through links"
+exit $status
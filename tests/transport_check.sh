@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# transport_check.sh
+#
+#  Created on: 19 oct. 2026
+#      Author: moliver
+#
+# backs up a simulated DX7II-FD through FIFOs, then sends a bank through a
+# FIFO: the replies must unpack to the loaded bank, and the paced transfers
+# must not be faster than their rate.
+# usage: transport_check.sh <olidx>
+
+PROGRAM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+WORK=$(mktemp -d)
+trap 'rm -fr "$WORK"' EXIT
+REPLY_RATE=32
+SEND_RATE=8
+
+now_ms()
+{
+    echo $(( $(date +%s%N) / 1000000 ))
+}
+
+"$PROGRAM" generate -n 32 -s 11 -u "$WORK/" > /dev/null || exit 1
+BANK="$WORK/generated_000.syx"
+BANK_SIZE=$(wc -c < "$BANK")
+mkfifo "$WORK/requests" "$WORK/replies" "$WORK/port"
+
+status=0
+# le simulateur répond sur replies aux requêtes lues dans requests, jusqu'à leur fermeture.
+"$PROGRAM" simulate -f "$BANK" -p "$WORK/replies:$WORK/requests" -g 0 -r $REPLY_RATE > "$WORK/simulate.txt" &
+start=$(now_ms)
+"$PROGRAM" backup -p "$WORK/requests:$WORK/replies" -g 0 -u "$WORK/out/" > "$WORK/backup.txt" || status=1
+elapsed=$(( $(now_ms) - start ))
+wait $! || status=1
+answered=$(sed -n 's/.* requests answered, [0-9]* messages, \([0-9]*\)B$/\1/p' "$WORK/backup.txt")
+if ! grep -q "13/13 requests answered" "$WORK/backup.txt"; then
+    echo "transport: backup not answered: $(grep "requests answered" "$WORK/backup.txt")"
+    status=1
+fi
+if ! cmp -s "$BANK" "$WORK/out/requests_003.syx"; then
+    echo "transport: backed up bank differs from the simulated one"
+    status=1
+fi
+voice_count=$(ls "$WORK/out" | grep -c "^requests_003_0")
+if [ "$voice_count" -ne 32 ] || [ ! -s "$WORK/out/manifest.txt" ]; then
+    echo "transport: $voice_count voices unpacked, 32 expected, with manifest.txt"
+    status=1
+fi
+if [ -z "$answered" ] || [ "$elapsed" -lt $(( answered / REPLY_RATE )) ]; then
+    echo "transport: ${answered}B answered in ${elapsed} ms at $REPLY_RATE B/ms"
+    status=1
+fi
+
+cat "$WORK/port" > "$WORK/sent.syx" &
+start=$(now_ms)
+"$PROGRAM" send -p "$WORK/port" -r $SEND_RATE -c 16 -g 0 "$BANK" > /dev/null || status=1
+elapsed=$(( $(now_ms) - start ))
+wait $! || status=1
+if ! cmp -s "$BANK" "$WORK/sent.syx"; then
+    echo "transport: sent bank differs"
+    status=1
+fi
+if [ "$elapsed" -lt $(( BANK_SIZE / SEND_RATE )) ]; then
+    echo "transport: ${BANK_SIZE}B sent in ${elapsed} ms at $SEND_RATE B/ms"
+    status=1
+fi
+echo "transport: backup of a simulated device and paced send through FIFOs, ${BANK_SIZE}B in ${elapsed} ms"
+exit $status